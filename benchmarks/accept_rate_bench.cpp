@@ -0,0 +1,109 @@
+// 短连接建立速率：baseLoop 单个 Acceptor 转交 IO loop 与每个 IO loop 各自监听（SO_REUSEPORT）对比
+// 用法: accept_rate_bench [IO 线程数] [客户端线程数] [每种模式秒数]，默认 4、4、2
+// 客户端线程不停地 connect、等服务端关闭、close；服务端在连接建立回调里直接 shutdown，
+// 由服务端先关闭，TIME_WAIT 留在服务端，客户端不会耗尽本地端口
+#include "EventLoop.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    struct Mode
+    {
+        const char *name;
+        bool perLoop;
+        bool steer;
+    };
+
+    double run(const Mode &mode, int threads, int clients, double seconds, uint16_t port)
+    {
+        std::atomic<long> closed(0);
+        std::atomic<bool> stop(false);
+        net::EventLoop loop;
+        net::InetAddress listenAddr(port);
+        net::TcpServer server(&loop, listenAddr, "accept", true);
+        server.setThreadNum(threads, mode.steer ? net::ThreadPlacement::compact() : net::ThreadPlacement());
+        server.setAcceptorPerLoop(mode.perLoop, mode.steer);
+        server.setConnectionCallback([&closed](const net::TcpConnectionPtr &conn)
+                                     {
+                                         if (conn->connected())
+                                         {
+                                             conn->shutdown();
+                                         }
+                                         else
+                                         {
+                                             closed.fetch_add(1, std::memory_order_relaxed);
+                                         } });
+        server.start();
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < clients; ++i)
+        {
+            workers.emplace_back([&]()
+                                 {
+                sockaddr_in addr;
+                std::memset(&addr, 0, sizeof(addr));
+                addr.sin_family = AF_INET;
+                addr.sin_port = htons(port);
+                ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+                    timeval timeout = {0, 100 * 1000}; // 结束时 baseLoop 已停止，backlog 中的连接不会再被接受
+                    ::setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                    if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+                    {
+                        char c;
+                        ::recv(sockfd, &c, 1, 0); // 等服务端 shutdown
+                    }
+                    ::close(sockfd);
+                } });
+        }
+
+        long startClosed = 0;
+        loop.runAfter(0.3, [&]()
+                      { startClosed = closed.load(); });
+        loop.runAfter(0.3 + seconds, [&]()
+                      {
+                          startClosed = closed.load() - startClosed;
+                          stop = true;
+                          loop.quit(); });
+        loop.loop();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        std::printf("  %s\n", server.loopStats().toString().c_str());
+        return static_cast<double>(startClosed) / seconds;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int threads = argc > 1 ? std::atoi(argv[1]) : 4;
+    const int clients = argc > 2 ? std::atoi(argv[2]) : 4;
+    const double seconds = argc > 3 ? std::atof(argv[3]) : 2.0;
+
+    const Mode modes[] = {
+        {"single acceptor", false, false},
+        {"acceptor per loop", true, false},
+        {"per loop + cpu bpf", true, true},
+    };
+    uint16_t port = 19500;
+    for (const Mode &mode : modes)
+    {
+        double rate = run(mode, threads, clients, seconds, port++);
+        std::printf("%-20s %10.0f conn/s\n", mode.name, rate);
+    }
+    return 0;
+}
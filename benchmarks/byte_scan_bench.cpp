@@ -0,0 +1,179 @@
+// 分隔符查找：std::search（原 Buffer::findCRLF）与 base::scan 的逐字节 / SSE2 / AVX2 实现对比
+// 用法: byte_scan_bench [消息数] [轮数]，默认 20000、50
+// 语料模拟一条 RTSP 连接上的输入：OPTIONS / DESCRIBE / SETUP / PLAY / GET_PARAMETER 请求，
+// 夹杂 '$' 交织的 RTP/RTCP 帧（载荷是随机字节）。解析器按服务端的方式走一遍：
+// 遇到 '$' 跳过整帧，否则先找头部结束的 CRLFCRLF，再逐行找 CRLF 和 ':'
+#include "ByteScan.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    const char *searchCRLF(const char *begin, const char *end)
+    {
+        return std::search(begin, end, "\r\n", "\r\n" + 2);
+    }
+    const char *searchCRLFCRLF(const char *begin, const char *end)
+    {
+        return std::search(begin, end, "\r\n\r\n", "\r\n\r\n" + 4);
+    }
+    const char *searchAnyOf(const char *begin, const char *end, const char *set, size_t setSize)
+    {
+        return std::find_first_of(begin, end, set, set + setSize);
+    }
+    const base::scan::Ops kSearchOps = {searchCRLF, searchCRLFCRLF, searchAnyOf};
+
+    std::string buildCorpus(size_t messages, size_t *requests)
+    {
+        static const char *const kRequests[] = {
+            "OPTIONS rtsp://192.168.1.20:554/live/camera01 RTSP/1.0\r\n"
+            "CSeq: 2\r\n"
+            "User-Agent: LibVLC/3.0.18 (LIVE555 Streaming Media v2016.11.28)\r\n\r\n",
+            "DESCRIBE rtsp://192.168.1.20:554/live/camera01 RTSP/1.0\r\n"
+            "CSeq: 3\r\n"
+            "User-Agent: LibVLC/3.0.18 (LIVE555 Streaming Media v2016.11.28)\r\n"
+            "Accept: application/sdp\r\n"
+            "Authorization: Digest username=\"admin\", realm=\"IP Camera\", nonce=\"4f2a9c1e7b\", "
+            "uri=\"rtsp://192.168.1.20:554/live/camera01\", response=\"9a0f3c55e2d14b7a8c6e\"\r\n\r\n",
+            "SETUP rtsp://192.168.1.20:554/live/camera01/trackID=0 RTSP/1.0\r\n"
+            "CSeq: 4\r\n"
+            "User-Agent: LibVLC/3.0.18 (LIVE555 Streaming Media v2016.11.28)\r\n"
+            "Transport: RTP/AVP/TCP;unicast;interleaved=0-1\r\n\r\n",
+            "PLAY rtsp://192.168.1.20:554/live/camera01/ RTSP/1.0\r\n"
+            "CSeq: 6\r\n"
+            "User-Agent: LibVLC/3.0.18 (LIVE555 Streaming Media v2016.11.28)\r\n"
+            "Session: 5A3F0C21;timeout=60\r\n"
+            "Range: npt=0.000-\r\n\r\n",
+            "GET_PARAMETER rtsp://192.168.1.20:554/live/camera01/ RTSP/1.0\r\n"
+            "CSeq: 7\r\n"
+            "Session: 5A3F0C21\r\n\r\n",
+        };
+        std::mt19937 rng(554);
+        std::uniform_int_distribution<int> byte(0, 255);
+        std::uniform_int_distribution<size_t> frameSize(60, 1400);
+        std::string corpus;
+        *requests = 0;
+        for (size_t i = 0; i < messages; ++i)
+        {
+            // 大约每 4 条消息一条请求，其余是交织帧
+            if (i % 4 == 0)
+            {
+                corpus += kRequests[(i / 4) % (sizeof(kRequests) / sizeof(kRequests[0]))];
+                ++*requests;
+                continue;
+            }
+            const size_t len = frameSize(rng);
+            corpus += '$';
+            corpus += static_cast<char>(i % 2);
+            corpus += static_cast<char>(len >> 8);
+            corpus += static_cast<char>(len & 0xff);
+            for (size_t j = 0; j < len; ++j)
+            {
+                corpus += static_cast<char>(byte(rng));
+            }
+        }
+        return corpus;
+    }
+
+    // 返回解析出的头部行数，用于校验各实现结果一致
+    size_t parse(const base::scan::Ops &ops, const std::string &corpus)
+    {
+        const char *p = corpus.data();
+        const char *end = p + corpus.size();
+        size_t lines = 0;
+        while (p < end)
+        {
+            if (*p == '$')
+            {
+                const size_t len = (static_cast<size_t>(static_cast<unsigned char>(p[2])) << 8) | static_cast<unsigned char>(p[3]);
+                p += 4 + len;
+                continue;
+            }
+            const char *headerEnd = ops.findCRLFCRLF(p, end);
+            if (headerEnd == end)
+            {
+                break;
+            }
+            const char *line = p;
+            while (line < headerEnd)
+            {
+                const char *eol = ops.findCRLF(line, headerEnd + 2);
+                if (ops.findAnyOf(line, eol, ":", 1) != eol)
+                {
+                    ++lines;
+                }
+                line = eol + 2;
+            }
+            p = headerEnd + 4;
+        }
+        return lines;
+    }
+
+    // 交织流失步后的重同步：在整段输入中逐个定位 '$' 或请求行的 '\r'
+    size_t resync(const base::scan::Ops &ops, const std::string &corpus)
+    {
+        const char *p = corpus.data();
+        const char *end = p + corpus.size();
+        size_t hits = 0;
+        while ((p = ops.findAnyOf(p, end, "$\r", 2)) != end)
+        {
+            ++hits;
+            ++p;
+        }
+        return hits;
+    }
+
+    template <typename Fn>
+    void run(const char *name, const char *isa, size_t rounds, size_t messages, size_t bytes, Fn &&fn)
+    {
+        size_t result = fn(); // 预热
+        auto start = Clock::now();
+        for (size_t i = 0; i < rounds; ++i)
+        {
+            result += fn();
+        }
+        const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        std::printf("%-8s %-12s %10.1f %10.2f %12zu\n", name, isa, ns / static_cast<double>(rounds * messages),
+                    static_cast<double>(rounds * bytes) / ns, result / (rounds + 1));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t messages = static_cast<size_t>(argc > 1 ? std::atoi(argv[1]) : 20000);
+    const size_t rounds = static_cast<size_t>(argc > 2 ? std::atoi(argv[2]) : 50);
+    size_t requests = 0;
+    const std::string corpus = buildCorpus(messages, &requests);
+    std::printf("corpus: %zu messages (%zu requests), %.1f MB, best isa %d\n", messages, requests,
+                static_cast<double>(corpus.size()) / (1024 * 1024), static_cast<int>(base::scan::bestIsa()));
+    std::printf("%-8s %-12s %10s %10s %12s\n", "pass", "impl", "ns/msg", "GB/s", "result");
+
+    struct Impl
+    {
+        const char *name;
+        const base::scan::Ops *ops;
+    };
+    const Impl impls[] = {
+        {"std", &kSearchOps},
+        {"scalar", &base::scan::ops(base::scan::Isa::kScalar)},
+        {"sse2", &base::scan::ops(base::scan::Isa::kSse2)},
+        {"avx2", &base::scan::ops(base::scan::Isa::kAvx2)},
+    };
+    for (const Impl &impl : impls)
+    {
+        run("parse", impl.name, rounds, messages, corpus.size(), [&]()
+            { return parse(*impl.ops, corpus); });
+    }
+    for (const Impl &impl : impls)
+    {
+        run("resync", impl.name, rounds, messages, corpus.size(), [&]()
+            { return resync(*impl.ops, corpus); });
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+// 每个连接的堆分配次数与消息回调路径的 CPU 开销
+// 用法: connection_alloc_bench [连接数] [往返次数]，默认 20000、200000
+// 1. 客户端线程逐个 connect、close，统计服务端建立并销毁每个连接期间的 operator new 次数和字节数
+//    （客户端只用裸 socket，不分配堆内存）
+// 2. 一个连接上 1 字节 ping-pong，服务端 loop 线程的 CPU 时间除以消息数
+#include "EventLoop.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+    std::atomic<long> gAllocations(0);
+    std::atomic<long> gAllocatedBytes(0);
+
+    double threadCpuSeconds()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+    }
+
+    int connectTo(uint16_t port)
+    {
+        int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            ::close(sockfd);
+            return -1;
+        }
+        return sockfd;
+    }
+
+    void benchAllocations(int total, uint16_t port)
+    {
+        net::EventLoop loop;
+        net::TcpServer server(&loop, net::InetAddress(port), "alloc");
+        std::atomic<int> closed(0);
+        server.setConnectionCallback([&closed](const net::TcpConnectionPtr &conn)
+                                     {
+                                         if (conn->connected())
+                                         {
+                                             conn->shutdown(); // 服务端先关闭，TIME_WAIT 留在服务端
+                                         }
+                                         else
+                                         {
+                                             closed++;
+                                         } });
+        server.start();
+
+        long allocations = 0;
+        long bytes = 0;
+        std::thread client([&]()
+                           {
+            // 先热身，让连接池、定时器等一次性分配落在统计之外
+            for (int i = 0; i < 100 + total; ++i)
+            {
+                if (i == 100)
+                {
+                    while (closed.load() < 100)
+                    {
+                        std::this_thread::yield();
+                    }
+                    allocations = gAllocations.load();
+                    bytes = gAllocatedBytes.load();
+                }
+                int sockfd = connectTo(port);
+                if (sockfd >= 0)
+                {
+                    char c;
+                    ::recv(sockfd, &c, 1, 0);
+                    ::close(sockfd);
+                }
+            } });
+        loop.runEvery(0.01, [&]()
+                      {
+                          if (closed.load() == 100 + total)
+                          {
+                              loop.quit();
+                          } });
+        loop.loop();
+        client.join();
+        allocations = gAllocations.load() - allocations;
+        bytes = gAllocatedBytes.load() - bytes;
+        std::printf("per connection: %.2f allocations, %.0f bytes (%d connections, sizeof(TcpConnection) %zu)\n",
+                    static_cast<double>(allocations) / total, static_cast<double>(bytes) / total, total,
+                    sizeof(net::TcpConnection));
+    }
+
+    void benchCallbackPath(int roundTrips, uint16_t port)
+    {
+        net::EventLoop loop;
+        net::TcpServer server(&loop, net::InetAddress(port), "callback");
+        long messages = 0;
+        server.setMessageCallback([&messages](const net::TcpConnectionPtr &conn, net::Buffer *buf, base::Timestamp)
+                                  {
+                                      ++messages;
+                                      conn->send(buf);
+                                  });
+        server.setConnectionCallback([&loop](const net::TcpConnectionPtr &conn)
+                                     {
+                                         if (!conn->connected())
+                                         {
+                                             loop.quit();
+                                         } });
+        server.start();
+
+        std::thread client([&]()
+                           {
+            int sockfd = connectTo(port);
+            char c = 'x';
+            for (int i = 0; i < roundTrips && sockfd >= 0; ++i)
+            {
+                if (::send(sockfd, &c, 1, 0) != 1 || ::recv(sockfd, &c, 1, 0) != 1)
+                {
+                    break;
+                }
+            }
+            ::close(sockfd); });
+        const double cpuStart = threadCpuSeconds();
+        loop.loop();
+        const double cpu = threadCpuSeconds() - cpuStart;
+        client.join();
+        std::printf("callback path: %ld messages, server loop cpu %.3f us/message\n",
+                    messages, cpu * 1e6 / static_cast<double>(messages));
+    }
+}
+
+void *operator new(size_t size)
+{
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    gAllocatedBytes.fetch_add(static_cast<long>(size), std::memory_order_relaxed);
+    void *p = std::malloc(size ? size : 1);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+int main(int argc, char *argv[])
+{
+    const int total = argc > 1 ? std::atoi(argv[1]) : 20000;
+    const int roundTrips = argc > 2 ? std::atoi(argv[2]) : 200000;
+    benchAllocations(total, 19800);
+    benchCallbackPath(roundTrips, 19801);
+    return 0;
+}
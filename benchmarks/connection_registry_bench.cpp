@@ -0,0 +1,183 @@
+// 连接表：按名字索引的 std::map 与按 64 位 ID 索引的槽位表对比
+// 用法: connection_registry_bench [常驻连接数] [churn 次数] [服务端秒数]，默认 100000、1000000、2
+// 1. 表本身：常驻 N 个条目时每个条目占用的堆内存，以及删除最早一个、插入一个新条目的 churn 速率；
+//    map 版本照旧为每个连接 snprintf 拼名字，槽位表版本只分配 ID
+// 2. 真实服务端：客户端线程不停 connect、等服务端 shutdown、close，统计每秒完成的连接数
+//    （受 fd 上限所限不能同时保持 100k 个真实连接，所以常驻规模只在第 1 部分测）
+#include "ConnectionRegistry.hpp"
+#include "EventLoop.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <malloc.h>
+#include <map>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using Value = std::shared_ptr<int>; // 代替 TcpConnectionPtr，只比较表本身的开销
+
+    size_t heapInUse()
+    {
+        struct mallinfo2 info = mallinfo2();
+        return info.uordblks;
+    }
+
+    double secondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    void benchMap(const Value &value, int live, int churn)
+    {
+        const std::string serverName = "bench";
+        const std::string ipPort = "0.0.0.0:8554";
+        std::map<std::string, Value> connections;
+        std::deque<std::string> order;
+        int nextConnId = 1;
+        auto insert = [&]()
+        {
+            char buf[64];
+            snprintf(buf, sizeof buf, "-%s#%d", ipPort.c_str(), nextConnId);
+            ++nextConnId;
+            std::string connName = serverName + buf;
+            connections[connName] = value;
+            order.push_back(connName);
+        };
+
+        const size_t before = heapInUse();
+        for (int i = 0; i < live; ++i)
+        {
+            insert();
+        }
+        // 不计入 order 自身的开销
+        const size_t orderBytes = order.size() * sizeof(std::string);
+        const double perEntry = static_cast<double>(heapInUse() - before - orderBytes) / live;
+
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < churn; ++i)
+        {
+            connections.erase(order.front());
+            order.pop_front();
+            insert();
+        }
+        const double rate = churn / secondsSince(start);
+        std::printf("std::map<string>  %6.1f bytes/conn  churn %10.0f ops/s\n", perEntry, rate);
+    }
+
+    void benchSlotTable(const Value &value, int live, int churn)
+    {
+        net::SlotTable<Value> connections(0);
+        std::deque<net::ConnectionId> order;
+
+        const size_t before = heapInUse();
+        for (int i = 0; i < live; ++i)
+        {
+            order.push_back(connections.insert(value));
+        }
+        const size_t orderBytes = order.size() * sizeof(net::ConnectionId);
+        const double perEntry = static_cast<double>(heapInUse() - before - orderBytes) / live;
+
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < churn; ++i)
+        {
+            connections.erase(order.front());
+            order.pop_front();
+            order.push_back(connections.insert(value));
+        }
+        const double rate = churn / secondsSince(start);
+        std::printf("SlotTable<id>     %6.1f bytes/conn  churn %10.0f ops/s\n", perEntry, rate);
+    }
+
+    double benchServer(int threads, int clients, double seconds, uint16_t port)
+    {
+        std::atomic<long> closed(0);
+        std::atomic<bool> stop(false);
+        net::EventLoop loop;
+        net::InetAddress listenAddr(port);
+        net::TcpServer server(&loop, listenAddr, "churn");
+        server.setThreadNum(threads);
+        server.setConnectionCallback([&closed](const net::TcpConnectionPtr &conn)
+                                     {
+                                         if (conn->connected())
+                                         {
+                                             conn->shutdown();
+                                         }
+                                         else
+                                         {
+                                             closed.fetch_add(1, std::memory_order_relaxed);
+                                         } });
+        server.start();
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < clients; ++i)
+        {
+            workers.emplace_back([&]()
+                                 {
+                sockaddr_in addr;
+                std::memset(&addr, 0, sizeof(addr));
+                addr.sin_family = AF_INET;
+                addr.sin_port = htons(port);
+                ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+                    timeval timeout = {0, 100 * 1000};
+                    ::setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                    if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+                    {
+                        char c;
+                        ::recv(sockfd, &c, 1, 0); // 等服务端 shutdown
+                    }
+                    ::close(sockfd);
+                } });
+        }
+
+        long startClosed = 0;
+        loop.runAfter(0.3, [&]()
+                      { startClosed = closed.load(); });
+        loop.runAfter(0.3 + seconds, [&]()
+                      {
+                          startClosed = closed.load() - startClosed;
+                          stop = true;
+                          loop.quit(); });
+        loop.loop();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        return static_cast<double>(startClosed) / seconds;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int live = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const int churn = argc > 2 ? std::atoi(argv[2]) : 1000000;
+    const double seconds = argc > 3 ? std::atof(argv[3]) : 2.0;
+
+    std::printf("%d live entries, %d churn ops; sizeof(TcpConnection) %zu\n", live, churn, sizeof(net::TcpConnection));
+    Value value = std::make_shared<int>(0);
+    benchMap(value, live, churn);
+    benchSlotTable(value, live, churn);
+
+    const int threads[] = {0, 4};
+    uint16_t port = 19700;
+    for (int n : threads)
+    {
+        double rate = benchServer(n, 4, seconds, port++);
+        std::printf("server %d io threads: %10.0f conn/s\n", n, rate);
+    }
+    return 0;
+}
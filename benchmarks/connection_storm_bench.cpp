@@ -0,0 +1,151 @@
+// 连接风暴：子进程尽快发起大量连接，比较不同 accept 批量下服务端取完连接的耗时
+// 用法: connection_storm_bench [连接总数] [客户端线程数] [IO 线程数]，默认 50000、4、3
+// 客户端在独立进程中运行（各自的 fd 上限），轮流绑定 127.0.0.1~16 作为源地址以避开单个源地址的端口数限制；
+// 每个线程最多同时保持一定数量的连接，超出后关闭最早的。服务端 fd 耗尽时由 Acceptor 接下并关闭（shed）
+#include "EventLoop.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    void runClients(uint16_t port, int total, int threads)
+    {
+        rlimit limit;
+        getrlimit(RLIMIT_NOFILE, &limit);
+        const size_t hold = static_cast<size_t>(limit.rlim_cur > 200 ? (limit.rlim_cur - 100) / threads : 1);
+        std::atomic<int> next(0);
+        std::atomic<int> failed(0);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&]()
+                                 {
+                std::deque<int> open;
+                sockaddr_in server;
+                std::memset(&server, 0, sizeof(server));
+                server.sin_family = AF_INET;
+                server.sin_port = htons(port);
+                ::inet_pton(AF_INET, "127.0.0.1", &server.sin_addr);
+                for (int i = next++; i < total; i = next++)
+                {
+                    int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+                    int on = 1;
+                    ::setsockopt(sockfd, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, &on, sizeof(on));
+                    sockaddr_in local;
+                    std::memset(&local, 0, sizeof(local));
+                    local.sin_family = AF_INET;
+                    local.sin_addr.s_addr = htonl(0x7f000001 + static_cast<uint32_t>(i % 16));
+                    ::bind(sockfd, reinterpret_cast<sockaddr *>(&local), sizeof(local));
+                    if (::connect(sockfd, reinterpret_cast<sockaddr *>(&server), sizeof(server)) != 0)
+                    {
+                        failed++;
+                        ::close(sockfd);
+                        continue;
+                    }
+                    open.push_back(sockfd);
+                    if (open.size() > hold)
+                    {
+                        ::close(open.front());
+                        open.pop_front();
+                    }
+                }
+                // 等服务端取完 backlog 再关闭
+                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                for (int sockfd : open)
+                {
+                    ::close(sockfd);
+                } });
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        if (failed.load() > 0)
+        {
+            std::printf("  client: %d connects failed\n", failed.load());
+        }
+    }
+
+    void run(int batch, int total, int clientThreads, int ioThreads, uint16_t port)
+    {
+        net::EventLoop loop;
+        net::InetAddress listenAddr(port);
+        net::TcpServer server(&loop, listenAddr, "storm");
+        server.setThreadNum(ioThreads);
+        server.setAcceptBatch(batch);
+        server.setMessageCallback([](const net::TcpConnectionPtr &, net::Buffer *buf, base::Timestamp)
+                                  { buf->retrieveAll(); });
+        server.start();
+
+        const Clock::time_point start = Clock::now();
+        pid_t child = ::fork();
+        if (child == 0)
+        {
+            runClients(port, total, clientThreads);
+            ::_exit(0);
+        }
+
+        double elapsed = 0;
+        loop.runEvery(0.001, [&]()
+                      {
+                          net::AcceptStats stats = server.acceptStats();
+                          if (elapsed == 0 && stats.accepted + stats.shed >= total)
+                          {
+                              elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+                          }
+                          int status;
+                          if (::waitpid(child, &status, WNOHANG) == child)
+                          {
+                              loop.quit();
+                          } });
+        loop.loop();
+
+        net::AcceptStats stats = server.acceptStats();
+        if (elapsed == 0)
+        {
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        std::printf("batch %-3d accepted %6ld shed %6ld errors %ld in %.2fs (%.0f conn/s), wakeups %ld, max batch %ld\n",
+                    batch, static_cast<long>(stats.accepted), static_cast<long>(stats.shed), static_cast<long>(stats.errors),
+                    elapsed, static_cast<double>(stats.accepted + stats.shed) / elapsed,
+                    static_cast<long>(stats.wakeups), static_cast<long>(stats.maxBatch));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int total = argc > 1 ? std::atoi(argv[1]) : 50000;
+    const int clientThreads = argc > 2 ? std::atoi(argv[2]) : 4;
+    const int ioThreads = argc > 3 ? std::atoi(argv[3]) : 3;
+
+    rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    std::printf("fd limit %lu, %d connections, %d client threads, %d io threads\n",
+                static_cast<unsigned long>(limit.rlim_cur), total, clientThreads, ioThreads);
+
+    uint16_t port = 19600;
+    const int batches[] = {1, 16, 64};
+    for (int batch : batches)
+    {
+        run(batch, total, clientThreads, ioThreads, port++);
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+// 小消息回显：比较开启 / 关闭 EventLoop 统计时的吞吐
+// 用法: echo_bench [客户端连接数] [每轮秒数] [轮数]，默认 4 个连接、2 秒、3 轮
+// 每个客户端线程用阻塞 socket 发送 64 字节并等待回显，服务端 loop 在主线程
+#include "EventLoop.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    int connectLoopback(uint16_t port)
+    {
+        int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        for (int i = 0; i < 100; ++i)
+        {
+            if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+            {
+                return sockfd;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ::close(sockfd);
+        return -1;
+    }
+
+    double run(bool statsEnabled, int clients, double seconds, uint16_t port)
+    {
+        std::atomic<long> messages(0);
+        std::atomic<bool> stop(false);
+        std::vector<std::thread> threads;
+        net::EventLoop loop;
+        loop.setStatsEnabled(statsEnabled);
+        {
+            net::InetAddress listenAddr(port);
+            net::TcpServer server(&loop, listenAddr, "echo");
+            server.setMessageCallback([](const net::TcpConnectionPtr &conn, net::Buffer *buf, base::Timestamp)
+                                      { conn->send(buf); });
+            server.start();
+
+            for (int i = 0; i < clients; ++i)
+            {
+                threads.emplace_back([&]()
+                                     {
+                    int sockfd = connectLoopback(port);
+                    if (sockfd < 0)
+                    {
+                        return;
+                    }
+                    char buf[64] = {};
+                    while (!stop.load(std::memory_order_relaxed))
+                    {
+                        if (::send(sockfd, buf, sizeof(buf), MSG_NOSIGNAL) != sizeof(buf))
+                        {
+                            break;
+                        }
+                        size_t got = 0;
+                        while (got < sizeof(buf))
+                        {
+                            ssize_t n = ::recv(sockfd, buf + got, sizeof(buf) - got, 0);
+                            if (n <= 0)
+                            {
+                                got = 0;
+                                break;
+                            }
+                            got += static_cast<size_t>(n);
+                        }
+                        if (got == 0)
+                        {
+                            break;
+                        }
+                        messages.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    ::close(sockfd); });
+            }
+
+            long startMessages = 0;
+            loop.runAfter(0.2, [&]()
+                          { startMessages = messages.load(); }); // 预热后开始计数
+            loop.runAfter(0.2 + seconds, [&]()
+                          {
+                              startMessages = messages.load() - startMessages;
+                              stop = true;
+                              loop.quit(); });
+            loop.loop();
+            messages = startMessages;
+            if (statsEnabled)
+            {
+                std::printf("  %s\n", loop.stats().toString().c_str());
+            }
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        return static_cast<double>(messages.load()) / seconds;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int clients = argc > 1 ? std::atoi(argv[1]) : 4;
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+    const int rounds = argc > 3 ? std::atoi(argv[3]) : 3;
+
+    uint16_t port = 19200;
+    double total[2] = {0, 0};
+    for (int round = 0; round < rounds; ++round)
+    {
+        for (int enabled = 0; enabled < 2; ++enabled)
+        {
+            double rate = run(enabled == 1, clients, seconds, port++);
+            total[enabled] += rate;
+            std::printf("round %d stats %-3s %10.0f msg/s\n", round, enabled ? "on" : "off", rate);
+        }
+    }
+    std::printf("average: off %.0f msg/s, on %.0f msg/s, overhead %.2f%%\n",
+                total[0] / rounds, total[1] / rounds, (total[0] - total[1]) / total[0] * 100.0);
+    return 0;
+}
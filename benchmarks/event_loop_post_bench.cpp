@@ -0,0 +1,124 @@
+// 跨线程投递吞吐：N 个生产者线程向同一个 EventLoop 投递任务
+// 用法: event_loop_post_bench [每个生产者的任务数]，默认 200000
+// 同时给出旧实现（mutex + vector + 每次写 eventfd）的对照数据
+#include "EventLoop.hpp"
+#include "EventLoopThread.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // 旧实现的最小复刻，用于对照
+    class MutexTaskQueue
+    {
+    public:
+        MutexTaskQueue() : wakeupFd_(::eventfd(0, EFD_CLOEXEC)), quit_(false) {}
+        ~MutexTaskQueue() { ::close(wakeupFd_); }
+
+        void post(std::function<void()> cb)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_.push_back(std::move(cb));
+            }
+            uint64_t one = 1;
+            [[maybe_unused]] ssize_t n = ::write(wakeupFd_, &one, sizeof(one));
+        }
+
+        void run()
+        {
+            while (!quit_)
+            {
+                uint64_t value = 0;
+                [[maybe_unused]] ssize_t n = ::read(wakeupFd_, &value, sizeof(value));
+                std::vector<std::function<void()>> functors;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    functors.swap(pending_);
+                }
+                for (auto &functor : functors)
+                {
+                    functor();
+                }
+            }
+        }
+
+        void quit()
+        {
+            post([this]()
+                 { quit_ = true; });
+        }
+
+    private:
+        int wakeupFd_;
+        bool quit_;
+        std::mutex mutex_;
+        std::vector<std::function<void()>> pending_;
+    };
+
+    template <typename Post>
+    double measure(int producers, long perProducer, std::atomic<long> &done, Post post)
+    {
+        const long total = producers * perProducer;
+        done = 0;
+        auto start = Clock::now();
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, perProducer]()
+                                 {
+                for (long i = 0; i < perProducer; ++i)
+                {
+                    post([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+                } });
+        }
+        for (auto &t : threads)
+        {
+            t.join();
+        }
+        while (done.load(std::memory_order_relaxed) < total)
+        {
+            std::this_thread::yield();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return static_cast<double>(total) / seconds / 1e6;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    long perProducer = argc > 1 ? std::atol(argv[1]) : 200000;
+    const int producerCounts[] = {1, 2, 4, 8};
+
+    std::printf("%-10s %10s %14s %14s\n", "producers", "tasks", "loop(Mops/s)", "mutex(Mops/s)");
+    for (int producers : producerCounts)
+    {
+        std::atomic<long> done(0);
+
+        net::EventLoopThread loopThread;
+        net::EventLoop *loop = loopThread.startLoop();
+        double lockFree = measure(producers, perProducer, done, [loop](net::EventLoop::Functor cb)
+                                  { loop->queueInLoop(std::move(cb)); });
+        loopThread.stopLoop();
+
+        MutexTaskQueue queue;
+        std::thread consumer([&queue]()
+                             { queue.run(); });
+        double mutex = measure(producers, perProducer, done, [&queue](std::function<void()> cb)
+                               { queue.post(std::move(cb)); });
+        queue.quit();
+        consumer.join();
+
+        std::printf("%-10d %10ld %14.2f %14.2f\n", producers, producers * perProducer, lockFree, mutex);
+    }
+    return 0;
+}
@@ -0,0 +1,194 @@
+// 一对多分发：同一个 RTP 包发给所有订阅者，比较逐连接拷贝 send(data, len) 与按引用排队 send(SharedSlice)
+// 用法: fanout_bench [秒数] [每 10ms 包数]，默认 3、10（1400 字节包，约 1.1 Mbps 每订阅者）
+// 每种配置在独立子进程中运行：发布者在 baseLoop 定时器中发包，订阅者连接分布在 2 个 IO loop 上；
+// 客户端在另一个进程中用 epoll 读，前三分之一时间不读，让发送缓冲区堆积。
+// 统计每订阅者的服务端 CPU 占用与服务端峰值 RSS
+#include "EventLoop.hpp"
+#include "SharedSlice.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <arpa/inet.h>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    const size_t kPacketBytes = 1400;
+
+    double processCpuSeconds()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+               static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    int connectTo(uint16_t port)
+    {
+        int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+        int rcvbuf = 4096; // 限制内核接收缓冲区，让数据堆积在服务端发送缓冲区
+        ::setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        for (int i = 0; i < 100; ++i)
+        {
+            if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+            {
+                return sockfd;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ::close(sockfd);
+        return -1;
+    }
+
+    // 客户端进程：建立全部连接后等 stallSeconds 再开始读，直到被父进程结束
+    void runClients(uint16_t port, int subscribers, double stallSeconds)
+    {
+        int epollfd = ::epoll_create1(0);
+        for (int i = 0; i < subscribers; ++i)
+        {
+            int sockfd = connectTo(port);
+            if (sockfd < 0)
+            {
+                return;
+            }
+            epoll_event event;
+            event.events = EPOLLIN;
+            event.data.fd = sockfd;
+            ::epoll_ctl(epollfd, EPOLL_CTL_ADD, sockfd, &event);
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(stallSeconds));
+        std::vector<epoll_event> events(256);
+        std::vector<char> buf(64 * 1024);
+        while (true)
+        {
+            int n = ::epoll_wait(epollfd, events.data(), static_cast<int>(events.size()), 100);
+            for (int i = 0; i < n; ++i)
+            {
+                if (::recv(events[static_cast<size_t>(i)].data.fd, buf.data(), buf.size(), 0) <= 0)
+                {
+                    ::epoll_ctl(epollfd, EPOLL_CTL_DEL, events[static_cast<size_t>(i)].data.fd, nullptr);
+                }
+            }
+        }
+    }
+
+    void runServer(int subscribers, bool shared, double seconds, int packetsPerTick)
+    {
+        const uint16_t port = 19910;
+        net::EventLoop loop;
+        net::TcpServer server(&loop, net::InetAddress(port), "fanout");
+        server.setThreadNum(2);
+        std::mutex mutex;
+        std::vector<net::TcpConnectionPtr> connections;
+        server.setConnectionCallback([&](const net::TcpConnectionPtr &conn)
+                                     {
+                                         if (conn->connected())
+                                         {
+                                             std::lock_guard<std::mutex> lock(mutex);
+                                             connections.push_back(conn);
+                                         } });
+        server.start();
+
+        pid_t client = ::fork();
+        if (client == 0)
+        {
+            runClients(port, subscribers, seconds / 3);
+            ::_exit(0);
+        }
+
+        const std::string payload(kPacketBytes, 'r');
+        double cpuStart = -1;
+        Clock::time_point start;
+        loop.runEvery(0.01, [&]()
+                      {
+                          std::vector<net::TcpConnectionPtr> targets;
+                          {
+                              std::lock_guard<std::mutex> lock(mutex);
+                              targets = connections;
+                          }
+                          if (static_cast<int>(targets.size()) < subscribers)
+                          {
+                              return;
+                          }
+                          if (cpuStart < 0)
+                          {
+                              cpuStart = processCpuSeconds();
+                              start = Clock::now();
+                          }
+                          for (int i = 0; i < packetsPerTick; ++i)
+                          {
+                              if (shared)
+                              {
+                                  const net::SharedSlice packet(payload.data(), payload.size());
+                                  for (auto &conn : targets)
+                                  {
+                                      conn->send(packet);
+                                  }
+                              }
+                              else
+                              {
+                                  for (auto &conn : targets)
+                                  {
+                                      conn->send(payload.data(), payload.size());
+                                  }
+                              }
+                          }
+                          const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+                          if (elapsed >= seconds)
+                          {
+                              const double cpu = processCpuSeconds() - cpuStart;
+                              rusage usage;
+                              getrusage(RUSAGE_SELF, &usage);
+                              std::printf("%-6s %5d subscribers: cpu %6.1f%% total, %5.1f us/s per subscriber, peak RSS %7.1f MB (%.1f KB per subscriber)\n",
+                                          shared ? "shared" : "copy", subscribers, cpu * 100 / elapsed, cpu * 1e6 / elapsed / subscribers,
+                                          static_cast<double>(usage.ru_maxrss) / 1024, static_cast<double>(usage.ru_maxrss) / subscribers);
+                              std::fflush(stdout);
+                              ::kill(client, SIGKILL);
+                              ::waitpid(client, nullptr, 0);
+                              ::_exit(0); // 不等连接逐个关闭
+                          } });
+        loop.loop();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 3.0;
+    const int packetsPerTick = argc > 2 ? std::atoi(argv[2]) : 10;
+    std::printf("%zu byte packets, %d per 10ms to every subscriber, %.1fs (client stalls the first third)\n",
+                kPacketBytes, packetsPerTick, seconds);
+    std::fflush(stdout);
+    for (int subscribers : {100, 500, 1000})
+    {
+        for (bool shared : {false, true})
+        {
+            pid_t server = ::fork();
+            if (server == 0)
+            {
+                runServer(subscribers, shared, seconds, packetsPerTick);
+                ::_exit(0);
+            }
+            ::waitpid(server, nullptr, 0);
+        }
+    }
+    return 0;
+}
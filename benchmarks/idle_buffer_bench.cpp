@@ -0,0 +1,157 @@
+// 空闲连接内存：每个连接先收一次突发大消息，之后保持空闲，比较开启 / 关闭空闲缓冲区回收时每连接占用的内存
+// 用法: idle_buffer_bench [连接数] [突发 KB]，默认 2000、128
+// 每种配置在独立子进程中运行，客户端在另一个进程中。服务端攒够一整条消息才取走（模拟按帧解析），
+// 接收缓冲区因此涨到消息大小。全部突发收完后等待 2.5 个回收周期，统计 RSS 相对建连前的增量；
+// glibc 会把释放的堆内存留在 arena 中，另给出 malloc_trim 之后的数值
+#include "EventLoop.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <arpa/inet.h>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    const double kReleaseInterval = 1.0;
+
+    double residentMB()
+    {
+        long pages = 0;
+        long resident = 0;
+        FILE *file = std::fopen("/proc/self/statm", "r");
+        if (file)
+        {
+            if (std::fscanf(file, "%ld %ld", &pages, &resident) != 2)
+            {
+                resident = 0;
+            }
+            std::fclose(file);
+        }
+        return static_cast<double>(resident) * static_cast<double>(::sysconf(_SC_PAGESIZE)) / (1024 * 1024);
+    }
+
+    int connectTo(uint16_t port)
+    {
+        int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        for (int i = 0; i < 100; ++i)
+        {
+            if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+            {
+                return sockfd;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ::close(sockfd);
+        return -1;
+    }
+
+    // 客户端进程：逐个建连并发出一条突发消息，之后保持连接直到被结束
+    void runClients(uint16_t port, int connections, size_t burstBytes)
+    {
+        const std::string burst(burstBytes, 'b');
+        std::vector<int> sockets;
+        for (int i = 0; i < connections; ++i)
+        {
+            int sockfd = connectTo(port);
+            if (sockfd < 0)
+            {
+                break;
+            }
+            size_t sent = 0;
+            while (sent < burst.size())
+            {
+                ssize_t n = ::send(sockfd, burst.data() + sent, burst.size() - sent, 0);
+                if (n <= 0)
+                {
+                    break;
+                }
+                sent += static_cast<size_t>(n);
+            }
+            sockets.push_back(sockfd);
+        }
+        ::pause();
+    }
+
+    void runServer(bool release, int connections, size_t burstBytes)
+    {
+        const uint16_t port = release ? 19941 : 19940;
+        net::EventLoop loop;
+        net::TcpServer server(&loop, net::InetAddress(port), "idle");
+        server.setIdleBufferRelease(release ? kReleaseInterval : 0.0);
+        int received = 0;
+        server.setMessageCallback([&](const net::TcpConnectionPtr &, net::Buffer *buf, base::Timestamp)
+                                  {
+                                      if (buf->readableBytes() >= burstBytes)
+                                      {
+                                          buf->retrieveAll();
+                                          ++received;
+                                      } });
+        server.start();
+        const double baseline = residentMB();
+
+        pid_t client = ::fork();
+        if (client == 0)
+        {
+            runClients(port, connections, burstBytes);
+            ::_exit(0);
+        }
+
+        double peak = 0;
+        auto report = [&]()
+        {
+            const double idle = residentMB();
+            ::malloc_trim(0);
+            const double trimmed = residentMB();
+            std::printf("release %-3s: peak %7.1f MB, idle %7.1f MB (%6.1f KB/conn), after malloc_trim %7.1f MB (%6.1f KB/conn)\n",
+                        release ? "on" : "off", peak - baseline, idle - baseline, (idle - baseline) * 1024 / connections,
+                        trimmed - baseline, (trimmed - baseline) * 1024 / connections);
+            std::fflush(stdout);
+            ::kill(client, SIGKILL);
+            ::waitpid(client, nullptr, 0);
+            ::_exit(0); // 不等连接逐个关闭
+        };
+        loop.runEvery(0.05, [&]()
+                      {
+                          peak = std::max(peak, residentMB());
+                          if (received == connections)
+                          {
+                              received = -1; // 只触发一次
+                              loop.runAfter(2.5 * kReleaseInterval, report);
+                          } });
+        loop.loop();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int connections = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const size_t burstBytes = static_cast<size_t>(argc > 2 ? std::atoi(argv[2]) : 128) * 1024;
+    std::printf("%d connections, one %zu KB burst each, then idle\n", connections, burstBytes / 1024);
+    std::fflush(stdout);
+    for (bool release : {false, true})
+    {
+        pid_t server = ::fork();
+        if (server == 0)
+        {
+            runServer(release, connections, burstBytes);
+            ::_exit(0);
+        }
+        ::waitpid(server, nullptr, 0);
+    }
+    return 0;
+}
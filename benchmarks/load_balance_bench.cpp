@@ -0,0 +1,195 @@
+// 码率悬殊的连接混跑：比较各 loop 挑选策略下小消息的回显延迟
+// 用法: load_balance_bench [IO 线程数] [大流量连接数] [交互连接数] [每种策略秒数]，默认 4、2、8、2
+// 大流量连接持续推送 64KB 块（服务端读后丢弃），交互连接发 64 字节并等待回显、记录往返时间。
+// 大流量连接之间插入空闲连接，使轮询把它们都排到同一个 loop 上；交互连接在大流量跑稳之后接入
+#include "EventLoop.hpp"
+#include "EventLoopThreadPool.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using LoadBalance = net::EventLoopThreadPool::LoadBalance;
+
+    int connectLoopback(uint16_t port)
+    {
+        int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        for (int i = 0; i < 100; ++i)
+        {
+            if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+            {
+                return sockfd;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ::close(sockfd);
+        return -1;
+    }
+
+    struct Result
+    {
+        double p50Us;
+        double p99Us;
+        double p999Us;
+        long samples;
+    };
+
+    Result run(LoadBalance strategy, int threads, int heavy, int light, double seconds, uint16_t port)
+    {
+        std::atomic<bool> stop(false);
+        std::mutex mutex;
+        std::vector<double> rtts;
+        std::vector<std::thread> clients;
+        std::vector<int> idle;
+        net::EventLoop loop;
+        net::InetAddress listenAddr(port);
+        net::TcpServer server(&loop, listenAddr, "balance");
+        server.setThreadNum(threads);
+        server.setLoadBalance(strategy);
+        server.setMessageCallback([](const net::TcpConnectionPtr &conn, net::Buffer *buf, base::Timestamp)
+                                  {
+                                      if (buf->peek()[0] == 'H')
+                                      {
+                                          buf->retrieveAll(); // 大流量连接只收不回
+                                      }
+                                      else
+                                      {
+                                          conn->send(buf);
+                                      } });
+        server.start();
+
+        std::thread driver([&]()
+                           {
+            for (int i = 0; i < heavy; ++i)
+            {
+                clients.emplace_back([&]()
+                                     {
+                    int sockfd = connectLoopback(port);
+                    std::vector<char> block(64 * 1024, 'H');
+                    while (sockfd >= 0 && !stop.load(std::memory_order_relaxed))
+                    {
+                        if (::send(sockfd, block.data(), block.size(), MSG_NOSIGNAL) <= 0)
+                        {
+                            break;
+                        }
+                    }
+                    ::close(sockfd); });
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                for (int j = 0; j + 1 < threads; ++j)
+                {
+                    idle.push_back(connectLoopback(port));
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(500)); // 等各 loop 的速率稳定
+
+            const Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+            for (int i = 0; i < light; ++i)
+            {
+                clients.emplace_back([&]()
+                                     {
+                    int sockfd = connectLoopback(port);
+                    std::vector<double> local;
+                    char buf[64];
+                    std::memset(buf, 'L', sizeof(buf));
+                    while (sockfd >= 0 && Clock::now() < deadline)
+                    {
+                        const Clock::time_point start = Clock::now();
+                        if (::send(sockfd, buf, sizeof(buf), MSG_NOSIGNAL) != sizeof(buf))
+                        {
+                            break;
+                        }
+                        size_t got = 0;
+                        while (got < sizeof(buf))
+                        {
+                            ssize_t n = ::recv(sockfd, buf + got, sizeof(buf) - got, 0);
+                            if (n <= 0)
+                            {
+                                break;
+                            }
+                            got += static_cast<size_t>(n);
+                        }
+                        if (got < sizeof(buf))
+                        {
+                            break;
+                        }
+                        local.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                    ::close(sockfd);
+                    std::lock_guard<std::mutex> lock(mutex);
+                    rtts.insert(rtts.end(), local.begin(), local.end()); });
+            }
+            std::this_thread::sleep_until(deadline);
+            std::printf("  %s\n", server.loopStats().toString().c_str());
+            stop = true;
+            loop.runInLoop([&loop]()
+                           { loop.quit(); }); });
+
+        loop.loop();
+        driver.join();
+        for (auto &client : clients)
+        {
+            client.join();
+        }
+        for (int sockfd : idle)
+        {
+            ::close(sockfd);
+        }
+
+        Result result = {0, 0, 0, static_cast<long>(rtts.size())};
+        if (!rtts.empty())
+        {
+            std::sort(rtts.begin(), rtts.end());
+            result.p50Us = rtts[rtts.size() / 2];
+            result.p99Us = rtts[rtts.size() * 99 / 100];
+            result.p999Us = rtts[rtts.size() * 999 / 1000];
+        }
+        return result;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int threads = argc > 1 ? std::atoi(argv[1]) : 4;
+    const int heavy = argc > 2 ? std::atoi(argv[2]) : 2;
+    const int light = argc > 3 ? std::atoi(argv[3]) : 8;
+    const double seconds = argc > 4 ? std::atof(argv[4]) : 2.0;
+
+    const struct
+    {
+        LoadBalance strategy;
+        const char *name;
+    } strategies[] = {
+        {LoadBalance::kRoundRobin, "round-robin"},
+        {LoadBalance::kLeastConnections, "least-connections"},
+        {LoadBalance::kLeastBytesPerSecond, "least-bytes/s"},
+        {LoadBalance::kPowerOfTwoChoices, "two-choices"},
+    };
+    uint16_t port = 19300;
+    for (const auto &s : strategies)
+    {
+        Result r = run(s.strategy, threads, heavy, light, seconds, port++);
+        std::printf("%-18s rtt p50 %8.1fus  p99 %8.1fus  p999 %8.1fus  (%ld samples)\n",
+                    s.name, r.p50Us, r.p99Us, r.p999Us, r.samples);
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+// 发送缓冲区：每个连接持续 100 Mbps 输出，部分客户端读得慢，发送缓冲区不断堆积
+// 用法: output_buffer_bench [快读者数] [慢读者数] [秒数] [慢读者 Mbps]，默认 4、4、3、10
+// 服务端每 10ms 给每个连接发一个 125KB 的“帧”（100 Mbps）；客户端在子进程中运行，
+// 快读者尽快读，慢读者按限速读。统计快读者实际吞吐、服务端 loop CPU 占用和服务端峰值 RSS
+#include "EventLoop.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    const double kTick = 0.01;
+    const size_t kFrameBytes = 125 * 1000; // 100 Mbps / 100 帧每秒
+
+    double threadCpuSeconds()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+    }
+
+    int connectTo(uint16_t port)
+    {
+        int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        for (int i = 0; i < 100; ++i)
+        {
+            if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+            {
+                return sockfd;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ::close(sockfd);
+        return -1;
+    }
+
+    // 子进程：每个连接一个线程，slowMbps <= 0 表示不限速；通过管道把每个快读者读到的字节数交给父进程
+    void runClients(uint16_t port, int fast, int slow, double seconds, double slowMbps, int reportFd)
+    {
+        std::vector<std::thread> readers;
+        std::vector<long> received(static_cast<size_t>(fast + slow), 0);
+        const Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+        for (int i = 0; i < fast + slow; ++i)
+        {
+            readers.emplace_back([&, i]()
+                                 {
+                const bool isSlow = i >= fast;
+                int sockfd = connectTo(port);
+                std::vector<char> buf(64 * 1024);
+                const Clock::time_point start = Clock::now();
+                long &total = received[static_cast<size_t>(i)];
+                while (sockfd >= 0 && Clock::now() < deadline)
+                {
+                    size_t want = buf.size();
+                    if (isSlow)
+                    {
+                        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+                        const long allowed = static_cast<long>(elapsed * slowMbps * 1e6 / 8) - total;
+                        if (allowed <= 0)
+                        {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                            continue;
+                        }
+                        want = std::min(want, static_cast<size_t>(allowed));
+                    }
+                    ssize_t n = ::recv(sockfd, buf.data(), want, 0);
+                    if (n <= 0)
+                    {
+                        break;
+                    }
+                    total += n;
+                }
+                ::close(sockfd); });
+        }
+        for (auto &reader : readers)
+        {
+            reader.join();
+        }
+        long fastBytes = 0;
+        for (int i = 0; i < fast; ++i)
+        {
+            fastBytes += received[static_cast<size_t>(i)];
+        }
+        ssize_t n = ::write(reportFd, &fastBytes, sizeof(fastBytes));
+        (void)n;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int fast = argc > 1 ? std::atoi(argv[1]) : 4;
+    const int slow = argc > 2 ? std::atoi(argv[2]) : 4;
+    const double seconds = argc > 3 ? std::atof(argv[3]) : 3.0;
+    const double slowMbps = argc > 4 ? std::atof(argv[4]) : 10.0;
+    const uint16_t port = 19900;
+
+    net::EventLoop loop;
+    net::TcpServer server(&loop, net::InetAddress(port), "output");
+    std::map<net::TcpConnection *, net::TcpConnectionPtr> connections;
+    server.setConnectionCallback([&connections](const net::TcpConnectionPtr &conn)
+                                 {
+                                     if (conn->connected())
+                                     {
+                                         connections[conn.get()] = conn;
+                                     }
+                                     else
+                                     {
+                                         connections.erase(conn.get());
+                                     } });
+    server.start();
+
+    int pipeFds[2];
+    if (::pipe(pipeFds) != 0)
+    {
+        return 1;
+    }
+    pid_t child = ::fork();
+    if (child == 0)
+    {
+        ::close(pipeFds[0]);
+        runClients(port, fast, slow, seconds, slowMbps, pipeFds[1]);
+        ::_exit(0);
+    }
+    ::close(pipeFds[1]);
+
+    const std::string frame(kFrameBytes, 'f');
+    double cpuStart = 0;
+    Clock::time_point start;
+    loop.runAfter(0.0, [&]()
+                  {
+                      cpuStart = threadCpuSeconds();
+                      start = Clock::now(); });
+    loop.runEvery(kTick, [&]()
+                  {
+                      for (auto &item : connections)
+                      {
+                          item.second->send(frame.data(), frame.size());
+                      }
+                      int status;
+                      if (::waitpid(child, &status, WNOHANG) == child)
+                      {
+                          loop.quit();
+                      } });
+    loop.loop();
+    const double cpu = threadCpuSeconds() - cpuStart;
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    long fastBytes = 0;
+    ssize_t n = ::read(pipeFds[0], &fastBytes, sizeof(fastBytes));
+    (void)n;
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::printf("%d fast + %d slow (%.0f Mbps) readers, 100 Mbps offered each, %.1fs\n", fast, slow, slowMbps, seconds);
+    std::printf("fast reader throughput %.1f Mbps/conn, server loop cpu %.1f%%, peak RSS %.1f MB\n",
+                static_cast<double>(fastBytes) * 8 / 1e6 / seconds / fast, cpu * 100 / elapsed,
+                static_cast<double>(usage.ru_maxrss) / 1024);
+    std::printf("send buffer slabs in use %.1f MB, pooled %.1f MB\n",
+                static_cast<double>(loop.bufferPool().blocksInUse() * loop.bufferPool().blockSize()) / 1e6,
+                static_cast<double>(loop.bufferPool().reservedBytes()) / 1e6);
+    connections.clear();
+    return 0;
+}
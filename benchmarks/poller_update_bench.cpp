@@ -0,0 +1,99 @@
+// Poller::updateChannel 开销：在 loop 线程内反复开关写事件
+// 用法: poller_update_bench [切换次数] [注册的 channel 数]，默认 1000000 次、1000 个
+// 每个 channel 先 enableWriting 再 disableWriting；每轮 loop 做 batch 次切换，
+// batch 为 1 时每次切换各自提交一次 epoll_ctl，batch 为偶数时同一轮内的开关相互抵消
+#include "Channel.hpp"
+#include "EventLoop.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    void run(long toggles, int numChannels, long batch)
+    {
+        net::EventLoop loop(net::PollerBackend::kEpoll);
+        std::vector<int> fds;
+        std::vector<std::unique_ptr<net::Channel>> channels;
+        for (int i = 0; i < numChannels; ++i)
+        {
+            int fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            fds.push_back(fd);
+            channels.emplace_back(new net::Channel(&loop, fd));
+            channels.back()->enableReading();
+        }
+
+        long done = 0;
+        int64_t startIteration = 0;
+        int64_t startAvoided = 0;
+        std::chrono::steady_clock::time_point start;
+        std::function<void()> step = [&]()
+        {
+            for (long i = 0; i < batch && done < toggles; ++i, ++done)
+            {
+                net::Channel *channel = channels[static_cast<size_t>(done / 2) % channels.size()].get();
+                if (done % 2 == 0)
+                {
+                    channel->enableWriting();
+                }
+                else
+                {
+                    channel->disableWriting();
+                }
+            }
+            if (done < toggles)
+            {
+                loop.queueInLoop([&]()
+                                 { step(); }); // 下一轮继续
+            }
+            else
+            {
+                loop.quit();
+            }
+        };
+        // 用定时器启动：loop 开始前在本线程投递的任务不会唤醒第一次 epoll_wait
+        loop.runAfter(0.0, [&]()
+                      {
+                          startIteration = loop.iteration();
+                          startAvoided = loop.avoidedPollerUpdates();
+                          start = std::chrono::steady_clock::now();
+                          step(); });
+        loop.loop();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const int64_t avoided = loop.avoidedPollerUpdates() - startAvoided;
+
+        std::printf("%8ld %10ld %12lld %12lld %14.0f %12.1f\n",
+                    batch, toggles, static_cast<long long>(loop.iteration() - startIteration),
+                    static_cast<long long>(toggles - avoided),
+                    static_cast<double>(toggles) / seconds, seconds * 1e9 / static_cast<double>(toggles));
+
+        for (auto &channel : channels)
+        {
+            channel->disableAll();
+            channel->remove();
+        }
+        for (int fd : fds)
+        {
+            ::close(fd);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const long toggles = argc > 1 ? std::atol(argv[1]) : 1000000;
+    const int numChannels = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+    std::printf("%8s %10s %12s %12s %14s %12s\n",
+                "batch", "toggles", "iterations", "epoll_ctl", "toggles/s", "ns/toggle");
+    for (long batch : {1L, 2L, 16L, 256L})
+    {
+        run(toggles, numChannels, batch);
+    }
+    return 0;
+}
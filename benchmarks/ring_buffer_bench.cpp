@@ -0,0 +1,224 @@
+// 流式输入缓冲区：Buffer（取出后靠搬移未读数据腾出空间）与双重映射的 RingBuffer（只移动下标）对比
+// 用法: ring_buffer_bench [MB] [连接数]，默认 2048、4
+// 负载是 RTSP 交织的 RTP 流：'$' + 通道 + 2 字节长度 + 60~1400 字节载荷，解析器每次只取走完整的帧，
+// 半帧留在缓冲区等下一次读。
+// memory: 同一进程内按固定块大小追加再解析，只统计缓冲区本身；
+// tcp: 客户端进程持续发送，服务端连接分别用消息回调（Buffer）和 setRingInput（RingBuffer）解析，
+// 统计服务端进程每 GB 的 CPU。每种配置在独立子进程中运行
+#include "Buffer.hpp"
+#include "EventLoop.hpp"
+#include "RingBuffer.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <arpa/inet.h>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double processCpuSeconds()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+               static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    // 约 4 MB 的交织流，循环使用
+    std::string buildStream()
+    {
+        std::mt19937 rng(554);
+        std::uniform_int_distribution<size_t> frameSize(60, 1400);
+        std::string stream;
+        while (stream.size() < 4 * 1024 * 1024)
+        {
+            const size_t len = frameSize(rng);
+            stream += '$';
+            stream += static_cast<char>(stream.size() % 2);
+            stream += static_cast<char>(len >> 8);
+            stream += static_cast<char>(len & 0xff);
+            stream.append(len, 'r');
+        }
+        return stream;
+    }
+
+    // 取走全部完整帧，返回帧数
+    template <typename Input>
+    size_t consumeFrames(Input *buf)
+    {
+        size_t frames = 0;
+        while (buf->readableBytes() >= 4)
+        {
+            const unsigned char *p = reinterpret_cast<const unsigned char *>(buf->peek());
+            const size_t len = 4 + ((static_cast<size_t>(p[2]) << 8) | p[3]);
+            if (buf->readableBytes() < len)
+            {
+                break;
+            }
+            buf->retrieve(len);
+            ++frames;
+        }
+        return frames;
+    }
+
+    template <typename Input>
+    void runMemory(const char *name, Input *buf, const std::string &stream, size_t chunk, size_t totalBytes)
+    {
+        size_t frames = 0;
+        size_t offset = 0;
+        const auto start = Clock::now();
+        for (size_t fed = 0; fed < totalBytes; fed += chunk)
+        {
+            if (offset + chunk > stream.size())
+            {
+                offset = 0; // 流的开头也是帧边界，上一轮的半帧丢弃
+                buf->retrieveAll();
+            }
+            buf->append(stream.data() + offset, chunk);
+            offset += chunk;
+            frames += consumeFrames(buf);
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::printf("memory %-6s chunk %6zu B %7.2f GB/s %8.1f ns/frame\n", name, chunk,
+                    static_cast<double>(totalBytes) / 1e9 / seconds, seconds * 1e9 / static_cast<double>(frames));
+    }
+
+    int connectTo(uint16_t port)
+    {
+        int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        for (int i = 0; i < 100; ++i)
+        {
+            if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+            {
+                return sockfd;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ::close(sockfd);
+        return -1;
+    }
+
+    // 客户端进程：每个连接一个线程，发满 totalBytes / connections 后断开
+    void runClients(uint16_t port, const std::string &stream, int connections, size_t totalBytes)
+    {
+        std::vector<std::thread> senders;
+        for (int i = 0; i < connections; ++i)
+        {
+            senders.emplace_back([&]()
+                                 {
+                int sockfd = connectTo(port);
+                size_t remaining = totalBytes / static_cast<size_t>(connections);
+                while (sockfd >= 0 && remaining > 0)
+                {
+                    const size_t len = std::min(remaining, stream.size());
+                    size_t sent = 0;
+                    while (sent < len)
+                    {
+                        ssize_t n = ::send(sockfd, stream.data() + sent, len - sent, 0);
+                        if (n <= 0)
+                        {
+                            remaining = len; // 出错，结束
+                            break;
+                        }
+                        sent += static_cast<size_t>(n);
+                    }
+                    remaining -= len;
+                }
+                ::close(sockfd); });
+        }
+        for (auto &sender : senders)
+        {
+            sender.join();
+        }
+    }
+
+    void runTcp(bool ring, const std::string &stream, int connections, size_t totalBytes)
+    {
+        const uint16_t port = ring ? 19961 : 19960;
+        net::EventLoop loop;
+        net::TcpServer server(&loop, net::InetAddress(port), "ring");
+        size_t frames = 0;
+        int closed = 0;
+        server.setMessageCallback([&](const net::TcpConnectionPtr &, net::Buffer *buf, base::Timestamp)
+                                  { frames += consumeFrames(buf); });
+        server.setConnectionCallback([&](const net::TcpConnectionPtr &conn)
+                                     {
+                                         if (conn->connected())
+                                         {
+                                             if (ring)
+                                             {
+                                                 conn->setRingInput([&](const net::TcpConnectionPtr &, net::RingBuffer *buf, base::Timestamp)
+                                                                    { frames += consumeFrames(buf); });
+                                             }
+                                         }
+                                         else if (++closed == connections)
+                                         {
+                                             loop.quit();
+                                         } });
+        server.start();
+
+        const double cpuStart = processCpuSeconds();
+        const auto start = Clock::now();
+        pid_t client = ::fork();
+        if (client == 0)
+        {
+            runClients(port, stream, connections, totalBytes);
+            ::_exit(0);
+        }
+        loop.loop();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const double cpu = processCpuSeconds() - cpuStart;
+        ::waitpid(client, nullptr, 0);
+        std::printf("tcp    %-6s %d conns     %7.2f GB/s, server cpu %6.3f s/GB, %zu frames\n", ring ? "ring" : "buffer",
+                    connections, static_cast<double>(totalBytes) / 1e9 / seconds, cpu / (static_cast<double>(totalBytes) / 1e9),
+                    frames);
+        std::fflush(stdout);
+        ::_exit(0);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t totalBytes = static_cast<size_t>(argc > 1 ? std::atoi(argv[1]) : 2048) * 1024 * 1024;
+    const int connections = argc > 2 ? std::atoi(argv[2]) : 4;
+    ::signal(SIGPIPE, SIG_IGN);
+    const std::string stream = buildStream();
+
+    for (size_t chunk : {static_cast<size_t>(1460), static_cast<size_t>(16 * 1024), static_cast<size_t>(60 * 1024)})
+    {
+        net::Buffer buffer(64 * 1024);
+        runMemory("buffer", &buffer, stream, chunk, totalBytes);
+        net::RingBuffer ring(64 * 1024);
+        runMemory("ring", &ring, stream, chunk, totalBytes);
+    }
+    std::fflush(stdout);
+    for (bool ring : {false, true})
+    {
+        pid_t server = ::fork();
+        if (server == 0)
+        {
+            runTcp(ring, stream, connections, totalBytes);
+            ::_exit(0);
+        }
+        ::waitpid(server, nullptr, 0);
+    }
+    return 0;
+}
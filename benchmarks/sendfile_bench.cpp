@@ -0,0 +1,208 @@
+// 文件发送：比较 pread + send 循环与 sendFile（sendfile 系统调用）把同一个文件发给一个客户端
+// 用法: sendfile_bench [文件 MB] [遍数] [read 块 KB]，默认 256、8、256
+// 文件先写好并读过一遍（在页缓存中）；每种方式在独立子进程中运行，客户端在另一个进程中读到 EOF。
+// 统计客户端看到的吞吐与服务端进程 CPU 占用
+#include "EventLoop.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double processCpuSeconds()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+               static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    int connectTo(uint16_t port)
+    {
+        int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        for (int i = 0; i < 100; ++i)
+        {
+            if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+            {
+                return sockfd;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ::close(sockfd);
+        return -1;
+    }
+
+    // 客户端：读到 EOF，把收到的字节数和用时交给父进程
+    void runClient(uint16_t port, int reportFd)
+    {
+        int sockfd = connectTo(port);
+        std::vector<char> buf(256 * 1024);
+        double result[2] = {0, 0};
+        const Clock::time_point start = Clock::now();
+        ssize_t n;
+        while (sockfd >= 0 && (n = ::recv(sockfd, buf.data(), buf.size(), 0)) > 0)
+        {
+            result[0] += static_cast<double>(n);
+        }
+        result[1] = std::chrono::duration<double>(Clock::now() - start).count();
+        ssize_t written = ::write(reportFd, result, sizeof(result));
+        (void)written;
+        ::close(sockfd);
+    }
+
+    // 一个连接的发送进度：每次写完成回调发下一块，全部发完后关闭写端
+    struct Transfer
+    {
+        int fd;
+        size_t fileBytes;
+        size_t chunkBytes;
+        size_t totalBytes;
+        size_t sent = 0;
+        std::vector<char> chunk;
+    };
+
+    void runServer(bool useSendFile, int fd, size_t fileBytes, int passes, size_t chunkBytes)
+    {
+        const uint16_t port = useSendFile ? 19921 : 19920; // 上一轮的连接可能还占着端口
+        net::EventLoop loop;
+        net::TcpServer server(&loop, net::InetAddress(port), "sendfile");
+        Transfer transfer{fd, fileBytes, chunkBytes, fileBytes * static_cast<size_t>(passes), 0, std::vector<char>(chunkBytes)};
+        auto sendNext = [&transfer, useSendFile](const net::TcpConnectionPtr &conn)
+        {
+            if (transfer.sent == transfer.totalBytes)
+            {
+                conn->shutdown();
+                return;
+            }
+            const off_t offset = static_cast<off_t>(transfer.sent % transfer.fileBytes);
+            if (useSendFile)
+            {
+                // 每遍整个文件一次调用
+                transfer.sent += transfer.fileBytes;
+                conn->sendFile(transfer.fd, 0, transfer.fileBytes);
+            }
+            else
+            {
+                const size_t len = std::min(transfer.chunkBytes, transfer.fileBytes - static_cast<size_t>(offset));
+                ssize_t n = ::pread(transfer.fd, transfer.chunk.data(), len, offset);
+                if (n <= 0)
+                {
+                    conn->shutdown();
+                    return;
+                }
+                transfer.sent += static_cast<size_t>(n);
+                conn->send(transfer.chunk.data(), static_cast<size_t>(n));
+            }
+        };
+        server.setConnectionCallback([sendNext](const net::TcpConnectionPtr &conn)
+                                     {
+                                         if (conn->connected())
+                                         {
+                                             sendNext(conn);
+                                         } });
+        server.setWriteCompleteCallback(sendNext);
+        server.start();
+
+        int pipeFds[2];
+        if (::pipe(pipeFds) != 0)
+        {
+            return;
+        }
+        pid_t client = ::fork();
+        if (client == 0)
+        {
+            ::close(pipeFds[0]);
+            runClient(port, pipeFds[1]);
+            ::_exit(0);
+        }
+        ::close(pipeFds[1]);
+
+        double cpuStart = 0;
+        Clock::time_point start;
+        loop.runAfter(0.0, [&]()
+                      {
+                          cpuStart = processCpuSeconds();
+                          start = Clock::now(); });
+        loop.runEvery(0.01, [&]()
+                      {
+                          if (::waitpid(client, nullptr, WNOHANG) == client)
+                          {
+                              loop.quit();
+                          } });
+        loop.loop();
+        const double cpu = processCpuSeconds() - cpuStart;
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        double result[2] = {0, 0};
+        ssize_t n = ::read(pipeFds[0], result, sizeof(result));
+        (void)n;
+        std::printf("%-10s %6.2f GB in %5.2fs: %5.2f GB/s, server cpu %5.1f%%\n",
+                    useSendFile ? "sendFile" : "pread+send", result[0] / 1e9, result[1],
+                    result[1] > 0 ? result[0] / 1e9 / result[1] : 0.0, cpu * 100 / elapsed);
+        std::fflush(stdout);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t fileBytes = static_cast<size_t>(argc > 1 ? std::atoi(argv[1]) : 256) << 20;
+    const int passes = argc > 2 ? std::atoi(argv[2]) : 8;
+    const size_t chunkBytes = static_cast<size_t>(argc > 3 ? std::atoi(argv[3]) : 256) << 10;
+
+    char path[] = "/tmp/sendfile_benchXXXXXX";
+    int fd = ::mkstemp(path);
+    if (fd < 0)
+    {
+        return 1;
+    }
+    ::unlink(path);
+    std::vector<char> block(1 << 20, 'm');
+    for (size_t written = 0; written < fileBytes; written += block.size())
+    {
+        if (::write(fd, block.data(), block.size()) != static_cast<ssize_t>(block.size()))
+        {
+            return 1;
+        }
+    }
+    for (size_t offset = 0; offset < fileBytes; offset += block.size())
+    {
+        if (::pread(fd, block.data(), block.size(), static_cast<off_t>(offset)) <= 0)
+        {
+            return 1;
+        }
+    }
+    std::printf("%zu MB file x %d passes, pread chunk %zu KB\n", fileBytes >> 20, passes, chunkBytes >> 10);
+    std::fflush(stdout);
+
+    for (bool useSendFile : {false, true})
+    {
+        pid_t server = ::fork();
+        if (server == 0)
+        {
+            runServer(useSendFile, fd, fileBytes, passes, chunkBytes);
+            ::_exit(0);
+        }
+        ::waitpid(server, nullptr, 0);
+    }
+    ::close(fd);
+    return 0;
+}
@@ -0,0 +1,146 @@
+// 回环吞吐：水平触发 vs 边沿触发
+// 用法: tcp_throughput_bench [每种模式传输的 MiB 数]，默认 1024
+// rx: 客户端持续发送，服务端只读不回；tx: 服务端持续发送，客户端只读
+// 统计服务端 loop 的 epoll_wait 轮数与读/写回调次数，换算为每 GiB 的开销
+#include "EventLoop.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    int connectLoopback(uint16_t port)
+    {
+        int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        for (int i = 0; i < 100; ++i)
+        {
+            if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+            {
+                return sockfd;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ::close(sockfd);
+        return -1;
+    }
+
+    void run(const char *direction, bool edgeTriggered, size_t totalBytes, uint16_t port)
+    {
+        const bool rx = std::strcmp(direction, "rx") == 0;
+        size_t transferred = 0;
+        long callbacks = 0;
+        int64_t iterations = 0;
+        double seconds = 0;
+        const std::string chunk(1024 * 1024, 'x');
+        std::atomic<bool> stop(false);
+        std::thread client;
+
+        net::EventLoop loop;
+        {
+            net::InetAddress listenAddr(port);
+            net::TcpServer server(&loop, listenAddr, "bench");
+            server.setEdgeTriggered(edgeTriggered);
+
+            server.setMessageCallback([&](const net::TcpConnectionPtr &, net::Buffer *buf, base::Timestamp)
+                                      {
+                                          ++callbacks;
+                                          transferred += buf->readableBytes();
+                                          buf->retrieveAll();
+                                          if (transferred >= totalBytes)
+                                          {
+                                              loop.quit();
+                                          } });
+            server.setWriteCompleteCallback([&](const net::TcpConnectionPtr &conn)
+                                            {
+                                                ++callbacks;
+                                                transferred += chunk.size();
+                                                if (transferred >= totalBytes)
+                                                {
+                                                    loop.quit();
+                                                }
+                                                else
+                                                {
+                                                    conn->send(chunk);
+                                                } });
+            server.setConnectionCallback([&](const net::TcpConnectionPtr &conn)
+                                         {
+                                             if (conn->connected() && !rx)
+                                             {
+                                                 conn->send(chunk);
+                                             } });
+            server.start();
+
+            client = std::thread([&]()
+                               {
+                int sockfd = connectLoopback(port);
+                if (sockfd < 0)
+                {
+                    return;
+                }
+                // 收发超时用于检查 stop：结束时服务端不再读写，连接也可能被排队任务延后释放
+                timeval timeout = {0, 100 * 1000};
+                ::setsockopt(sockfd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                ::setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                std::vector<char> buf(256 * 1024);
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    ssize_t n = rx ? ::send(sockfd, buf.data(), buf.size(), MSG_NOSIGNAL)
+                                   : ::recv(sockfd, buf.data(), buf.size(), 0);
+                    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+                    {
+                        break;
+                    }
+                }
+                ::close(sockfd); });
+
+            const int64_t startIteration = loop.iteration();
+            auto start = Clock::now();
+            loop.loop();
+            seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            iterations = loop.iteration() - startIteration;
+            stop = true;
+        }
+        client.join();
+
+        const double gib = static_cast<double>(transferred) / (1024.0 * 1024.0 * 1024.0);
+        std::printf("%-4s %-6s %10.2f %14.0f %14.0f %10.2f\n",
+                    direction, edgeTriggered ? "ET" : "LT", gib,
+                    static_cast<double>(iterations) / gib, static_cast<double>(callbacks) / gib,
+                    gib / seconds);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t mib = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 1024;
+    const size_t totalBytes = mib * 1024 * 1024;
+
+    std::printf("%-4s %-6s %10s %14s %14s %10s\n",
+                "dir", "mode", "GiB", "polls/GiB", "callbacks/GiB", "GiB/s");
+    uint16_t port = 19100;
+    for (const char *direction : {"rx", "tx"})
+    {
+        run(direction, false, totalBytes, port++);
+        run(direction, true, totalBytes, port++);
+    }
+    return 0;
+}
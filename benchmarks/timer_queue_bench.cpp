@@ -0,0 +1,109 @@
+// 定时器后端对比：二叉堆 TimerQueue vs 分层时间轮 TimingWheel
+// 用法: timer_queue_bench [定时器数量...]，默认 10000 100000 1000000
+// 使用虚拟时间驱动，只统计数据结构本身的开销
+#include "Timer.hpp"
+#include "TimingWheel.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double nsPerOp(Clock::time_point start, size_t ops)
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        return ops == 0 ? 0.0 : static_cast<double>(ns) / static_cast<double>(ops);
+    }
+
+    base::Timestamp at(const base::Timestamp &origin, int64_t ms)
+    {
+        return base::Timestamp(origin.microSecondsSinceEpoch() + ms * 1000);
+    }
+
+    void runBackend(const char *name, base::TimerQueueBase &queue, const base::Timestamp &origin, size_t count)
+    {
+        std::mt19937 rng(12345);
+        std::uniform_int_distribution<int64_t> delay(1000, 60000); // 1s ~ 60s 的空闲超时
+        size_t fired = 0;
+        std::vector<base::TimerId> ids;
+        ids.reserve(count);
+
+        auto start = Clock::now();
+        for (size_t i = 0; i < count; ++i)
+        {
+            ids.push_back(queue.addTimer([&fired]()
+                                         { ++fired; }, at(origin, delay(rng)), 0));
+        }
+        double insertNs = nsPerOp(start, count);
+
+        // 堆的 reset/cancel 是 O(n)，限制操作次数以免百万级时跑不完
+        const size_t ops = std::min<size_t>(count / 10, 100);
+        std::uniform_int_distribution<size_t> pick(0, count - 1);
+
+        start = Clock::now();
+        for (size_t i = 0; i < ops; ++i)
+        {
+            queue.reset(ids[pick(rng)], at(origin, delay(rng)));
+        }
+        double resetNs = nsPerOp(start, ops);
+
+        start = Clock::now();
+        size_t cancelled = 0;
+        for (size_t i = 0; i < ops; ++i)
+        {
+            size_t index = pick(rng);
+            if (ids[index].isValid())
+            {
+                queue.cancel(ids[index]);
+                ids[index] = base::TimerId();
+                ++cancelled;
+            }
+        }
+        double cancelNs = nsPerOp(start, cancelled);
+
+        // 以 1ms 步长推进虚拟时间直到全部到期
+        start = Clock::now();
+        for (int64_t ms = 0; ms <= 61000; ++ms)
+        {
+            queue.handleExpiredTimers(at(origin, ms));
+        }
+        double expireNs = nsPerOp(start, fired);
+
+        std::printf("%-12s %9zu %12.1f %12.1f %12.1f %12.1f %10zu\n",
+                    name, count, insertNs, resetNs, cancelNs, expireNs, fired);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; ++i)
+    {
+        counts.push_back(static_cast<size_t>(std::strtoull(argv[i], nullptr, 10)));
+    }
+    if (counts.empty())
+    {
+        counts = {10000, 100000, 1000000};
+    }
+
+    std::printf("%-12s %9s %12s %12s %12s %12s %10s\n",
+                "backend", "timers", "insert(ns)", "reset(ns)", "cancel(ns)", "expire(ns)", "fired");
+    for (size_t count : counts)
+    {
+        base::Timestamp origin(1000000);
+        {
+            base::TimerQueue heap;
+            runBackend("heap", heap, origin, count);
+        }
+        {
+            base::TimingWheel wheel(0.001, origin);
+            runBackend("wheel", wheel, origin, count);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,215 @@
+// 计算线程池：fork/join 递归，以及 IO 与计算混跑时把计算移出 loop 对回显延迟的影响
+// 用法: work_stealing_bench [计算线程数] [fib 参数] [混跑秒数]，默认硬件线程数、32、2
+// 混跑：同一个 loop 上有若干交互连接（64 字节回显，记录往返时间）和一个“计算”连接，
+// 后者每条消息触发约 2ms 的计算；分别在 loop 内直接计算和用 runOffLoop 移到线程池中计算
+#include "EventLoop.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    long fibSerial(int n)
+    {
+        return n < 2 ? n : fibSerial(n - 1) + fibSerial(n - 2);
+    }
+
+    long fibParallel(base::WorkStealingPool &pool, int n)
+    {
+        if (n < 20)
+        {
+            return fibSerial(n);
+        }
+        std::atomic<bool> done(false);
+        long left = 0;
+        pool.submit([&pool, &done, &left, n]()
+                    {
+                        left = fibParallel(pool, n - 1);
+                        done.store(true, std::memory_order_release); });
+        long right = fibParallel(pool, n - 2);
+        while (!done.load(std::memory_order_acquire))
+        {
+            if (!pool.tryRunOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+        return left + right;
+    }
+
+    volatile uint64_t gSink; // 防止计算被优化掉
+
+    // 约 2ms 的纯计算，模拟解析大 SDP / 建 GOP 索引
+    void burnCpu()
+    {
+        uint64_t h = 1469598103934665603ull;
+        for (int i = 0; i < 2000000; ++i)
+        {
+            h = (h ^ static_cast<uint64_t>(i)) * 1099511628211ull;
+        }
+        gSink = h;
+    }
+
+    int connectLoopback(uint16_t port)
+    {
+        int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        for (int i = 0; i < 100; ++i)
+        {
+            if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+            {
+                return sockfd;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ::close(sockfd);
+        return -1;
+    }
+
+    // 阻塞地发送一条消息并等待完整回显，返回往返微秒数，失败返回负数
+    double roundTrip(int sockfd, char *buf, size_t len)
+    {
+        const Clock::time_point start = Clock::now();
+        if (::send(sockfd, buf, len, MSG_NOSIGNAL) != static_cast<ssize_t>(len))
+        {
+            return -1;
+        }
+        size_t got = 0;
+        while (got < len)
+        {
+            ssize_t n = ::recv(sockfd, buf + got, len - got, 0);
+            if (n <= 0)
+            {
+                return -1;
+            }
+            got += static_cast<size_t>(n);
+        }
+        return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    }
+
+    void runMixed(bool offload, base::WorkStealingPool &pool, double seconds, uint16_t port)
+    {
+        const int kInteractive = 4;
+        std::mutex mutex;
+        std::vector<double> rtts;
+        net::EventLoop loop;
+        loop.setComputePool(&pool);
+        net::InetAddress listenAddr(port);
+        net::TcpServer server(&loop, listenAddr, "mixed");
+        server.setMessageCallback([&](const net::TcpConnectionPtr &conn, net::Buffer *buf, base::Timestamp)
+                                  {
+                                      if (buf->peek()[0] != 'C')
+                                      {
+                                          conn->send(buf);
+                                          return;
+                                      }
+                                      buf->retrieveAll();
+                                      if (!offload)
+                                      {
+                                          burnCpu();
+                                          conn->send("C");
+                                          return;
+                                      }
+                                      loop.runOffLoop([]()
+                                                      { burnCpu(); },
+                                                      [conn]()
+                                                      { conn->send("C"); }); });
+        server.start();
+
+        const Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+        std::vector<std::thread> clients;
+        clients.emplace_back([&]()
+                             {
+            int sockfd = connectLoopback(port);
+            char c = 'C';
+            while (sockfd >= 0 && Clock::now() < deadline && roundTrip(sockfd, &c, 1) >= 0)
+            {
+                c = 'C';
+            }
+            ::close(sockfd); });
+        for (int i = 0; i < kInteractive; ++i)
+        {
+            clients.emplace_back([&]()
+                                 {
+                int sockfd = connectLoopback(port);
+                std::vector<double> local;
+                char buf[64];
+                std::memset(buf, 'L', sizeof(buf));
+                double rtt;
+                while (sockfd >= 0 && Clock::now() < deadline && (rtt = roundTrip(sockfd, buf, sizeof(buf))) >= 0)
+                {
+                    local.push_back(rtt);
+                    std::this_thread::sleep_for(std::chrono::microseconds(500));
+                }
+                ::close(sockfd);
+                std::lock_guard<std::mutex> lock(mutex);
+                rtts.insert(rtts.end(), local.begin(), local.end()); });
+        }
+        std::thread stopper([&]()
+                            {
+            std::this_thread::sleep_until(deadline + std::chrono::milliseconds(100));
+            loop.runInLoop([&loop]()
+                           { loop.quit(); }); });
+        loop.loop();
+        stopper.join();
+        for (auto &client : clients)
+        {
+            client.join();
+        }
+
+        std::sort(rtts.begin(), rtts.end());
+        if (rtts.empty())
+        {
+            return;
+        }
+        std::printf("mixed %-8s rtt p50 %8.1fus  p99 %8.1fus  max %8.1fus  (%zu samples)\n",
+                    offload ? "offload" : "inline", rtts[rtts.size() / 2], rtts[rtts.size() * 99 / 100],
+                    rtts.back(), rtts.size());
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int threads = argc > 1 ? std::atoi(argv[1]) : 0;
+    const int n = argc > 2 ? std::atoi(argv[2]) : 32;
+    const double seconds = argc > 3 ? std::atof(argv[3]) : 2.0;
+
+    base::WorkStealingPool pool(threads, "bench");
+
+    Clock::time_point start = Clock::now();
+    long serial = fibSerial(n);
+    const double serialMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    std::promise<long> result;
+    pool.submit([&pool, &result, n]()
+                { result.set_value(fibParallel(pool, n)); });
+    long parallel = result.get_future().get();
+    const double parallelMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::printf("fib(%d) serial %.1fms, pool(%d threads) %.1fms, speedup %.2fx, stolen %ld%s\n",
+                n, serialMs, pool.numThreads(), parallelMs, serialMs / parallelMs,
+                static_cast<long>(pool.stolen()), serial == parallel ? "" : " MISMATCH");
+
+    runMixed(false, pool, seconds, 19400);
+    runMixed(true, pool, seconds, 19401);
+    return 0;
+}
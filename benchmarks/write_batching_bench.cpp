@@ -0,0 +1,247 @@
+// 批量写：媒体回调逐个 RTP 包调用 send，比较立即写、本轮结束合并写、合并写 + MSG_MORE
+// 用法: write_batching_bench [连接数] [每帧包数] [秒数]，默认 50、30、3
+// 客户端每个连接发 1 字节请求一帧，服务端逐包 send（交织头 + 60~1400 字节载荷），一帧分两轮 loop 交出；
+// 客户端收齐一帧再请求下一帧。MSG_MORE 模式下前一半的尾部留在内核，帧末调用 flush() 推出。
+// 统计帧率、服务端每帧 CPU，以及客户端每帧 recv 次数（反映到达的小段数量）。每种配置在独立子进程中运行
+#include "EventLoop.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <arpa/inet.h>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    enum class Mode
+    {
+        kImmediate,
+        kBatch,
+        kBatchMore,
+    };
+
+    const char *modeName(Mode mode)
+    {
+        switch (mode)
+        {
+        case Mode::kImmediate:
+            return "immediate";
+        case Mode::kBatch:
+            return "batch";
+        case Mode::kBatchMore:
+            return "batch+more";
+        }
+        return "";
+    }
+
+    double processCpuSeconds()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+               static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    int connectTo(uint16_t port)
+    {
+        int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        for (int i = 0; i < 100; ++i)
+        {
+            if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+            {
+                return sockfd;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ::close(sockfd);
+        return -1;
+    }
+
+    // 一帧的各个包，所有连接共用
+    std::vector<std::string> buildFrame(int packets)
+    {
+        std::mt19937 rng(554);
+        std::uniform_int_distribution<size_t> payload(60, 1400);
+        std::vector<std::string> frame;
+        for (int i = 0; i < packets; ++i)
+        {
+            const size_t len = payload(rng);
+            std::string packet("$\0", 2);
+            packet += static_cast<char>(len >> 8);
+            packet += static_cast<char>(len & 0xff);
+            packet.append(len, 'v');
+            frame.push_back(std::move(packet));
+        }
+        return frame;
+    }
+
+    // 客户端进程：单线程 poll 所有连接，每收齐一帧就请求下一帧，到时间后报告帧数与 recv 次数
+    void runClients(uint16_t port, int connections, size_t frameBytes, double seconds, int reportFd)
+    {
+        std::vector<int> sockets;
+        std::vector<size_t> pending(static_cast<size_t>(connections), 0);
+        for (int i = 0; i < connections; ++i)
+        {
+            sockets.push_back(connectTo(port));
+        }
+        long frames = 0;
+        long recvCalls = 0;
+        std::vector<char> buf(256 * 1024);
+        std::vector<pollfd> fds;
+        for (int sockfd : sockets)
+        {
+            fds.push_back(pollfd{sockfd, POLLIN, 0});
+            ::send(sockfd, "f", 1, 0);
+        }
+        const Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+        while (Clock::now() < deadline)
+        {
+            if (::poll(fds.data(), fds.size(), 100) <= 0)
+            {
+                continue;
+            }
+            for (size_t i = 0; i < fds.size(); ++i)
+            {
+                if ((fds[i].revents & POLLIN) == 0)
+                {
+                    continue;
+                }
+                ssize_t n = ::recv(fds[i].fd, buf.data(), buf.size(), 0);
+                ++recvCalls;
+                if (n <= 0)
+                {
+                    fds[i].fd = -1;
+                    continue;
+                }
+                pending[i] += static_cast<size_t>(n);
+                if (pending[i] >= frameBytes)
+                {
+                    pending[i] -= frameBytes;
+                    ++frames;
+                    ::send(fds[i].fd, "f", 1, 0);
+                }
+            }
+        }
+        long report[2] = {frames, recvCalls};
+        ssize_t n = ::write(reportFd, report, sizeof(report));
+        (void)n;
+    }
+
+    void runServer(Mode mode, uint16_t port, int connections, int packets, double seconds)
+    {
+        const std::vector<std::string> frame = buildFrame(packets);
+        size_t frameBytes = 0;
+        for (const std::string &packet : frame)
+        {
+            frameBytes += packet.size();
+        }
+        net::EventLoop loop;
+        net::TcpServer server(&loop, net::InetAddress(port), "batch");
+        server.setConnectionCallback([mode](const net::TcpConnectionPtr &conn)
+                                     {
+                                         if (conn->connected())
+                                         {
+                                             conn->setTcpNoDelay(true); // 媒体连接通常关闭 Nagle
+                                             if (mode != Mode::kImmediate)
+                                             {
+                                                 conn->setWriteBatching(true, mode == Mode::kBatchMore);
+                                             }
+                                         } });
+        // 打包器把一帧分两轮交出：前一半在消息回调里，后一半在下一轮的定时器回调里
+        auto sendPackets = [&frame](const net::TcpConnectionPtr &conn, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                conn->send(frame[i].data(), frame[i].size());
+            }
+        };
+        server.setMessageCallback([&](const net::TcpConnectionPtr &conn, net::Buffer *buf, base::Timestamp)
+                                  {
+                                      for (size_t requests = buf->readableBytes(); requests > 0; --requests)
+                                      {
+                                          sendPackets(conn, 0, frame.size() / 2);
+                                          loop.runAfter(0.0, [&, conn]()
+                                                        {
+                                                            sendPackets(conn, frame.size() / 2, frame.size());
+                                                            if (mode == Mode::kBatchMore)
+                                                            {
+                                                                conn->flush(); // 帧结束，推出 MSG_MORE 留下的尾部
+                                                            } });
+                                      }
+                                      buf->retrieveAll(); });
+        server.start();
+
+        int pipeFds[2];
+        if (::pipe(pipeFds) != 0)
+        {
+            return;
+        }
+        const double cpuStart = processCpuSeconds();
+        pid_t client = ::fork();
+        if (client == 0)
+        {
+            ::close(pipeFds[0]);
+            runClients(port, connections, frameBytes, seconds, pipeFds[1]);
+            ::_exit(0);
+        }
+        ::close(pipeFds[1]);
+        loop.runEvery(0.01, [&]()
+                      {
+                          if (::waitpid(client, nullptr, WNOHANG) == client)
+                          {
+                              loop.quit();
+                          } });
+        loop.loop();
+        const double cpu = processCpuSeconds() - cpuStart;
+
+        long report[2] = {0, 0};
+        ssize_t n = ::read(pipeFds[0], report, sizeof(report));
+        (void)n;
+        const double frames = static_cast<double>(std::max(report[0], 1L));
+        std::printf("%-10s %9.0f frames/s, server cpu %6.2f us/frame, client %5.2f recv/frame\n", modeName(mode),
+                    frames / seconds, cpu * 1e6 / frames, static_cast<double>(report[1]) / frames);
+        std::fflush(stdout);
+        ::_exit(0); // 客户端已退出，不等连接逐个关闭
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int connections = argc > 1 ? std::atoi(argv[1]) : 50;
+    const int packets = argc > 2 ? std::atoi(argv[2]) : 30;
+    const double seconds = argc > 3 ? std::atof(argv[3]) : 3.0;
+    ::signal(SIGPIPE, SIG_IGN); // 客户端到时间直接断开，服务端可能还在写
+    std::printf("%d connections, %d packets per frame, %.1fs\n", connections, packets, seconds);
+    std::fflush(stdout);
+    uint16_t port = 19970;
+    for (Mode mode : {Mode::kImmediate, Mode::kBatch, Mode::kBatchMore})
+    {
+        const uint16_t modePort = port++;
+        pid_t server = ::fork();
+        if (server == 0)
+        {
+            runServer(mode, modePort, connections, packets, seconds);
+            ::_exit(0);
+        }
+        ::waitpid(server, nullptr, 0);
+    }
+    return 0;
+}
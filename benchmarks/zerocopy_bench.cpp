@@ -0,0 +1,174 @@
+// 大帧零拷贝：比较拷贝发送与 MSG_ZEROCOPY 发送大的关键帧
+// 用法: zerocopy_bench [连接数] [秒数] [帧 KB]，默认 4、3、512
+// 每个连接写完一帧就发下一帧（同一个 SharedSlice）；每种方式在独立子进程中运行，客户端在另一个进程中读。
+// 统计客户端吞吐、服务端进程 CPU，以及内核确认的零拷贝字节与退回拷贝字节。
+// 注意回环上内核总是退回拷贝（完成通知带 COPIED 标志），连接收到这样的通知后自动回到拷贝发送
+#include "EventLoop.hpp"
+#include "SharedSlice.hpp"
+#include "TcpConnection.hpp"
+#include "TcpServer.hpp"
+#include <arpa/inet.h>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double processCpuSeconds()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+               static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    int connectTo(uint16_t port)
+    {
+        int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        for (int i = 0; i < 100; ++i)
+        {
+            if (::connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+            {
+                return sockfd;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ::close(sockfd);
+        return -1;
+    }
+
+    // 客户端进程：每个连接一个线程读到截止时间，把总字节数交给父进程
+    void runClients(uint16_t port, int connections, double seconds, int reportFd)
+    {
+        std::vector<std::thread> readers;
+        std::vector<long> received(static_cast<size_t>(connections), 0);
+        const Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+        for (int i = 0; i < connections; ++i)
+        {
+            readers.emplace_back([&, i]()
+                                 {
+                int sockfd = connectTo(port);
+                std::vector<char> buf(256 * 1024);
+                while (sockfd >= 0 && Clock::now() < deadline)
+                {
+                    ssize_t n = ::recv(sockfd, buf.data(), buf.size(), 0);
+                    if (n <= 0)
+                    {
+                        break;
+                    }
+                    received[static_cast<size_t>(i)] += n;
+                } });
+        }
+        for (auto &reader : readers)
+        {
+            reader.join();
+        }
+        long total = 0;
+        for (long n : received)
+        {
+            total += n;
+        }
+        ssize_t n = ::write(reportFd, &total, sizeof(total));
+        (void)n;
+    }
+
+    void runServer(bool zeroCopy, int connections, double seconds, size_t frameBytes)
+    {
+        const uint16_t port = zeroCopy ? 19931 : 19930; // 上一轮被中断的连接可能还占着端口
+        net::EventLoop loop;
+        net::TcpServer server(&loop, net::InetAddress(port), "zerocopy");
+        const net::SharedSlice frame(std::string(frameBytes, 'k'));
+        bool zeroCopyOk = true;
+        server.setConnectionCallback([&](const net::TcpConnectionPtr &conn)
+                                     {
+                                         if (conn->connected())
+                                         {
+                                             if (zeroCopy)
+                                             {
+                                                 zeroCopyOk = conn->setZeroCopy() && zeroCopyOk;
+                                             }
+                                             conn->send(frame);
+                                         } });
+        server.setWriteCompleteCallback([&frame](const net::TcpConnectionPtr &conn)
+                                        { conn->send(frame); });
+        server.start();
+
+        int pipeFds[2];
+        if (::pipe(pipeFds) != 0)
+        {
+            return;
+        }
+        pid_t client = ::fork();
+        if (client == 0)
+        {
+            ::close(pipeFds[0]);
+            runClients(port, connections, seconds, pipeFds[1]);
+            ::_exit(0);
+        }
+        ::close(pipeFds[1]);
+
+        double cpuStart = 0;
+        Clock::time_point start;
+        loop.runAfter(0.0, [&]()
+                      {
+                          cpuStart = processCpuSeconds();
+                          start = Clock::now(); });
+        loop.runEvery(0.01, [&]()
+                      {
+                          if (::waitpid(client, nullptr, WNOHANG) == client)
+                          {
+                              loop.quit();
+                          } });
+        loop.loop();
+        const double cpu = processCpuSeconds() - cpuStart;
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        long received = 0;
+        ssize_t n = ::read(pipeFds[0], &received, sizeof(received));
+        (void)n;
+        const net::EventLoopStats stats = loop.stats();
+        std::printf("%-8s %5.2f GB/s, server cpu %5.1f%%, zero-copy confirmed %.2f GB (copied back %.2f GB)%s\n",
+                    zeroCopy ? "zerocopy" : "copy", static_cast<double>(received) / 1e9 / elapsed, cpu * 100 / elapsed,
+                    static_cast<double>(stats.zeroCopyBytes) / 1e9, static_cast<double>(stats.zeroCopyCopiedBytes) / 1e9,
+                    zeroCopyOk ? "" : " [SO_ZEROCOPY unsupported]");
+        std::fflush(stdout);
+        ::_exit(0); // 客户端已退出，不等连接逐个关闭
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int connections = argc > 1 ? std::atoi(argv[1]) : 4;
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 3.0;
+    const size_t frameBytes = static_cast<size_t>(argc > 3 ? std::atoi(argv[3]) : 512) * 1024;
+    ::signal(SIGPIPE, SIG_IGN); // 客户端到时间直接断开，服务端可能还在写
+    std::printf("%d connections, %zu KB frames, %.1fs\n", connections, frameBytes / 1024, seconds);
+    std::fflush(stdout);
+    for (bool zeroCopy : {false, true})
+    {
+        pid_t server = ::fork();
+        if (server == 0)
+        {
+            runServer(zeroCopy, connections, seconds, frameBytes);
+            ::_exit(0);
+        }
+        ::waitpid(server, nullptr, 0);
+    }
+    return 0;
+}
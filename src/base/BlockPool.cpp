@@ -0,0 +1,107 @@
+#include "BlockPool.hpp"
+
+namespace base
+{
+    namespace
+    {
+        const size_t kBlockAlign = alignof(std::max_align_t);
+
+        size_t roundUp(size_t size)
+        {
+            return (size + kBlockAlign - 1) / kBlockAlign * kBlockAlign;
+        }
+    }
+
+    BlockPool::BlockPool(size_t blocksPerChunk)
+        : blocksPerChunk_(blocksPerChunk > 0 ? blocksPerChunk : kDefaultBlocksPerChunk),
+          blockSize_(0),
+          freeList_(nullptr),
+          blocksInUse_(0)
+    {
+    }
+
+    BlockPool::~BlockPool()
+    {
+        // 仍有块未归还（对象比池活得久）时不释放 chunk，宁可泄漏也不让对象落在已释放的内存上
+        if (blocksInUse_ > 0)
+        {
+            return;
+        }
+        for (void *chunk : chunks_)
+        {
+            ::operator delete(chunk);
+        }
+    }
+
+    void *BlockPool::allocate(size_t size)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (blockSize_ == 0)
+        {
+            blockSize_ = roundUp(size < sizeof(FreeBlock) ? sizeof(FreeBlock) : size);
+        }
+        if (roundUp(size) != blockSize_)
+        {
+            return ::operator new(size);
+        }
+        if (freeList_ == nullptr)
+        {
+            grow();
+        }
+        FreeBlock *block = freeList_;
+        freeList_ = block->next;
+        ++blocksInUse_;
+        return block;
+    }
+
+    void BlockPool::deallocate(void *block, size_t size)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (roundUp(size) != blockSize_)
+        {
+            ::operator delete(block);
+            return;
+        }
+        FreeBlock *node = static_cast<FreeBlock *>(block);
+        node->next = freeList_;
+        freeList_ = node;
+        --blocksInUse_;
+    }
+
+    void BlockPool::grow()
+    {
+        char *chunk = static_cast<char *>(::operator new(blockSize_ * blocksPerChunk_));
+        chunks_.push_back(chunk);
+        // 倒序入链，分配时按地址递增取出
+        for (size_t i = blocksPerChunk_; i > 0; --i)
+        {
+            FreeBlock *node = reinterpret_cast<FreeBlock *>(chunk + (i - 1) * blockSize_);
+            node->next = freeList_;
+            freeList_ = node;
+        }
+    }
+
+    size_t BlockPool::blockSize() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return blockSize_;
+    }
+
+    size_t BlockPool::blocksInUse() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return blocksInUse_;
+    }
+
+    size_t BlockPool::chunkCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return chunks_.size();
+    }
+
+    size_t BlockPool::reservedBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return chunks_.size() * blocksPerChunk_ * blockSize_;
+    }
+}
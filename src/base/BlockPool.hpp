@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "Noncopyable.hpp"
+
+namespace base
+{
+    // 定长块内存池：按 chunk 批量向系统申请，块释放后挂回空闲链表复用，chunk 到池析构时才归还。
+    // 块大小由第一次分配决定（同一池只放一种对象），之后大小不符的请求直接走 operator new。
+    // 分配与释放可以在不同线程（如 baseLoop 接受连接、IO loop 销毁连接），由互斥锁保护
+    class BlockPool : Noncopyable
+    {
+    public:
+        static const size_t kDefaultBlocksPerChunk = 64;
+
+        explicit BlockPool(size_t blocksPerChunk = kDefaultBlocksPerChunk);
+        ~BlockPool();
+
+        void *allocate(size_t size);
+        void deallocate(void *block, size_t size);
+
+        size_t blockSize() const;
+        size_t blocksInUse() const;
+        size_t chunkCount() const;
+        // 已向系统申请、由池持有的总字节数
+        size_t reservedBytes() const;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock *next;
+        };
+        void grow();
+
+        const size_t blocksPerChunk_;
+        mutable std::mutex mutex_;
+        size_t blockSize_; // 0 表示尚未确定
+        FreeBlock *freeList_;
+        size_t blocksInUse_;
+        std::vector<void *> chunks_;
+    };
+
+    // 把 BlockPool 适配成标准分配器，供 std::allocate_shared 把控制块和对象放进同一个块
+    template <typename T>
+    class PoolAllocator
+    {
+    public:
+        using value_type = T;
+
+        explicit PoolAllocator(BlockPool *pool) : pool_(pool) {}
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U> &other) : pool_(other.pool()) {}
+
+        T *allocate(size_t n) { return static_cast<T *>(pool_->allocate(n * sizeof(T))); }
+        void deallocate(T *p, size_t n) { pool_->deallocate(p, n * sizeof(T)); }
+
+        BlockPool *pool() const { return pool_; }
+
+        template <typename U>
+        bool operator==(const PoolAllocator<U> &other) const { return pool_ == other.pool(); }
+        template <typename U>
+        bool operator!=(const PoolAllocator<U> &other) const { return pool_ != other.pool(); }
+
+    private:
+        BlockPool *pool_;
+    };
+}
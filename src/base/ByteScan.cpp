@@ -0,0 +1,247 @@
+#include "ByteScan.hpp"
+#include <algorithm>
+#include <cstring>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace base
+{
+    namespace scan
+    {
+        namespace
+        {
+            const char *findByteOrEnd(const char *begin, const char *end, char c)
+            {
+                const void *hit = std::memchr(begin, c, static_cast<size_t>(end - begin));
+                return hit ? static_cast<const char *>(hit) : end;
+            }
+
+            const char *findCRLFScalar(const char *begin, const char *end)
+            {
+                for (const char *p = begin; end - p >= 2; ++p)
+                {
+                    p = findByteOrEnd(p, end - 1, '\r');
+                    if (p == end - 1)
+                    {
+                        break;
+                    }
+                    if (p[1] == '\n')
+                    {
+                        return p;
+                    }
+                }
+                return end;
+            }
+
+            const char *findCRLFCRLFScalar(const char *begin, const char *end)
+            {
+                for (const char *p = begin; end - p >= 4; ++p)
+                {
+                    p = findCRLFScalar(p, end - 2);
+                    if (p == end - 2)
+                    {
+                        break;
+                    }
+                    if (p[2] == '\r' && p[3] == '\n')
+                    {
+                        return p;
+                    }
+                }
+                return end;
+            }
+
+            const char *findAnyOfScalar(const char *begin, const char *end, const char *set, size_t setSize)
+            {
+                return std::find_first_of(begin, end, set, set + setSize);
+            }
+
+#if defined(__x86_64__)
+            // 向量实现：一次比较 16 / 32 个位置，多字节模式用错位加载后的比较结果相与；
+            // 不足一个向量的尾部交给下一级实现。SSE2 版本强制内联进 AVX2 版本，按 VEX 编码生成，
+            // 避免 AVX 与传统 SSE 指令切换的开销（短行上实测慢 3 倍）
+
+            inline __attribute__((always_inline)) const char *findCRLFSse2(const char *p, const char *end)
+            {
+                const __m128i cr = _mm_set1_epi8('\r');
+                const __m128i lf = _mm_set1_epi8('\n');
+                while (end - p >= 17)
+                {
+                    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 1));
+                    const int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, cr), _mm_cmpeq_epi8(b, lf)));
+                    if (mask != 0)
+                    {
+                        return p + __builtin_ctz(static_cast<unsigned>(mask));
+                    }
+                    p += 16;
+                }
+                return findCRLFScalar(p, end);
+            }
+
+            inline __attribute__((always_inline)) const char *findCRLFCRLFSse2(const char *p, const char *end)
+            {
+                const __m128i cr = _mm_set1_epi8('\r');
+                const __m128i lf = _mm_set1_epi8('\n');
+                while (end - p >= 19)
+                {
+                    const __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), cr);
+                    const __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 1)), lf);
+                    const __m128i c = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 2)), cr);
+                    const __m128i d = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 3)), lf);
+                    const int mask = _mm_movemask_epi8(_mm_and_si128(_mm_and_si128(a, b), _mm_and_si128(c, d)));
+                    if (mask != 0)
+                    {
+                        return p + __builtin_ctz(static_cast<unsigned>(mask));
+                    }
+                    p += 16;
+                }
+                return findCRLFCRLFScalar(p, end);
+            }
+
+            inline __attribute__((always_inline)) const char *findAnyOfSse2(const char *p, const char *end, const char *set, size_t setSize)
+            {
+                if (setSize == 0 || setSize > kMaxSetSize)
+                {
+                    return findAnyOfScalar(p, end, set, setSize);
+                }
+                __m128i needles[kMaxSetSize];
+                for (size_t i = 0; i < setSize; ++i)
+                {
+                    needles[i] = _mm_set1_epi8(set[i]);
+                }
+                while (end - p >= 16)
+                {
+                    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                    __m128i hit = _mm_cmpeq_epi8(v, needles[0]);
+                    for (size_t i = 1; i < setSize; ++i)
+                    {
+                        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, needles[i]));
+                    }
+                    const int mask = _mm_movemask_epi8(hit);
+                    if (mask != 0)
+                    {
+                        return p + __builtin_ctz(static_cast<unsigned>(mask));
+                    }
+                    p += 16;
+                }
+                return findAnyOfScalar(p, end, set, setSize);
+            }
+
+            __attribute__((target("avx2"))) const char *findCRLFAvx2(const char *p, const char *end)
+            {
+                const __m256i cr = _mm256_set1_epi8('\r');
+                const __m256i lf = _mm256_set1_epi8('\n');
+                while (end - p >= 33)
+                {
+                    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 1));
+                    const unsigned mask = static_cast<unsigned>(
+                        _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, cr), _mm256_cmpeq_epi8(b, lf))));
+                    if (mask != 0)
+                    {
+                        return p + __builtin_ctz(mask);
+                    }
+                    p += 32;
+                }
+                return findCRLFSse2(p, end);
+            }
+
+            __attribute__((target("avx2"))) const char *findCRLFCRLFAvx2(const char *p, const char *end)
+            {
+                const __m256i cr = _mm256_set1_epi8('\r');
+                const __m256i lf = _mm256_set1_epi8('\n');
+                while (end - p >= 35)
+                {
+                    const __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), cr);
+                    const __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 1)), lf);
+                    const __m256i c = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 2)), cr);
+                    const __m256i d = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 3)), lf);
+                    const unsigned mask = static_cast<unsigned>(
+                        _mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, d))));
+                    if (mask != 0)
+                    {
+                        return p + __builtin_ctz(mask);
+                    }
+                    p += 32;
+                }
+                return findCRLFCRLFSse2(p, end);
+            }
+
+            __attribute__((target("avx2"))) const char *findAnyOfAvx2(const char *p, const char *end, const char *set, size_t setSize)
+            {
+                if (setSize == 0 || setSize > kMaxSetSize)
+                {
+                    return findAnyOfScalar(p, end, set, setSize);
+                }
+                __m256i needles[kMaxSetSize];
+                for (size_t i = 0; i < setSize; ++i)
+                {
+                    needles[i] = _mm256_set1_epi8(set[i]);
+                }
+                while (end - p >= 32)
+                {
+                    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                    __m256i hit = _mm256_cmpeq_epi8(v, needles[0]);
+                    for (size_t i = 1; i < setSize; ++i)
+                    {
+                        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, needles[i]));
+                    }
+                    const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+                    if (mask != 0)
+                    {
+                        return p + __builtin_ctz(mask);
+                    }
+                    p += 32;
+                }
+                return findAnyOfSse2(p, end, set, setSize);
+            }
+#endif
+
+            const Ops kScalarOps = {findCRLFScalar, findCRLFCRLFScalar, findAnyOfScalar};
+#if defined(__x86_64__)
+            const Ops kSse2Ops = {findCRLFSse2, findCRLFCRLFSse2, findAnyOfSse2};
+            const Ops kAvx2Ops = {findCRLFAvx2, findCRLFCRLFAvx2, findAnyOfAvx2};
+#endif
+        }
+
+        Isa bestIsa()
+        {
+#if defined(__x86_64__)
+            static const Isa best = __builtin_cpu_supports("avx2") ? Isa::kAvx2 : Isa::kSse2;
+            return best;
+#else
+            return Isa::kScalar;
+#endif
+        }
+
+        const Ops &ops()
+        {
+            static const Ops &best = ops(bestIsa());
+            return best;
+        }
+
+        const Ops &ops(Isa isa)
+        {
+#if defined(__x86_64__)
+            // SSE2 是 x86-64 的基线
+            if (isa == Isa::kAvx2 && bestIsa() == Isa::kAvx2)
+            {
+                return kAvx2Ops;
+            }
+            if (isa != Isa::kScalar)
+            {
+                return kSse2Ops;
+            }
+#else
+            (void)isa;
+#endif
+            return kScalarOps;
+        }
+
+        const char *findByte(const char *begin, const char *end, char c)
+        {
+            return findByteOrEnd(begin, end, c);
+        }
+    }
+}
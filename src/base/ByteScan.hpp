@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+
+namespace base
+{
+    // 协议解析用的分隔符查找：在 [begin, end) 中查找，找不到返回 end。
+    // x86-64 上按 CPU 运行时选择 AVX2 / SSE2 实现，其他平台和不支持的 CPU 用逐字节实现
+    namespace scan
+    {
+        enum class Isa
+        {
+            kScalar,
+            kSse2,
+            kAvx2,
+        };
+
+        struct Ops
+        {
+            const char *(*findCRLF)(const char *begin, const char *end);
+            const char *(*findCRLFCRLF)(const char *begin, const char *end);
+            // set 中的字节不超过 kMaxSetSize 个，超出时退回逐字节实现
+            const char *(*findAnyOf)(const char *begin, const char *end, const char *set, size_t setSize);
+        };
+
+        static constexpr size_t kMaxSetSize = 8;
+
+        // 当前 CPU 支持的最佳实现
+        Isa bestIsa();
+        const Ops &ops();
+        // 指定实现，供测试和基准对比；CPU 不支持时返回逐字节实现
+        const Ops &ops(Isa isa);
+
+        inline const char *findCRLF(const char *begin, const char *end) { return ops().findCRLF(begin, end); }
+        inline const char *findCRLFCRLF(const char *begin, const char *end) { return ops().findCRLFCRLF(begin, end); }
+        inline const char *findAnyOf(const char *begin, const char *end, const char *set, size_t setSize)
+        {
+            return ops().findAnyOf(begin, end, set, setSize);
+        }
+        // 单个字节（如 RTSP 交织帧的 '$'）直接用 memchr，glibc 已按 CPU 选择向量实现
+        const char *findByte(const char *begin, const char *end, char c);
+    }
+}
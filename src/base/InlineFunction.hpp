@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace base
+{
+    template <typename Signature, size_t Capacity = 48>
+    class InlineFunction;
+
+    // 只可移动的类型擦除函数对象，捕获不超过 Capacity 字节时存放在对象内部，不分配堆内存；
+    // 更大或移动可能抛异常的可调用对象退化为堆上存储。
+    // 用于 EventLoop 任务与 Channel 回调，替代每次都可能分配内存的 std::function。
+    template <typename R, typename... Args, size_t Capacity>
+    class InlineFunction<R(Args...), Capacity>
+    {
+    public:
+        InlineFunction() noexcept : ops_(nullptr) {}
+        InlineFunction(std::nullptr_t) noexcept : ops_(nullptr) {}
+
+        template <typename F,
+                  typename Fn = std::decay_t<F>,
+                  typename = std::enable_if_t<!std::is_same<Fn, InlineFunction>::value &&
+                                              std::is_invocable_r<R, Fn &, Args...>::value>>
+        InlineFunction(F &&f) : ops_(nullptr)
+        {
+            if constexpr (std::is_pointer<Fn>::value || std::is_member_pointer<Fn>::value ||
+                          std::is_constructible<bool, const Fn &>::value)
+            {
+                if (!static_cast<bool>(f))
+                {
+                    return; // 空函数指针 / 空 std::function 保持为空
+                }
+            }
+            if constexpr (fitsInline<Fn>())
+            {
+                ::new (static_cast<void *>(storage_)) Fn(std::forward<F>(f));
+                ops_ = &InlineOps<Fn>::kOps;
+            }
+            else
+            {
+                ::new (static_cast<void *>(storage_)) Fn *(new Fn(std::forward<F>(f)));
+                ops_ = &HeapOps<Fn>::kOps;
+            }
+        }
+
+        InlineFunction(InlineFunction &&other) noexcept : ops_(other.ops_)
+        {
+            if (ops_ != nullptr)
+            {
+                ops_->move(storage_, other.storage_);
+                other.ops_ = nullptr;
+            }
+        }
+
+        InlineFunction &operator=(InlineFunction &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                if (other.ops_ != nullptr)
+                {
+                    other.ops_->move(storage_, other.storage_);
+                    ops_ = other.ops_;
+                    other.ops_ = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        InlineFunction &operator=(std::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        InlineFunction(const InlineFunction &) = delete;
+        InlineFunction &operator=(const InlineFunction &) = delete;
+
+        ~InlineFunction() { reset(); }
+
+        R operator()(Args... args) const
+        {
+            if (ops_ == nullptr)
+            {
+                throw std::bad_function_call();
+            }
+            return ops_->invoke(storage_, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+        // 可调用对象是否存放在内部缓冲区（未分配堆内存）
+        bool isInline() const noexcept { return ops_ != nullptr && ops_->isInline; }
+
+        template <typename F>
+        static constexpr bool fitsInline()
+        {
+            return sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) &&
+                   std::is_nothrow_move_constructible<F>::value;
+        }
+
+    private:
+        struct Ops
+        {
+            R (*invoke)(void *storage, Args &&...args);
+            void (*move)(void *dst, void *src) noexcept;
+            void (*destroy)(void *storage) noexcept;
+            bool isInline;
+        };
+
+        template <typename Fn>
+        struct InlineOps
+        {
+            static R invoke(void *storage, Args &&...args)
+            {
+                return std::invoke(*static_cast<Fn *>(storage), std::forward<Args>(args)...);
+            }
+            static void move(void *dst, void *src) noexcept
+            {
+                Fn *from = static_cast<Fn *>(src);
+                ::new (dst) Fn(std::move(*from));
+                from->~Fn();
+            }
+            static void destroy(void *storage) noexcept { static_cast<Fn *>(storage)->~Fn(); }
+            static constexpr Ops kOps = {&invoke, &move, &destroy, true};
+        };
+
+        template <typename Fn>
+        struct HeapOps
+        {
+            static R invoke(void *storage, Args &&...args)
+            {
+                return std::invoke(**static_cast<Fn **>(storage), std::forward<Args>(args)...);
+            }
+            static void move(void *dst, void *src) noexcept
+            {
+                ::new (dst) Fn *(*static_cast<Fn **>(src));
+            }
+            static void destroy(void *storage) noexcept { delete *static_cast<Fn **>(storage); }
+            static constexpr Ops kOps = {&invoke, &move, &destroy, false};
+        };
+
+        void reset() noexcept
+        {
+            if (ops_ != nullptr)
+            {
+                ops_->destroy(storage_);
+                ops_ = nullptr;
+            }
+        }
+
+        static_assert(Capacity >= sizeof(void *), "InlineFunction capacity must hold a pointer");
+
+        alignas(std::max_align_t) mutable unsigned char storage_[Capacity];
+        const Ops *ops_;
+    };
+} // namespace base
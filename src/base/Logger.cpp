@@ -356,6 +356,11 @@ namespace base
     Logger *LoggerManager::get_logger()
     {
         std::lock_guard<std::mutex> lock(mutex_);
+        // 未配置日志器时退化为无输出的同步日志器，避免 LOG_* 宏解引用空指针
+        if (!logger_)
+        {
+            logger_.reset(new SyncLogger());
+        }
         return logger_.get();
     }
 
@@ -116,6 +116,10 @@ namespace base
         virtual void flush() = 0;
         virtual void add_sink(std::shared_ptr<LogSink> sink) = 0;
         virtual void set_log_level(LogLevel level) = 0;
+        virtual LogLevel get_log_level() const = 0;
+
+        // LOG_* 宏先判断级别，被过滤的日志不做格式化
+        bool enabled(LogLevel level) const { return static_cast<int>(level) >= static_cast<int>(get_log_level()); }
     };
 
     class SyncLogger : public Logger
@@ -126,6 +130,7 @@ namespace base
         void flush() override;
         void add_sink(std::shared_ptr<LogSink> sink) override;
         void set_log_level(LogLevel level) override;
+        LogLevel get_log_level() const override { return log_level_; }
 
     private:
         std::vector<std::shared_ptr<LogSink>> sinks_;
@@ -144,6 +149,7 @@ namespace base
         void flush() override;
         void add_sink(std::shared_ptr<LogSink> sink) override;
         void set_log_level(LogLevel level) override;
+        LogLevel get_log_level() const override { return log_level_; }
 
     private:
         void worker_thread();
@@ -206,8 +212,18 @@ namespace base
     }
 } // namespace base
 
-#define LOG_DEBUG(fmt, ...) base::LoggerManager::instance().get_logger()->log(base::LogLevel::DEBUG, base::safe_printf_format(fmt, ##__VA_ARGS__))
-#define LOG_INFO(fmt, ...) base::LoggerManager::instance().get_logger()->log(base::LogLevel::INFO, base::safe_printf_format(fmt, ##__VA_ARGS__))
-#define LOG_WARN(fmt, ...) base::LoggerManager::instance().get_logger()->log(base::LogLevel::WARN, base::safe_printf_format(fmt, ##__VA_ARGS__))
-#define LOG_ERROR(fmt, ...) base::LoggerManager::instance().get_logger()->log(base::LogLevel::ERROR, base::safe_printf_format(fmt, ##__VA_ARGS__))
-#define LOG_FATAL(fmt, ...) base::LoggerManager::instance().get_logger()->log(base::LogLevel::FATAL, base::safe_printf_format(fmt, ##__VA_ARGS__))
+#define LOG_AT_LEVEL(level, fmt, ...)                                                                 \
+    do                                                                                                \
+    {                                                                                                 \
+        base::Logger *logAtLevelLogger_ = base::LoggerManager::instance().get_logger();               \
+        if (logAtLevelLogger_->enabled(level))                                                        \
+        {                                                                                             \
+            logAtLevelLogger_->log(level, base::safe_printf_format(fmt, ##__VA_ARGS__));              \
+        }                                                                                             \
+    } while (0)
+
+#define LOG_DEBUG(fmt, ...) LOG_AT_LEVEL(base::LogLevel::DEBUG, fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...) LOG_AT_LEVEL(base::LogLevel::INFO, fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...) LOG_AT_LEVEL(base::LogLevel::WARN, fmt, ##__VA_ARGS__)
+#define LOG_ERROR(fmt, ...) LOG_AT_LEVEL(base::LogLevel::ERROR, fmt, ##__VA_ARGS__)
+#define LOG_FATAL(fmt, ...) LOG_AT_LEVEL(base::LogLevel::FATAL, fmt, ##__VA_ARGS__)
@@ -4,6 +4,9 @@
 #include <atomic>
 #include <memory>
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
 
 namespace base
 {
@@ -144,4 +147,213 @@ namespace base
 
         return count;
     }
+
+    // 侵入式 MPSC 队列节点，元素类型需继承 MpscNode
+    struct MpscNode
+    {
+        std::atomic<MpscNode *> next{nullptr};
+    };
+
+    // Vyukov 侵入式多生产者单消费者队列：push 无等待且不分配内存，pop 只能在单一消费者线程调用。
+    // pop 返回 nullptr 时队列可能只是暂时不一致（某个生产者正在 push），调用方应稍后重试。
+    template <typename T>
+    class MpscQueue
+    {
+    public:
+        MpscQueue() : tail_(&stub_), head_(&stub_) {}
+
+        MpscQueue(const MpscQueue &) = delete;
+        MpscQueue &operator=(const MpscQueue &) = delete;
+
+        void push(T *item) { pushNode(item); }
+        T *pop();
+        bool empty() const;
+
+    private:
+        void pushNode(MpscNode *node)
+        {
+            node->next.store(nullptr, std::memory_order_relaxed);
+            MpscNode *prev = tail_.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        alignas(64) std::atomic<MpscNode *> tail_; // 生产者端
+        alignas(64) MpscNode *head_;               // 消费者端
+        MpscNode stub_;
+    };
+
+    template <typename T>
+    T *MpscQueue<T>::pop()
+    {
+        MpscNode *head = head_;
+        MpscNode *next = head->next.load(std::memory_order_acquire);
+        if (head == &stub_)
+        {
+            if (next == nullptr)
+            {
+                return nullptr;
+            }
+            head_ = next;
+            head = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr)
+        {
+            head_ = next;
+            return static_cast<T *>(head);
+        }
+        if (head != tail_.load(std::memory_order_acquire))
+        {
+            return nullptr; // 生产者已交换 tail_ 但尚未链接 next
+        }
+        pushNode(&stub_);
+        next = head->next.load(std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            head_ = next;
+            return static_cast<T *>(head);
+        }
+        return nullptr;
+    }
+
+    template <typename T>
+    bool MpscQueue<T>::empty() const
+    {
+        const MpscNode *head = head_;
+        return head == &stub_ && head->next.load(std::memory_order_acquire) == nullptr &&
+               tail_.load(std::memory_order_acquire) == &stub_;
+    }
+
+    // Chase-Lev 工作窃取双端队列（按 Lê 等人的 C11 内存序版本）：
+    // 所有者线程在底部 push / pop（LIFO），其他线程从顶部 steal（FIFO）。
+    // 元素须为可平凡复制的类型（通常是指针）；扩容后的旧数组留到析构时释放，窃取者可能仍在读
+    template <typename T>
+    class ChaseLevDeque
+    {
+    public:
+        explicit ChaseLevDeque(size_t capacity = 256);
+
+        ChaseLevDeque(const ChaseLevDeque &) = delete;
+        ChaseLevDeque &operator=(const ChaseLevDeque &) = delete;
+
+        void push(T item);     // 仅所有者
+        bool pop(T &item);     // 仅所有者
+        bool steal(T &item);   // 任意线程，与其他窃取者竞争失败时也返回 false
+        bool empty() const;    // 近似值
+        size_t size() const;   // 近似值
+
+    private:
+        struct Array
+        {
+            explicit Array(size_t capacity) : mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+
+            T get(int64_t index) const { return slots[static_cast<size_t>(index) & mask].load(std::memory_order_relaxed); }
+            void put(int64_t index, T item) { slots[static_cast<size_t>(index) & mask].store(item, std::memory_order_relaxed); }
+            size_t capacity() const { return mask + 1; }
+
+            size_t mask;
+            std::unique_ptr<std::atomic<T>[]> slots;
+        };
+
+        Array *grow(Array *array, int64_t bottom, int64_t top);
+
+        alignas(64) std::atomic<int64_t> top_;    // 窃取端
+        alignas(64) std::atomic<int64_t> bottom_; // 所有者端
+        std::atomic<Array *> array_;
+        std::vector<std::unique_ptr<Array>> arrays_; // 当前及扩容前的所有数组，只有所有者修改
+    };
+
+    template <typename T>
+    ChaseLevDeque<T>::ChaseLevDeque(size_t capacity) : top_(0), bottom_(0)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "ChaseLevDeque stores trivially copyable items");
+        size_t rounded = 1;
+        while (rounded < capacity)
+        {
+            rounded <<= 1;
+        }
+        arrays_.emplace_back(new Array(rounded));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    typename ChaseLevDeque<T>::Array *ChaseLevDeque<T>::grow(Array *array, int64_t bottom, int64_t top)
+    {
+        arrays_.emplace_back(new Array(array->capacity() * 2));
+        Array *bigger = arrays_.back().get();
+        for (int64_t i = top; i < bottom; ++i)
+        {
+            bigger->put(i, array->get(i));
+        }
+        array_.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    template <typename T>
+    void ChaseLevDeque<T>::push(T item)
+    {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const int64_t top = top_.load(std::memory_order_acquire);
+        Array *array = array_.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<int64_t>(array->capacity()) - 1)
+        {
+            array = grow(array, bottom, top);
+        }
+        array->put(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    bool ChaseLevDeque<T>::pop(T &item)
+    {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Array *array = array_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+        if (top > bottom)
+        {
+            bottom_.store(bottom + 1, std::memory_order_relaxed); // 已空
+            return false;
+        }
+        item = array->get(bottom);
+        if (top == bottom)
+        {
+            // 最后一个元素，与窃取者竞争
+            const bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool ChaseLevDeque<T>::steal(T &item)
+    {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom)
+        {
+            return false;
+        }
+        Array *array = array_.load(std::memory_order_acquire);
+        item = array->get(top);
+        return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    bool ChaseLevDeque<T>::empty() const
+    {
+        return size() == 0;
+    }
+
+    template <typename T>
+    size_t ChaseLevDeque<T>::size() const
+    {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const int64_t top = top_.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
 } // namespace base
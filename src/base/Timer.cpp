@@ -73,9 +73,8 @@ namespace base
     }
 
     // ===== TimerQueue 实现 =====
-    TimerId TimerQueue::addTimer(TimerCallback cb, const Timestamp &when, double interval)
+    TimerId TimerQueue::addTimer(TimerPtr timer)
     {
-        TimerPtr timer = std::make_shared<Timer>(cb, when, interval);
         TimerId timerId = timer->timerId();
 
         addTimerInHeap(timer);
@@ -95,21 +94,61 @@ namespace base
         }
     }
 
-    void TimerQueue::handleExpiredTimers()
+    bool TimerQueue::reset(TimerId timerId, const Timestamp &when)
     {
-        Timestamp now = Timestamp::now();
-
-        while (!timers_.empty())
+        auto it = activeTimers_.find(timerId);
+        if (it == activeTimers_.end())
         {
-            TimerPtr top = timers_.front();
-            if (top->expiration() > now)
-                break;
+            return false;
+        }
+        TimerPtr timer = it->second;
+        removeTimerFromHeap(timer);
+        timer->setExpiration(when);
+        addTimerInHeap(timer);
+        return true;
+    }
 
+    size_t TimerQueue::handleExpiredTimers(Timestamp now)
+    {
+        // 先把到期的定时器整批取出再执行，回调中新增/取消定时器不会影响本轮遍历
+        std::vector<TimerPtr> expired;
+        while (!timers_.empty() && timers_.front()->expiration() <= now)
+        {
             std::pop_heap(timers_.begin(), timers_.end(), TimerCompare());
+            expired.push_back(std::move(timers_.back()));
             timers_.pop_back();
+        }
 
-            handleExpiration(top);
+        for (const TimerPtr &timer : expired)
+        {
+            // 可能已被同批次中更早执行的回调取消
+            if (activeTimers_.count(timer->timerId()) == 0)
+            {
+                continue;
+            }
+            timer->run();
+
+            auto it = activeTimers_.find(timer->timerId());
+            if (it == activeTimers_.end())
+            {
+                continue; // 回调中取消了自己
+            }
+            if (timer->isRepeat())
+            {
+                timer->restart(now);
+                addTimerInHeap(timer);
+            }
+            else
+            {
+                activeTimers_.erase(it);
+            }
         }
+        return expired.size();
+    }
+
+    Timestamp TimerQueue::nextExpiration() const
+    {
+        return timers_.empty() ? Timestamp::invalid() : timers_.front()->expiration();
     }
 
     void TimerQueue::addTimerInHeap(TimerPtr timer)
@@ -123,31 +162,11 @@ namespace base
         auto it = std::find(timers_.begin(), timers_.end(), timer);
         if (it != timers_.end())
         {
-            *it = timers_.back();
+            *it = std::move(timers_.back());
             timers_.pop_back();
-
-            if (it != timers_.end())
-            {
-                std::push_heap(timers_.begin(), it + 1, TimerCompare());
-                std::pop_heap(timers_.begin(), it + 1, TimerCompare());
-            }
-        }
-    }
-
-    void TimerQueue::handleExpiration(TimerPtr timer)
-    {
-        timer->run();
-
-        if (timer->isRepeat())
-        {
-            timer->restart(Timestamp::now());
-            addTimerInHeap(timer);
-        }
-        else
-        {
-            activeTimers_.erase(timer->timerId());
+            std::make_heap(timers_.begin(), timers_.end(), TimerCompare());
         }
     }
 
-    int Timer::nextId_ = 0;
+    std::atomic<int> Timer::nextId_{0};
 } // namespace base
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include <ctime>
 #include <sys/time.h>
 #include <cinttypes>
+#include <atomic>
+#include "Noncopyable.hpp"
 
 namespace base
 {
@@ -131,6 +133,7 @@ namespace base
         double interval() const { return interval_; }
         TimerId timerId() const { return timerId_; }
         void restart(const Timestamp &now);
+        void setExpiration(const Timestamp &when) { expiration_ = when; }
         bool valid() const { return expiration_.valid(); }
 
     private:
@@ -139,22 +142,54 @@ namespace base
         double interval_;
         bool repeat_;
         TimerId timerId_;
-        static int nextId_;
+        static std::atomic<int> nextId_; // 定时器可能在任意线程创建
     };
 
-    class TimerQueue
+    using TimerPtr = std::shared_ptr<Timer>;
+
+    // 定时器容器接口：二叉堆（TimerQueue）与分层时间轮（TimingWheel）两种实现，
+    // 均只在所属 EventLoop 线程中访问，不加锁
+    class TimerQueueBase : Noncopyable
+    {
+    public:
+        virtual ~TimerQueueBase() = default;
+
+        TimerId addTimer(TimerCallback cb, const Timestamp &when, double interval)
+        {
+            return addTimer(std::make_shared<Timer>(std::move(cb), when, interval));
+        }
+        virtual TimerId addTimer(TimerPtr timer) = 0; // 供 EventLoop 在调用线程预先分配 TimerId
+        virtual void cancel(TimerId timerId) = 0;
+        // 修改定时器的到期时间（连接空闲超时刷新），定时器不存在时返回 false
+        virtual bool reset(TimerId timerId, const Timestamp &when) = 0;
+
+        void handleExpiredTimers() { handleExpiredTimers(Timestamp::now()); }
+        // 批量处理 now 之前到期的定时器，返回本次触发的数量
+        virtual size_t handleExpiredTimers(Timestamp now) = 0;
+
+        // 最早到期时间（时间轮返回下界），为空时返回 Timestamp::invalid()
+        virtual Timestamp nextExpiration() const = 0;
+        virtual size_t size() const = 0;
+        bool empty() const { return size() == 0; }
+    };
+
+    class TimerQueue : public TimerQueueBase
     {
     public:
         TimerQueue() = default; // 显式默认构造
-        ~TimerQueue() = default;
+        ~TimerQueue() override = default;
 
-        TimerId addTimer(TimerCallback cb, const Timestamp &when, double interval);
-        void cancel(TimerId timerId);
-        void handleExpiredTimers();
+        using TimerQueueBase::addTimer;
+        using TimerQueueBase::handleExpiredTimers;
+        TimerId addTimer(TimerPtr timer) override;
+        void cancel(TimerId timerId) override;
+        bool reset(TimerId timerId, const Timestamp &when) override;
+        size_t handleExpiredTimers(Timestamp now) override;
 
-    private:
-        using TimerPtr = std::shared_ptr<Timer>;
+        Timestamp nextExpiration() const override;
+        size_t size() const override { return activeTimers_.size(); }
 
+    private:
         struct TimerCompare
         {
             bool operator()(const TimerPtr &a, const TimerPtr &b) const
@@ -168,6 +203,5 @@ namespace base
 
         void addTimerInHeap(TimerPtr timer);
         void removeTimerFromHeap(TimerPtr timer);
-        void handleExpiration(TimerPtr timer);
     };
 }
\ No newline at end of file
@@ -0,0 +1,300 @@
+#include "TimingWheel.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+namespace base
+{
+    TimingWheel::TimingWheel(double tickSeconds, Timestamp origin)
+        : tickUs_(std::max<int64_t>(1, static_cast<int64_t>(tickSeconds * Timestamp::kMicroSecondsPerSecond))),
+          origin_(origin),
+          currentTick_(0)
+    {
+        std::memset(bitmap_, 0, sizeof(bitmap_));
+    }
+
+    TimingWheel::~TimingWheel()
+    {
+        for (auto &item : nodes_)
+        {
+            delete item.second;
+        }
+        for (Node *node : freeNodes_)
+        {
+            delete node;
+        }
+    }
+
+    TimerId TimingWheel::addTimer(TimerPtr timer)
+    {
+        TimerId timerId = timer->timerId();
+        Node *node = allocateNode();
+        node->timer = std::move(timer);
+        node->tick = toTick(node->timer->expiration());
+        place(node);
+        nodes_[timerId] = node;
+        return timerId;
+    }
+
+    void TimingWheel::cancel(TimerId timerId)
+    {
+        auto it = nodes_.find(timerId);
+        if (it != nodes_.end())
+        {
+            Node *node = it->second;
+            nodes_.erase(it);
+            unlink(node);
+            releaseNode(node);
+        }
+    }
+
+    bool TimingWheel::reset(TimerId timerId, const Timestamp &when)
+    {
+        auto it = nodes_.find(timerId);
+        if (it == nodes_.end())
+        {
+            return false;
+        }
+        Node *node = it->second;
+        unlink(node);
+        node->timer->setExpiration(when);
+        node->tick = toTick(when);
+        place(node);
+        return true;
+    }
+
+    size_t TimingWheel::handleExpiredTimers(Timestamp now)
+    {
+        const uint64_t nowTick = toTickFloor(now);
+        size_t fired = 0;
+
+        while (currentTick_ <= nowTick)
+        {
+            if (nodes_.empty())
+            {
+                currentTick_ = nowTick + 1; // 空轮直接快进
+                break;
+            }
+
+            const int index = static_cast<int>(currentTick_ & kSlotMask);
+            if (index == 0)
+            {
+                // 低层转完一圈，把上一层对应槽的定时器重新散列下来
+                for (int level = 1; level < kLevels; ++level)
+                {
+                    int slot = static_cast<int>((currentTick_ >> (level * kSlotBits)) & kSlotMask);
+                    cascade(level, slot);
+                    if (slot != 0)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            Node &head = slots_[0][index];
+            while (head.next != &head)
+            {
+                Node *node = head.next;
+                unlink(node);
+                node->level = kExpiringLevel;
+                node->prev = expiring_.prev;
+                node->next = &expiring_;
+                expiring_.prev->next = node;
+                expiring_.prev = node;
+            }
+            ++currentTick_;
+
+            while (expiring_.next != &expiring_)
+            {
+                Node *node = expiring_.next;
+                unlink(node);
+                TimerPtr timer = node->timer; // 回调里可能取消自己并回收节点
+                TimerId timerId = timer->timerId();
+                timer->run();
+                ++fired;
+
+                auto it = nodes_.find(timerId);
+                if (it == nodes_.end() || node->level >= 0)
+                {
+                    continue; // 已取消，或在回调中被 reset 重新挂入
+                }
+                if (timer->isRepeat())
+                {
+                    timer->restart(now);
+                    node->tick = toTick(timer->expiration());
+                    place(node);
+                }
+                else
+                {
+                    nodes_.erase(it);
+                    releaseNode(node);
+                }
+            }
+
+            // 跳过空槽，但不越过下一个需要级联的边界
+            if ((currentTick_ & kSlotMask) != 0)
+            {
+                int slot = nextOccupiedSlot(0, static_cast<int>(currentTick_ & kSlotMask));
+                uint64_t candidate = slot >= 0 ? (currentTick_ & ~kSlotMask) + slot
+                                               : (currentTick_ | kSlotMask) + 1;
+                currentTick_ = std::min(candidate, nowTick + 1);
+            }
+        }
+        return fired;
+    }
+
+    Timestamp TimingWheel::nextExpiration() const
+    {
+        if (nodes_.empty())
+        {
+            return Timestamp::invalid();
+        }
+
+        uint64_t best = std::numeric_limits<uint64_t>::max();
+        const int index = static_cast<int>(currentTick_ & kSlotMask);
+        int slot = nextOccupiedSlot(0, index);
+        if (slot >= 0)
+        {
+            best = (currentTick_ & ~kSlotMask) + slot;
+        }
+        else if ((slot = nextOccupiedSlot(0, 0)) >= 0)
+        {
+            best = (currentTick_ & ~kSlotMask) + kSlots + slot;
+        }
+
+        // 上层槽只能给出下界：该槽被级联下来的时刻
+        for (int level = 1; level < kLevels; ++level)
+        {
+            const int shift = level * kSlotBits;
+            const uint64_t block = currentTick_ >> shift;
+            const int current = static_cast<int>(block & kSlotMask);
+            if ((currentTick_ & ((uint64_t(1) << shift) - 1)) == 0 && !slotEmpty(level, current))
+            {
+                best = std::min(best, currentTick_);
+                continue;
+            }
+            for (int k = 1; k <= kSlots; ++k)
+            {
+                if (!slotEmpty(level, static_cast<int>((current + k) & kSlotMask)))
+                {
+                    best = std::min(best, (block + k) << shift);
+                    break;
+                }
+            }
+        }
+        return tickToTimestamp(best);
+    }
+
+    uint64_t TimingWheel::toTick(const Timestamp &when) const
+    {
+        int64_t diff = when.microSecondsSinceEpoch() - origin_.microSecondsSinceEpoch();
+        return diff <= 0 ? 0 : static_cast<uint64_t>((diff + tickUs_ - 1) / tickUs_);
+    }
+
+    uint64_t TimingWheel::toTickFloor(const Timestamp &when) const
+    {
+        int64_t diff = when.microSecondsSinceEpoch() - origin_.microSecondsSinceEpoch();
+        return diff <= 0 ? 0 : static_cast<uint64_t>(diff / tickUs_);
+    }
+
+    Timestamp TimingWheel::tickToTimestamp(uint64_t tick) const
+    {
+        return Timestamp(origin_.microSecondsSinceEpoch() + static_cast<int64_t>(tick) * tickUs_);
+    }
+
+    void TimingWheel::place(Node *node)
+    {
+        uint64_t tick = std::max(node->tick, currentTick_); // 已过期的放进下一个待处理的槽
+        uint64_t span = tick - currentTick_;
+        if (span > kMaxSpan)
+        {
+            span = kMaxSpan;
+            tick = currentTick_ + kMaxSpan; // 超出范围先挂在最高层，级联时再重新计算
+        }
+
+        int level = 0;
+        while (level < kLevels - 1 && span >= (uint64_t(1) << ((level + 1) * kSlotBits)))
+        {
+            ++level;
+        }
+        int slot = static_cast<int>((tick >> (level * kSlotBits)) & kSlotMask);
+
+        Node &head = slots_[level][slot];
+        node->level = level;
+        node->slot = slot;
+        node->prev = head.prev;
+        node->next = &head;
+        head.prev->next = node;
+        head.prev = node;
+        bitmap_[level][slot >> 6] |= uint64_t(1) << (slot & 63);
+    }
+
+    void TimingWheel::unlink(Node *node)
+    {
+        if (node->next == node)
+        {
+            return;
+        }
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        node->prev = node->next = node;
+
+        if (node->level >= 0 && node->level < kLevels)
+        {
+            Node &head = slots_[node->level][node->slot];
+            if (head.next == &head)
+            {
+                bitmap_[node->level][node->slot >> 6] &= ~(uint64_t(1) << (node->slot & 63));
+            }
+        }
+        node->level = -1;
+        node->slot = -1;
+    }
+
+    void TimingWheel::cascade(int level, int slot)
+    {
+        Node &head = slots_[level][slot];
+        while (head.next != &head)
+        {
+            Node *node = head.next;
+            unlink(node);
+            place(node);
+        }
+    }
+
+    int TimingWheel::nextOccupiedSlot(int level, int from) const
+    {
+        for (int word = from >> 6; word < kSlots / 64; ++word)
+        {
+            uint64_t bits = bitmap_[level][word];
+            if (word == (from >> 6))
+            {
+                bits &= ~uint64_t(0) << (from & 63);
+            }
+            if (bits != 0)
+            {
+                return word * 64 + __builtin_ctzll(bits);
+            }
+        }
+        return -1;
+    }
+
+    TimingWheel::Node *TimingWheel::allocateNode()
+    {
+        if (freeNodes_.empty())
+        {
+            return new Node();
+        }
+        Node *node = freeNodes_.back();
+        freeNodes_.pop_back();
+        return node;
+    }
+
+    void TimingWheel::releaseNode(Node *node)
+    {
+        assert(node->next == node);
+        node->timer.reset();
+        freeNodes_.push_back(node);
+    }
+} // namespace base
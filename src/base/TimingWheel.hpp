@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Timer.hpp"
+
+namespace base
+{
+    // 哈希分层时间轮：4 层 x 256 槽，插入、取消、重设均为 O(1)。
+    // 到期精度为一个 tick，适合大量连接空闲超时这类频繁刷新、很少真正触发的定时器。
+    class TimingWheel : public TimerQueueBase
+    {
+    public:
+        static constexpr double kDefaultTick = 0.001; // 秒
+
+        explicit TimingWheel(double tickSeconds = kDefaultTick, Timestamp origin = Timestamp::now());
+        ~TimingWheel() override;
+
+        using TimerQueueBase::addTimer;
+        using TimerQueueBase::handleExpiredTimers;
+        TimerId addTimer(TimerPtr timer) override;
+        void cancel(TimerId timerId) override;
+        bool reset(TimerId timerId, const Timestamp &when) override;
+        size_t handleExpiredTimers(Timestamp now) override;
+
+        Timestamp nextExpiration() const override;
+        size_t size() const override { return nodes_.size(); }
+
+        int64_t tickMicroSeconds() const { return tickUs_; }
+
+    private:
+        static constexpr int kLevels = 4;
+        static constexpr int kSlotBits = 8;
+        static constexpr int kSlots = 1 << kSlotBits;
+        static constexpr uint64_t kSlotMask = kSlots - 1;
+        static constexpr uint64_t kMaxSpan = (uint64_t(1) << (kLevels * kSlotBits)) - 1;
+        static constexpr int kExpiringLevel = kLevels; // 已摘下、正在执行的节点
+
+        // 侵入式双向循环链表节点，槽头为哨兵节点
+        struct Node
+        {
+            TimerPtr timer;
+            uint64_t tick = 0;
+            Node *prev = this;
+            Node *next = this;
+            int level = -1;
+            int slot = -1;
+        };
+
+        uint64_t toTick(const Timestamp &when) const;       // 向上取整
+        uint64_t toTickFloor(const Timestamp &when) const; // 向下取整
+        Timestamp tickToTimestamp(uint64_t tick) const;
+
+        void place(Node *node);
+        void unlink(Node *node);
+        void cascade(int level, int slot);
+        void releaseNode(Node *node);
+        Node *allocateNode();
+        bool slotEmpty(int level, int slot) const { return (bitmap_[level][slot >> 6] & (uint64_t(1) << (slot & 63))) == 0; }
+        int nextOccupiedSlot(int level, int from) const;
+
+        const int64_t tickUs_;
+        const Timestamp origin_;
+        uint64_t currentTick_; // 下一个待处理的 tick
+        Node slots_[kLevels][kSlots];
+        uint64_t bitmap_[kLevels][kSlots / 64];
+        Node expiring_;
+        std::unordered_map<TimerId, Node *> nodes_;
+        std::vector<Node *> freeNodes_;
+    };
+} // namespace base
@@ -0,0 +1,274 @@
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace base
+{
+    namespace
+    {
+        // 当前线程所属的线程池及序号，用于判断 submit 是否来自工作线程
+        thread_local const WorkStealingPool *tCurrentPool = nullptr;
+        thread_local int tCurrentIndex = -1;
+        thread_local uint64_t tRandom = 0;
+
+        uint64_t nextRandom()
+        {
+            if (tRandom == 0)
+            {
+                tRandom = reinterpret_cast<uintptr_t>(&tRandom) | 1;
+            }
+            tRandom ^= tRandom << 13;
+            tRandom ^= tRandom >> 7;
+            tRandom ^= tRandom << 17;
+            return tRandom;
+        }
+
+        // 进入休眠前反复窃取的轮数
+        const int kSpinRounds = 64;
+        // 从注入队列一次最多转入自己队列的任务数
+        const size_t kInjectBatch = 16;
+    }
+
+    WorkStealingPool::WorkStealingPool(int numThreads, const std::string &name)
+        : name_(name),
+          stopping_(false),
+          injectedSize_(0),
+          pending_(0),
+          stolen_(0),
+          sleepers_(0),
+          wakeEpoch_(0)
+    {
+        if (numThreads <= 0)
+        {
+            numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+        for (int i = 0; i < numThreads; ++i)
+        {
+            workers_.emplace_back(new Worker());
+        }
+        // 所有 Worker 就绪后再启动线程，窃取时不会看到半初始化的队列
+        for (int i = 0; i < numThreads; ++i)
+        {
+            workers_[i]->thread = std::thread(&WorkStealingPool::workerFunc, this, i);
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        stopping_.store(true, std::memory_order_seq_cst);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++wakeEpoch_;
+        }
+        cond_.notify_all();
+        for (auto &worker : workers_)
+        {
+            worker->thread.join();
+        }
+        assert(pending_.load() == 0);
+    }
+
+    WorkStealingPool &WorkStealingPool::instance()
+    {
+        static WorkStealingPool pool(0, "SharedComputePool");
+        return pool;
+    }
+
+    int WorkStealingPool::currentWorker() const
+    {
+        return tCurrentPool == this ? tCurrentIndex : -1;
+    }
+
+    void WorkStealingPool::submit(Task &&task)
+    {
+        TaskNode *node = new TaskNode();
+        node->task = std::move(task);
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        const int self = currentWorker();
+        if (self >= 0)
+        {
+            workers_[self]->deque.push(node);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(injectMutex_);
+            injected_.push_back(node);
+            injectedSize_.store(injected_.size(), std::memory_order_relaxed);
+        }
+        // 与 workerFunc 中 sleepers_ 自增后的检查配对，保证不会有任务入队而所有线程都在睡
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) > 0)
+        {
+            notifyOne();
+        }
+    }
+
+    void WorkStealingPool::notifyOne()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++wakeEpoch_;
+        }
+        cond_.notify_one();
+    }
+
+    bool WorkStealingPool::tryRunOne()
+    {
+        const int self = currentWorker();
+        TaskNode *node = nullptr;
+        if (self >= 0)
+        {
+            node = findTask(self);
+        }
+        else
+        {
+            node = takeInjected(nullptr);
+            const int n = numThreads();
+            const int start = static_cast<int>(nextRandom() % static_cast<uint64_t>(n));
+            for (int i = 0; i < n && node == nullptr; ++i)
+            {
+                node = stealFrom((start + i) % n);
+            }
+        }
+        if (node == nullptr)
+        {
+            return false;
+        }
+        run(node);
+        return true;
+    }
+
+    void WorkStealingPool::run(TaskNode *node)
+    {
+        node->task();
+        delete node;
+        pending_.fetch_sub(1, std::memory_order_release);
+    }
+
+    WorkStealingPool::TaskNode *WorkStealingPool::stealFrom(int victim)
+    {
+        TaskNode *node = nullptr;
+        if (workers_[victim]->deque.steal(node))
+        {
+            stolen_.fetch_add(1, std::memory_order_relaxed);
+            return node;
+        }
+        return nullptr;
+    }
+
+    WorkStealingPool::TaskNode *WorkStealingPool::findTask(int index)
+    {
+        Worker &self = *workers_[index];
+        TaskNode *node = nullptr;
+        if (self.deque.pop(node))
+        {
+            return node;
+        }
+        if ((node = takeInjected(&self)) != nullptr)
+        {
+            return node;
+        }
+        const int n = numThreads();
+        const int start = static_cast<int>(nextRandom() % static_cast<uint64_t>(n));
+        for (int i = 0; i < n; ++i)
+        {
+            const int victim = (start + i) % n;
+            if (victim != index && (node = stealFrom(victim)) != nullptr)
+            {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    WorkStealingPool::TaskNode *WorkStealingPool::takeInjected(Worker *worker)
+    {
+        if (injectedSize_.load(std::memory_order_relaxed) == 0)
+        {
+            return nullptr;
+        }
+        TaskNode *node = nullptr;
+        size_t moved = 0;
+        {
+            std::lock_guard<std::mutex> lock(injectMutex_);
+            if (injected_.empty())
+            {
+                return nullptr;
+            }
+            node = injected_.front();
+            injected_.pop_front();
+            // 工作线程多取一批放进自己的队列，之后不必再争这把锁，其他线程也可以窃取
+            while (worker != nullptr && !injected_.empty() && moved < kInjectBatch)
+            {
+                worker->deque.push(injected_.front());
+                injected_.pop_front();
+                ++moved;
+            }
+            injectedSize_.store(injected_.size(), std::memory_order_relaxed);
+        }
+        if (moved > 0 && sleepers_.load(std::memory_order_relaxed) > 0)
+        {
+            notifyOne();
+        }
+        return node;
+    }
+
+    bool WorkStealingPool::hasWork() const
+    {
+        if (injectedSize_.load(std::memory_order_relaxed) > 0)
+        {
+            return true;
+        }
+        for (const auto &worker : workers_)
+        {
+            if (!worker->deque.empty())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkStealingPool::workerFunc(int index)
+    {
+        tCurrentPool = this;
+        tCurrentIndex = index;
+        int idleRounds = 0;
+        for (;;)
+        {
+            if (TaskNode *node = findTask(index))
+            {
+                run(node);
+                idleRounds = 0;
+                continue;
+            }
+            if (stopping_.load(std::memory_order_acquire) && pending_.load(std::memory_order_acquire) == 0)
+            {
+                break;
+            }
+            if (++idleRounds < kSpinRounds)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            uint64_t epoch;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                epoch = wakeEpoch_;
+            }
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!hasWork() && !stopping_.load(std::memory_order_seq_cst))
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [this, epoch]()
+                           { return wakeEpoch_ != epoch; });
+            }
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            idleRounds = 0;
+        }
+        tCurrentPool = nullptr;
+        tCurrentIndex = -1;
+    }
+} // namespace base
@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "InlineFunction.hpp"
+#include "Noncopyable.hpp"
+#include "Queue.hpp"
+
+namespace base
+{
+    // 计算线程池：每个工作线程一个 Chase-Lev 双端队列，空闲时随机挑别的线程窃取。
+    // 工作线程内提交的任务进自己的队列（LIFO，适合 fork/join）；外部线程（如 IO loop）
+    // 提交的任务进共享的注入队列，工作线程成批取走放入自己的队列，其余线程再从中窃取。
+    // 用来把解析、建索引、压缩等耗时计算移出 IO loop
+    class WorkStealingPool : Noncopyable
+    {
+    public:
+        // 容量足够放下 EventLoop::runOffLoop 的任务 + 回调而不分配堆内存
+        using Task = InlineFunction<void(), 128>;
+
+        // numThreads <= 0 时取硬件线程数
+        explicit WorkStealingPool(int numThreads = 0, const std::string &name = "WorkStealingPool");
+        // 执行完已提交的任务后停止并回收线程
+        ~WorkStealingPool();
+
+        // 进程内共享的默认线程池，首次使用时按硬件线程数创建
+        static WorkStealingPool &instance();
+
+        void submit(Task &&task);
+        // 在调用线程上执行一个待处理任务（工作线程先取自己的队列，再窃取），没有任务返回 false。
+        // fork/join 等待子任务时用它代替阻塞，避免工作线程全部空等
+        bool tryRunOne();
+
+        int numThreads() const { return static_cast<int>(workers_.size()); }
+        const std::string &name() const { return name_; }
+        int64_t stolen() const { return stolen_.load(std::memory_order_relaxed); }
+        // 当前线程在本池中的序号，不是本池的工作线程时返回 -1
+        int currentWorker() const;
+
+    private:
+        struct TaskNode
+        {
+            Task task;
+        };
+
+        struct Worker
+        {
+            ChaseLevDeque<TaskNode *> deque;
+            std::thread thread;
+        };
+
+        void workerFunc(int index);
+        TaskNode *findTask(int index);
+        TaskNode *stealFrom(int victim);
+        TaskNode *takeInjected(Worker *worker);
+        bool hasWork() const;
+        void run(TaskNode *node);
+        void notifyOne();
+
+        std::string name_;
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::atomic<bool> stopping_;
+        std::mutex injectMutex_;
+        std::deque<TaskNode *> injected_;    // 受 injectMutex_ 保护
+        std::atomic<size_t> injectedSize_;   // 注入队列长度，为 0 时不必加锁
+        std::atomic<int64_t> pending_; // 已提交未执行的任务数
+        std::atomic<int64_t> stolen_;
+        std::atomic<int> sleepers_;
+        std::mutex mutex_;
+        std::condition_variable cond_;
+        uint64_t wakeEpoch_; // 受 mutex_ 保护，每次唤醒加一，避免等待前错过通知
+    };
+} // namespace base
@@ -2,6 +2,9 @@
 #include "Logger.hpp"
 #include "EventLoop.hpp"
 #include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
 
 namespace net
 {
@@ -9,18 +12,38 @@ namespace net
         : loop_(loop),
           acceptSocket_(),
           acceptChannel_(loop, acceptSocket_.fd()),
-          listenning_(false)
+          listenning_(false),
+          idleFd_(::open("/dev/null", O_RDONLY | O_CLOEXEC)),
+          acceptBatch_(kDefaultAcceptBatch),
+          alive_(std::make_shared<char>()),
+          accepted_(0),
+          wakeups_(0),
+          maxBatch_(0),
+          shed_(0),
+          errors_(0)
     {
         acceptSocket_.setReuseAddr(true);
         acceptSocket_.setReusePort(reusePort);
         acceptSocket_.bindAddress(listenAddr);
         acceptChannel_.setReadCallback(std::bind(&Acceptor::handleRead, this));
+        acceptChannel_.setCompletedAcceptEnabled(true); // io_uring 下由多发 accept 直接交出新连接
     }
 
     Acceptor::~Acceptor()
     {
         acceptChannel_.disableAll();
         acceptChannel_.remove();
+        for (int connfd : pendingAccepts_)
+        {
+            if (connfd >= 0)
+            {
+                ::close(connfd);
+            }
+        }
+        if (idleFd_ >= 0)
+        {
+            ::close(idleFd_);
+        }
     }
 
     void Acceptor::listen()
@@ -31,25 +54,152 @@ namespace net
         acceptChannel_.enableReading();
     }
 
+    AcceptStats Acceptor::stats() const
+    {
+        AcceptStats stats;
+        stats.accepted = accepted_.load(std::memory_order_relaxed);
+        stats.wakeups = wakeups_.load(std::memory_order_relaxed);
+        stats.maxBatch = maxBatch_.load(std::memory_order_relaxed);
+        stats.shed = shed_.load(std::memory_order_relaxed);
+        stats.errors = errors_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
     void Acceptor::handleRead()
     {
         loop_->assertInLoopThread();
-        InetAddress peerAddr;
-        int connfd = acceptSocket_.accept(&peerAddr);
-        if (connfd >= 0)
+        if (acceptChannel_.hasCompletedAccept())
+        {
+            handleCompletedAccepts();
+            return;
+        }
+        add(wakeups_, 1);
+        int accepted = 0;
+        for (int i = 0; i < acceptBatch_; ++i)
+        {
+            InetAddress peerAddr;
+            int connfd = acceptSocket_.accept(&peerAddr);
+            if (connfd >= 0)
+            {
+                ++accepted;
+                newConnection(connfd, peerAddr);
+                continue;
+            }
+
+            const int savedErrno = errno;
+            if (savedErrno == EAGAIN || savedErrno == EWOULDBLOCK)
+            {
+                break; // 已取空
+            }
+            if (!acceptFailed(savedErrno))
+            {
+                break;
+            }
+        }
+        recordBatch(accepted);
+    }
+
+    void Acceptor::handleCompletedAccepts()
+    {
+        const bool scheduled = !pendingAccepts_.empty(); // 上一批的剩余已排到下一轮
+        const std::vector<int> &completed = acceptChannel_.completedAccepts();
+        pendingAccepts_.insert(pendingAccepts_.end(), completed.begin(), completed.end());
+        if (!scheduled)
+        {
+            drainPendingAccepts();
+        }
+    }
+
+    void Acceptor::drainPendingAccepts()
+    {
+        add(wakeups_, 1);
+        int accepted = 0;
+        size_t i = 0;
+        for (; i < pendingAccepts_.size() && accepted < acceptBatch_; ++i)
         {
-            if (newConnectionCallback_)
+            const int connfd = pendingAccepts_[i];
+            if (connfd >= 0)
             {
-                newConnectionCallback_(connfd, peerAddr);
+                ++accepted;
+                newConnection(connfd, Socket::getPeerAddr(connfd));
             }
             else
             {
-                ::close(connfd);
+                acceptFailed(-connfd); // 多发 accept 出错后由 poller 在下一轮重新提交
             }
         }
+        pendingAccepts_.erase(pendingAccepts_.begin(), pendingAccepts_.begin() + static_cast<std::ptrdiff_t>(i));
+        recordBatch(accepted);
+        if (!pendingAccepts_.empty())
+        {
+            loop_->queueInLoop([this, alive = std::weak_ptr<char>(alive_)]()
+                               {
+                                   if (alive.lock())
+                                   {
+                                       drainPendingAccepts();
+                                   } });
+        }
+    }
+
+    void Acceptor::newConnection(int connfd, const InetAddress &peerAddr)
+    {
+        if (newConnectionCallback_)
+        {
+            newConnectionCallback_(connfd, peerAddr);
+        }
         else
         {
-            LOG_ERROR("Acceptor::handleRead accept error: %d", errno);
+            ::close(connfd);
+        }
+    }
+
+    bool Acceptor::acceptFailed(int savedErrno)
+    {
+        if (savedErrno == EINTR || savedErrno == ECONNABORTED || savedErrno == EPROTO)
+        {
+            return true; // 对端在 accept 前已放弃，取下一个
+        }
+        if (savedErrno == EMFILE || savedErrno == ENFILE)
+        {
+            if (idleFd_ < 0)
+            {
+                add(errors_, 1);
+                LOG_ERROR("Acceptor::handleRead out of fds and no spare fd left");
+                return false;
+            }
+            shedConnection();
+            return true;
+        }
+        add(errors_, 1);
+        LOG_ERROR("Acceptor::handleRead accept error: %s", strerror(savedErrno));
+        return false; // ENOBUFS / ENOMEM 等，下一轮再试
+    }
+
+    void Acceptor::recordBatch(int accepted)
+    {
+        add(accepted_, accepted);
+        if (accepted > maxBatch_.load(std::memory_order_relaxed))
+        {
+            maxBatch_.store(accepted, std::memory_order_relaxed);
+        }
+    }
+
+    void Acceptor::shedConnection()
+    {
+        // 连接留在 backlog 里时监听 socket 始终可读，水平触发下会空转；
+        // 腾出备用 fd 把它接下来立即关闭，对端看到的是连接被关闭而不是超时
+        ::close(idleFd_);
+        idleFd_ = ::accept(acceptSocket_.fd(), nullptr, nullptr);
+        if (idleFd_ >= 0)
+        {
+            ::close(idleFd_);
+            add(shed_, 1);
+        }
+        idleFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (shed_.load(std::memory_order_relaxed) % 1000 == 1)
+        {
+            LOG_WARN("Acceptor::handleRead out of fds, shed %ld connections so far",
+                     static_cast<long>(shed_.load(std::memory_order_relaxed)));
         }
     }
-}
\ No newline at end of file
+}
@@ -3,7 +3,11 @@
 #include "Socket.hpp"
 #include "Channel.hpp"
 #include "InetAddress.hpp"
+#include "EventLoopStats.hpp"
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace net
 {
@@ -12,6 +16,7 @@ namespace net
     {
     public:
         using NewConnectionCallback = std::function<void(int, const InetAddress &)>;
+        static const int kDefaultAcceptBatch = 64;
 
         Acceptor(EventLoop *loop, const InetAddress &listenAddr, bool reusePort);
         ~Acceptor();
@@ -22,15 +27,44 @@ namespace net
         }
 
         bool listenning() const { return listenning_; }
+        Socket &socket() { return acceptSocket_; }
         void listen();
 
+        // 每次可读事件最多接受的连接数，剩余的留给下一轮，避免连接风暴时饿死同一 loop 上的其他 channel。
+        // io_uring 多发 accept 下内核已接受的连接同样按批交出，超出的部分排到下一轮
+        void setAcceptBatch(int batch) { acceptBatch_ = batch > 0 ? batch : 1; }
+        // 任意线程可读
+        AcceptStats stats() const;
+
     private:
         void handleRead();
+        // io_uring 多发 accept 已接受的连接，fd < 0 为 accept 的 -errno
+        void handleCompletedAccepts();
+        // 交出 pendingAccepts_ 中最多一批连接，还有剩余时排到下一轮
+        void drainPendingAccepts();
+        void newConnection(int connfd, const InetAddress &peerAddr);
+        // 处理 accept 失败，返回 false 表示本轮不再继续
+        bool acceptFailed(int savedErrno);
+        void recordBatch(int accepted);
+        void shedConnection();
+        static void add(std::atomic<int64_t> &counter, int64_t value)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
 
         EventLoop *loop_;
         Socket acceptSocket_;
         Channel acceptChannel_;
         NewConnectionCallback newConnectionCallback_;
         bool listenning_;
+        int idleFd_; // fd 耗尽时先关掉它腾出一个位置，接下连接再关闭，避免水平触发下反复可读
+        int acceptBatch_;
+        std::vector<int> pendingAccepts_; // 多发 accept 已接受、超出本轮批量的连接
+        std::shared_ptr<char> alive_;     // 排到下一轮的任务据此判断 Acceptor 是否已析构
+        std::atomic<int64_t> accepted_;
+        std::atomic<int64_t> wakeups_;
+        std::atomic<int64_t> maxBatch_;
+        std::atomic<int64_t> shed_;
+        std::atomic<int64_t> errors_;
     };
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Buffer.hpp"
+#include "ByteScan.hpp"
 #include "Logger.hpp"
 #include <errno.h>
 #include <cstring>
@@ -6,20 +7,48 @@
 #include <cassert>
 namespace net
 {
+    char Buffer::emptyStorage_[Buffer::kCheapPrepend];
+
     const char *Buffer::findCRLF() const
     {
-        const char *crlf = std::search(peek(), beginWrite(), "\r\n", "\r\n" + 2);
-        return crlf == beginWrite() ? nullptr : crlf;
+        return findCRLF(peek());
     }
     const char *Buffer::findCRLF(const char *start) const
     {
-        const char *crlf = std::search(start, beginWrite(), "\r\n", "\r\n" + 2);
+        const char *crlf = base::scan::findCRLF(start, beginWrite());
+        return crlf == beginWrite() ? nullptr : crlf;
+    }
+    const char *Buffer::findCRLFCRLF() const
+    {
+        return findCRLFCRLF(peek());
+    }
+    const char *Buffer::findCRLFCRLF(const char *start) const
+    {
+        const char *crlf = base::scan::findCRLFCRLF(start, beginWrite());
         return crlf == beginWrite() ? nullptr : crlf;
     }
+    const char *Buffer::findAnyOf(const char *set, size_t setSize) const
+    {
+        return findAnyOf(peek(), set, setSize);
+    }
+    const char *Buffer::findAnyOf(const char *start, const char *set, size_t setSize) const
+    {
+        const char *hit = base::scan::findAnyOf(start, beginWrite(), set, setSize);
+        return hit == beginWrite() ? nullptr : hit;
+    }
+    const char *Buffer::findByte(char c) const
+    {
+        return findByte(peek(), c);
+    }
+    const char *Buffer::findByte(const char *start, char c) const
+    {
+        const char *hit = base::scan::findByte(start, beginWrite(), c);
+        return hit == beginWrite() ? nullptr : hit;
+    }
 
     void Buffer::retrieve(size_t len)
     {
-        if (len < writableBytes())
+        if (len < readableBytes())
         {
             readIndex_ += len;
         }
@@ -59,7 +88,11 @@ namespace net
 
     void Buffer::ensureWritableBytes(size_t len)
     {
-        if (writableBytes() < len)
+        if (buffer_.empty() && len > 0)
+        {
+            buffer_.resize(kCheapPrepend + std::max(initialSize_, len));
+        }
+        else if (writableBytes() < len)
         {
             makeSpace(len);
         }
@@ -74,24 +107,46 @@ namespace net
         else
         {
             size_t readable = readableBytes();
-            std::copy(begin(), begin() + readIndex_, begin() + kCheapPrepend);
+            std::copy(begin() + readIndex_, begin() + writeIndex_, begin() + kCheapPrepend);
             readIndex_ = kCheapPrepend;
             writeIndex_ = readIndex_ + readable;
         }
     }
 
+    void Buffer::shrink()
+    {
+        const size_t readable = readableBytes();
+        if (readable == 0)
+        {
+            std::vector<char>().swap(buffer_);
+        }
+        else
+        {
+            std::vector<char> compact(kCheapPrepend + readable);
+            std::copy(peek(), peek() + readable, compact.begin() + kCheapPrepend);
+            buffer_.swap(compact);
+        }
+        readIndex_ = kCheapPrepend;
+        writeIndex_ = kCheapPrepend + readable;
+    }
+
     ssize_t Buffer::readFd(int fd, int *savedErrno)
     {
         // 创建临时缓冲区以避免缓冲区膨胀
         char extrabuf[65536];
+        return readFd(fd, savedErrno, extrabuf, sizeof(extrabuf));
+    }
+
+    ssize_t Buffer::readFd(int fd, int *savedErrno, char *scratch, size_t scratchSize)
+    {
         struct iovec vec[2];
         const size_t writable = writableBytes();
         vec[0].iov_base = begin() + writeIndex_;
         vec[0].iov_len = writable;
-        vec[1].iov_base = extrabuf;
-        vec[1].iov_len = sizeof(extrabuf);
+        vec[1].iov_base = scratch;
+        vec[1].iov_len = scratchSize;
 
-        const int iovcnt = writable < sizeof(extrabuf) ? 2 : 1;
+        const int iovcnt = writable < scratchSize ? 2 : 1;
         const ssize_t n = ::readv(fd, vec, iovcnt);
         if (n < 0)
         {
@@ -103,8 +158,8 @@ namespace net
         }
         else
         {
-            writeIndex_ = buffer_.size();
-            append(extrabuf, n - writable);
+            writeIndex_ += writable;
+            append(scratch, n - writable);
         }
 
         return n;
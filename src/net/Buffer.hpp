@@ -10,22 +10,44 @@ namespace net
     public:
         static const size_t kCheapPrepend = 8;
         static const size_t kInitialSize = 1024;
+        // 存储在第一次写入时才分配，空闲连接的收发缓冲区不占堆内存
         explicit Buffer(size_t initialSize = kInitialSize)
-            : buffer_(kCheapPrepend + initialSize), readIndex_(kCheapPrepend), writeIndex_(kCheapPrepend)
+            : initialSize_(initialSize), readIndex_(kCheapPrepend), writeIndex_(kCheapPrepend)
         {
         }
 
         size_t readableBytes() const { return writeIndex_ - readIndex_; }
-        size_t writableBytes() const { return buffer_.size() - writeIndex_; }
+        size_t writableBytes() const { return buffer_.empty() ? 0 : buffer_.size() - writeIndex_; }
         size_t prependableBytes() const { return readIndex_; }
+        size_t capacity() const { return buffer_.capacity(); }
+        // 只影响下一次分配存储时的容量
+        void setInitialSize(size_t initialSize) { initialSize_ = initialSize; }
+        // 释放多余容量：没有未读数据时整块归还，否则收缩到刚好容纳未读数据
+        void shrink();
+        // 交换存储和读写位置，不拷贝数据；初始容量设置留在各自对象上
+        void swap(Buffer &rhs)
+        {
+            buffer_.swap(rhs.buffer_);
+            std::swap(readIndex_, rhs.readIndex_);
+            std::swap(writeIndex_, rhs.writeIndex_);
+        }
 
         const char *peek() const { return begin() + readIndex_; }
 
         char *beginWrite() { return begin() + writeIndex_; }
         const char *beginWrite() const { return begin() + writeIndex_; }
 
+        // 分隔符查找走 base::scan 的向量实现，找不到返回 nullptr
         const char *findCRLF() const;
         const char *findCRLF(const char *start) const;
+        const char *findCRLFCRLF() const;
+        const char *findCRLFCRLF(const char *start) const;
+        // set 中任一字节首次出现的位置
+        const char *findAnyOf(const char *set, size_t setSize) const;
+        const char *findAnyOf(const char *start, const char *set, size_t setSize) const;
+        // 单字节查找，如 RTSP 交织帧的 '$'
+        const char *findByte(char c) const;
+        const char *findByte(const char *start, char c) const;
 
         void retrieve(size_t len);
         void retrieveUntil(const char *delim);
@@ -44,17 +66,22 @@ namespace net
         }
 
         ssize_t readFd(int fd, int *savedErrno);
+        // 先读进剩余空间，放不下的部分落到调用方提供的 scratch 再追加
+        ssize_t readFd(int fd, int *savedErrno, char *scratch, size_t scratchSize);
         ssize_t writeFd(int fd, int *savedErrno);
 
     private:
         std::vector<char> buffer_;
+        size_t initialSize_;
         size_t readIndex_;
         size_t writeIndex_;
 
     private:
-        const char *begin() const { return &*buffer_.begin(); }
-        char *begin() { return &*buffer_.begin(); }
+        // 尚未分配时指向一段静态的预留区，peek()/beginWrite() 仍是合法的空区间
+        const char *begin() const { return buffer_.empty() ? emptyStorage_ : buffer_.data(); }
+        char *begin() { return buffer_.empty() ? emptyStorage_ : buffer_.data(); }
         void ensureWritableBytes(size_t len);
+        static char emptyStorage_[kCheapPrepend];
         void makeSpace(size_t len);
     };
 }
\ No newline at end of file
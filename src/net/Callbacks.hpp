@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include "Buffer.hpp"
@@ -9,12 +10,16 @@ namespace net
     class TcpConnection;
     class EventLoop;
     class Session;
+    class RingBuffer;
 
     using TcpConnectionPtr = std::shared_ptr<TcpConnection>;
     using SessionPtr = std::shared_ptr<Session>;
+    // 服务端连接 ID，编码所属 loop 序号与槽位，见 ConnectionRegistry
+    using ConnectionId = uint64_t;
 
     using ConnectionCallback = std::function<void(const TcpConnectionPtr &)>;
     using MessageCallback = std::function<void(const TcpConnectionPtr &, Buffer *, base::Timestamp)>;
+    using RingMessageCallback = std::function<void(const TcpConnectionPtr &, RingBuffer *, base::Timestamp)>;
     using WriteCompleteCallback = std::function<void(const TcpConnectionPtr &)>;
     using CloseCallback = std::function<void(const TcpConnectionPtr &)>;
     using ErrorCallback = std::function<void(const TcpConnectionPtr &, const std::string &)>;
@@ -0,0 +1,343 @@
+#include "ChainBuffer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+namespace net
+{
+    ChainBuffer::ChainBuffer(base::BlockPool *pool)
+        : pool_(pool), head_(0), readable_(0), zeroCopyMinBytes_(0), zeroCopySeq_(0)
+    {
+    }
+
+    ChainBuffer::~ChainBuffer()
+    {
+        retrieveAll();
+    }
+
+    void ChainBuffer::append(const char *data, size_t len)
+    {
+        readable_ += len;
+        while (len > 0)
+        {
+            if (head_ == slabs_.size() || !slabs_.back().pooled() || slabs_.back().writeIndex == kSlabSize)
+            {
+                pushSlab(Slab{static_cast<char *>(pool_->allocate(kSlabSize)), 0, 0, SharedSlice()});
+            }
+            Slab &tail = slabs_.back();
+            const size_t n = std::min(len, kSlabSize - tail.writeIndex);
+            std::memcpy(tail.data + tail.writeIndex, data, n);
+            tail.writeIndex += n;
+            data += n;
+            len -= n;
+        }
+    }
+
+    void ChainBuffer::append(const SharedSlice &slice)
+    {
+        if (slice.size() <= kCopySliceBytes)
+        {
+            append(slice.data(), slice.size());
+            return;
+        }
+        readable_ += slice.size();
+        pushSlab(Slab{const_cast<char *>(slice.data()), 0, slice.size(), slice});
+    }
+
+    void ChainBuffer::appendFile(int fd, off_t offset, size_t len)
+    {
+        if (len == 0)
+        {
+            return;
+        }
+        struct stat st;
+        Slab slab{nullptr, 0, len, SharedSlice()};
+        slab.fd = fd;
+        slab.pipe = ::fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode);
+        slab.fileOffset = offset;
+        readable_ += len;
+        pushSlab(std::move(slab));
+    }
+
+    void ChainBuffer::pushSlab(Slab &&slab)
+    {
+        if (head_ > 0 && slabs_.size() == slabs_.capacity())
+        {
+            slabs_.erase(slabs_.begin(), slabs_.begin() + static_cast<std::ptrdiff_t>(head_));
+            head_ = 0;
+        }
+        slabs_.push_back(std::move(slab));
+    }
+
+    void ChainBuffer::retrieve(size_t len)
+    {
+        len = std::min(len, readable_);
+        readable_ -= len;
+        while (len > 0)
+        {
+            Slab &head = slabs_[head_];
+            const size_t n = std::min(len, head.writeIndex - head.readIndex);
+            head.readIndex += n;
+            len -= n;
+            if (head.readIndex == head.writeIndex)
+            {
+                releaseFront();
+            }
+        }
+    }
+
+    void ChainBuffer::retrieveAll()
+    {
+        while (head_ < slabs_.size())
+        {
+            releaseFront();
+        }
+        readable_ = 0;
+    }
+
+    void ChainBuffer::shrink()
+    {
+        if (readable_ == 0)
+        {
+            retrieveAll();
+            std::vector<Slab>().swap(slabs_);
+        }
+        if (pinned_.empty())
+        {
+            std::vector<Pinned>().swap(pinned_);
+        }
+    }
+
+    void ChainBuffer::releaseFront()
+    {
+        Slab &head = slabs_[head_];
+        if (head.pooled())
+        {
+            pool_->deallocate(head.data, kSlabSize);
+        }
+        else
+        {
+            head.shared = SharedSlice();
+            head.fd = -1;
+        }
+        if (++head_ == slabs_.size())
+        {
+            slabs_.clear();
+            head_ = 0;
+        }
+    }
+
+    ssize_t ChainBuffer::writeFd(int fd, int *savedErrno, size_t maxBytes, size_t *offered, int flags)
+    {
+        if (head_ < slabs_.size() && slabs_[head_].fd >= 0)
+        {
+            Slab &head = slabs_[head_];
+            if (offered)
+            {
+                *offered = std::min(head.writeIndex - head.readIndex, maxBytes);
+            }
+            return sendFile(head, fd, savedErrno, maxBytes);
+        }
+
+        if (head_ < slabs_.size() && zeroCopyEligible(slabs_[head_].shared.size()))
+        {
+            const ssize_t n = sendZeroCopy(fd, savedErrno, maxBytes, offered, flags);
+            if (n >= 0 || *savedErrno != ENOBUFS)
+            {
+                return n;
+            }
+            // 通知占满了 socket 的 optmem，这次退回普通拷贝
+        }
+
+        struct iovec vec[IOV_MAX];
+        size_t bytes = 0;
+        const int iovcnt = gather(vec, IOV_MAX, maxBytes, &bytes);
+        if (offered)
+        {
+            *offered = bytes;
+        }
+        ssize_t n;
+        if (flags == 0)
+        {
+            n = ::writev(fd, vec, iovcnt);
+        }
+        else
+        {
+            struct msghdr msg = {};
+            msg.msg_iov = vec;
+            msg.msg_iovlen = static_cast<size_t>(iovcnt);
+            n = ::sendmsg(fd, &msg, flags);
+        }
+        if (n < 0)
+        {
+            *savedErrno = errno;
+        }
+        else
+        {
+            retrieve(static_cast<size_t>(n));
+        }
+        return n;
+    }
+
+    int ChainBuffer::gather(struct iovec *vec, int maxIov, size_t maxBytes, size_t *bytes) const
+    {
+        int iovcnt = 0;
+        *bytes = 0;
+        for (auto it = slabs_.begin() + static_cast<std::ptrdiff_t>(head_); it != slabs_.end() && it->fd < 0 && iovcnt < maxIov && *bytes < maxBytes; ++it)
+        {
+            if (iovcnt > 0 && zeroCopyEligible(it->shared.size()))
+            {
+                break; // 后面的大共享段留给下一次，到达队首后用 MSG_ZEROCOPY 发送
+            }
+            const size_t len = std::min(it->writeIndex - it->readIndex, maxBytes - *bytes);
+            vec[iovcnt].iov_base = it->data + it->readIndex;
+            vec[iovcnt].iov_len = len;
+            ++iovcnt;
+            *bytes += len;
+        }
+        return iovcnt;
+    }
+
+    int ChainBuffer::peekIovecs(struct iovec *vec, int maxIov, size_t maxBytes) const
+    {
+        if (head_ == slabs_.size() || slabs_[head_].fd >= 0 || zeroCopyEligible(slabs_[head_].shared.size()))
+        {
+            return 0; // 文件段和零拷贝段仍由 writeFd 同步发送
+        }
+        size_t bytes = 0;
+        return gather(vec, maxIov, maxBytes, &bytes);
+    }
+
+    ssize_t ChainBuffer::sendFile(Slab &slab, int fd, int *savedErrno, size_t maxBytes)
+    {
+        const size_t len = std::min(slab.writeIndex - slab.readIndex, maxBytes);
+        ssize_t n;
+        if (slab.pipe)
+        {
+            n = ::splice(slab.fd, nullptr, fd, nullptr, len, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        }
+        else
+        {
+            off_t offset = slab.fileOffset + static_cast<off_t>(slab.readIndex);
+            n = ::sendfile(fd, slab.fd, &offset, len);
+        }
+        if (n < 0)
+        {
+            *savedErrno = errno;
+        }
+        else if (n == 0 && len > 0)
+        {
+            // 文件比排队的区间短（被截断或管道写端已关闭），后续数据无法按序发出
+            *savedErrno = EIO;
+            n = -1;
+        }
+        else
+        {
+            retrieve(static_cast<size_t>(n));
+        }
+        return n;
+    }
+
+    ssize_t ChainBuffer::sendZeroCopy(int fd, int *savedErrno, size_t maxBytes, size_t *offered, int flags)
+    {
+        // 连续的大共享段放进同一次 sendmsg，共用一个通知序号
+        struct iovec vec[IOV_MAX];
+        int iovcnt = 0;
+        size_t bytes = 0;
+        for (auto it = slabs_.begin() + static_cast<std::ptrdiff_t>(head_);
+             it != slabs_.end() && zeroCopyEligible(it->shared.size()) && iovcnt < IOV_MAX && bytes < maxBytes; ++it)
+        {
+            const size_t len = std::min(it->writeIndex - it->readIndex, maxBytes - bytes);
+            vec[iovcnt].iov_base = it->data + it->readIndex;
+            vec[iovcnt].iov_len = len;
+            ++iovcnt;
+            bytes += len;
+        }
+        if (offered)
+        {
+            *offered = bytes;
+        }
+        struct msghdr msg = {};
+        msg.msg_iov = vec;
+        msg.msg_iovlen = static_cast<size_t>(iovcnt);
+        const ssize_t n = ::sendmsg(fd, &msg, MSG_ZEROCOPY | MSG_NOSIGNAL | flags);
+        if (n < 0)
+        {
+            *savedErrno = errno;
+            return n;
+        }
+        // 内核只在有数据发出时消耗序号；写出的部分在完成通知前不能释放
+        size_t remaining = static_cast<size_t>(n);
+        for (size_t i = head_; remaining > 0; ++i)
+        {
+            const size_t len = std::min(remaining, slabs_[i].writeIndex - slabs_[i].readIndex);
+            pinned_.push_back(Pinned{zeroCopySeq_, len, slabs_[i].shared});
+            remaining -= len;
+        }
+        if (n > 0)
+        {
+            ++zeroCopySeq_;
+        }
+        retrieve(static_cast<size_t>(n));
+        return n;
+    }
+
+    int ChainBuffer::reapZeroCopy(int fd, size_t *sent, size_t *copied, int *errors, int *lastErrno)
+    {
+        int notifications = 0;
+        for (;;)
+        {
+            char control[128];
+            struct msghdr msg = {};
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            if (::recvmsg(fd, &msg, MSG_ERRQUEUE) < 0)
+            {
+                break; // EAGAIN：队列已读空
+            }
+            for (cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg, cm))
+            {
+                if (!((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+                      (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR)))
+                {
+                    continue;
+                }
+                const sock_extended_err *err = reinterpret_cast<const sock_extended_err *>(CMSG_DATA(cm));
+                if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                {
+                    // 已经从队列取走，交给调用方处理，不能悄悄丢掉
+                    ++*errors;
+                    *lastErrno = static_cast<int>(err->ee_errno);
+                    continue;
+                }
+                // 通知覆盖序号区间 [ee_info, ee_data]，序号按 32 位回绕
+                const uint32_t lo = err->ee_info;
+                const uint32_t span = err->ee_data - lo;
+                const bool wasCopied = (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0;
+                auto done = std::remove_if(pinned_.begin(), pinned_.end(), [&](const Pinned &pin)
+                                           {
+                                               if (pin.seq - lo > span)
+                                               {
+                                                   return false;
+                                               }
+                                               *sent += pin.bytes;
+                                               if (wasCopied)
+                                               {
+                                                   *copied += pin.bytes;
+                                               }
+                                               return true; });
+                pinned_.erase(done, pinned_.end());
+                ++notifications;
+            }
+        }
+        return notifications;
+    }
+}
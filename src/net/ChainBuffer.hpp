@@ -0,0 +1,98 @@
+#pragma once
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include "BlockPool.hpp"
+#include "Noncopyable.hpp"
+#include "SharedSlice.hpp"
+
+namespace net
+{
+    // 分段发送缓冲区：数据存放在一串定长 slab 中，slab 来自所属 loop 的内存池。
+    // 在已有数据后面追加大帧只会补新 slab，不会整体扩容和搬移；
+    // 用 writev 一次写出多个 slab，写完的 slab 立即还给内存池。
+    // SharedSlice 按引用排队，写完该段时释放引用；文件区间也按序排队，轮到时用 sendfile/splice 发送。
+    // 开启零拷贝后，大的 SharedSlice 段用 MSG_ZEROCOPY 发送，引用保留到内核的完成通知到达。
+    // 只在 loop 线程中使用
+    class ChainBuffer : base::Noncopyable
+    {
+    public:
+        static constexpr size_t kSlabSize = 16 * 1024;
+        // 不超过该长度的 SharedSlice 直接拷贝进 slab，比单独占一段更省
+        static constexpr size_t kCopySliceBytes = 256;
+
+        explicit ChainBuffer(base::BlockPool *pool);
+        ~ChainBuffer();
+
+        size_t readableBytes() const { return readable_; }
+        size_t slabCount() const { return slabs_.size() - head_; }
+        // 等待 MSG_ZEROCOPY 完成通知而保留的段数
+        size_t pinnedCount() const { return pinned_.size(); }
+
+        // 不小于 minBytes 的 SharedSlice 段改用 sendmsg(MSG_ZEROCOPY)，0 表示关闭。
+        // 调用方需先在 socket 上打开 SO_ZEROCOPY，否则内核忽略该标志且不会有完成通知
+        void setZeroCopyThreshold(size_t minBytes) { zeroCopyMinBytes_ = minBytes; }
+        bool zeroCopyEligible(size_t len) const { return zeroCopyMinBytes_ > 0 && len >= zeroCopyMinBytes_; }
+        // 读空 fd 的错误队列，释放已完成的段；sent、copied 累加确认的字节数，copied 为内核退回拷贝的部分。
+        // 队列里不是零拷贝完成通知的条目（ICMP、本地错误）或失败的通知累加到 errors，lastErrno 为最后一条的 ee_errno。
+        // 返回处理的完成通知数
+        int reapZeroCopy(int fd, size_t *sent, size_t *copied, int *errors, int *lastErrno);
+
+        void append(const char *data, size_t len);
+        void append(const void *data, size_t len) { append(static_cast<const char *>(data), len); }
+        void append(const SharedSlice &slice);
+        // 排队文件 fd 的 [offset, offset + len)，不转移 fd 所有权；管道用 splice 发送，忽略 offset
+        void appendFile(int fd, off_t offset, size_t len);
+        void retrieve(size_t len);
+        void retrieveAll();
+        // 没有排队数据和待确认的零拷贝段时释放段表占用的内存
+        void shrink();
+
+        // 用 writev 写出最多 maxBytes 字节（最多 IOV_MAX 段，遇到文件段或可零拷贝的段为止），返回值与 errno 语义同 writev。
+        // 首段是文件时改用 sendfile/splice；文件提前结束时返回 -1，errno 为 EIO。
+        // offered 非空时返回本次交给系统调用的字节数，返回值小于它说明是短写。
+        // flags 非 0 时改用 sendmsg 并带上这些标志（如 MSG_MORE），文件段忽略
+        ssize_t writeFd(int fd, int *savedErrno, size_t maxBytes = static_cast<size_t>(-1), size_t *offered = nullptr, int flags = 0);
+        // 从头收集最多 maxIov 个内存段、maxBytes 字节，遇到文件段或可零拷贝的段为止，不取出数据；首段是文件或零拷贝段时返回 0。
+        // 供异步提交发送使用，完成前这些段既不能取出也不会被追加覆盖
+        int peekIovecs(struct iovec *vec, int maxIov, size_t maxBytes = static_cast<size_t>(-1)) const;
+
+    private:
+        struct Slab
+        {
+            char *data;
+            size_t readIndex;
+            size_t writeIndex;
+            SharedSlice shared; // 非空时 data 指向共享内存，不可追加，也不还给内存池
+            int fd = -1;        // >= 0 时为文件段，data 为空，[readIndex, writeIndex) 是相对 fileOffset 的区间
+            bool pipe = false;
+            off_t fileOffset = 0;
+
+            bool pooled() const { return fd < 0 && shared.empty(); }
+        };
+        // 已交给内核、等待完成通知的零拷贝段，seq 为该次 sendmsg 的通知序号
+        struct Pinned
+        {
+            uint32_t seq;
+            size_t bytes;
+            SharedSlice slice;
+        };
+        // 从头收集连续的内存段，bytes 返回总长度；首段之后遇到可零拷贝的段即停止
+        int gather(struct iovec *vec, int maxIov, size_t maxBytes, size_t *bytes) const;
+        ssize_t sendFile(Slab &slab, int fd, int *savedErrno, size_t maxBytes);
+        ssize_t sendZeroCopy(int fd, int *savedErrno, size_t maxBytes, size_t *offered, int flags);
+        void pushSlab(Slab &&slab);
+        void releaseFront();
+
+        base::BlockPool *pool_;
+        std::vector<Slab> slabs_; // [head_, size) 为有效 slab；不用 deque，空缓冲区不占堆内存
+        size_t head_;
+        size_t readable_;
+        size_t zeroCopyMinBytes_;
+        uint32_t zeroCopySeq_; // 与内核按 socket 递增的通知序号保持一致
+        std::vector<Pinned> pinned_;
+    };
+}
@@ -19,7 +19,17 @@ namespace net
           events_(0),
           revents_(0),
           index_(-1),
+          committedEvents_(kNoneEvent),
+          updatePending_(false),
+          registeredEvents_(kNoneEvent),
           addedToLoop_(false),
+          edgeTriggered_(false),
+          completedReadEnabled_(false),
+          completedRead_(false),
+          completedReadStatus_(1),
+          completedWrite_(false),
+          completedWriteResult_(0),
+          completedAcceptEnabled_(false),
           eventHandling_(false),
           readCallback_(nullptr),
           writeCallback_(nullptr),
@@ -38,6 +48,12 @@ namespace net
 
     void Channel::update()
     {
+        const int pollEvents = this->pollEvents();
+        if (edgeTriggered_ && addedToLoop_ && pollEvents == registeredEvents_)
+        {
+            return; // 边沿触发下注册掩码没变，无需重新 arm
+        }
+        registeredEvents_ = pollEvents;
         addedToLoop_ = true;
         loop_->updateChannel(this);
     }
@@ -45,13 +61,50 @@ namespace net
     void Channel::remove()
     {
         addedToLoop_ = false;
+        registeredEvents_ = kNoneEvent;
         loop_->removeChannel(this);
     }
 
+    void Channel::setEdgeTriggered(bool on)
+    {
+        edgeTriggered_ = on;
+        if (addedToLoop_)
+        {
+            update();
+        }
+    }
+
+    void Channel::addCompletedRead(const char *data, size_t len)
+    {
+        completedRead_ = true;
+        completedReadChunks_.push_back(ReadChunk{data, len});
+    }
+
+    void Channel::setCompletedReadStatus(int status)
+    {
+        completedRead_ = true;
+        completedReadStatus_ = status;
+    }
+
+    void Channel::setCompletedWrite(int result)
+    {
+        completedWrite_ = true;
+        completedWriteResult_ = result;
+    }
+
+    int Channel::pollEvents() const
+    {
+        if (!edgeTriggered_ || events_ == kNoneEvent)
+        {
+            return events_;
+        }
+        return kReadEvent | kWriteEvent | static_cast<int>(EPOLLET);
+    }
+
     void Channel::handleEvent(Timestamp receiveTime)
     {
         eventHandling_ = true;
-        LOG_WARN("%s", eventsToString(fd_, revents_).c_str());
+        LOG_DEBUG("%s", eventsToString(fd_, revents_).c_str());
         if (revents_ & POLLHUP && !(revents_ & POLLIN))
         {
             if (closeCallback_)
@@ -65,6 +118,42 @@ namespace net
             {
                 errorCallback_();
             }
+            // 回调清掉 POLLERR 表示只是错误队列中的通知（如 MSG_ZEROCOPY 完成），同时到达的读写照常处理
+            if (!(revents_ & POLLERR))
+            {
+                handleReadWrite(receiveTime);
+            }
+        }
+        else
+        {
+            handleReadWrite(receiveTime);
+        }
+        if (completedRead_)
+        {
+            // poller 会在下一轮回收这些缓冲区
+            completedRead_ = false;
+            completedReadStatus_ = 1;
+            completedReadChunks_.clear();
+        }
+        completedWrite_ = false;
+        completedAccepts_.clear();
+        eventHandling_ = false;
+    }
+
+    void Channel::handleReadWrite(Timestamp receiveTime)
+    {
+        if (edgeTriggered_)
+        {
+            // 边沿触发下可读、可写可能同时到达，只处理一个就会丢掉另一个边沿；
+            // 注册掩码读写全开，按本地关注位过滤
+            if ((revents_ & (POLLIN | POLLPRI)) && (isReading() || completedRead_) && readCallback_)
+            {
+                readCallback_(receiveTime);
+            }
+            if ((revents_ & POLLOUT) && (isWriting() || completedWrite_) && writeCallback_)
+            {
+                writeCallback_();
+            }
         }
         else if (revents_ & (POLLIN | POLLPRI))
         {
@@ -72,6 +161,11 @@ namespace net
             {
                 readCallback_(receiveTime);
             }
+            // 完成式写的结果只报告一次，和读同时到达时不能像可写通知那样留到下一轮
+            if (completedWrite_ && writeCallback_)
+            {
+                writeCallback_();
+            }
         }
         else if (revents_ & POLLOUT)
         {
@@ -80,8 +174,8 @@ namespace net
                 writeCallback_();
             }
         }
-        eventHandling_ = false;
     }
+
     std::string eventsToString(int fd, int ev)
     {
         std::ostringstream oss;
@@ -1,15 +1,19 @@
 #pragma once
 #include <functional>
 #include <memory>
+#include <vector>
 #include "Timer.hpp"
+#include "InlineFunction.hpp"
+struct iovec;
+
 namespace net
 {
     class EventLoop;
     class Channel
     {
     public:
-        using EventCallback = std::function<void()>;
-        using ReadEventCallback = std::function<void(base::Timestamp)>;
+        using EventCallback = base::InlineFunction<void()>;
+        using ReadEventCallback = base::InlineFunction<void(base::Timestamp)>;
 
         Channel(EventLoop *loop, int fd);
         ~Channel();
@@ -51,6 +55,52 @@ namespace net
 
         bool isNoneEvent() const { return events_ == kNoneEvent; }
 
+        // 边沿触发模式：注册掩码固定为读写全开加 EPOLLET，开关读写只改本地关注位，不再 epoll_ctl。
+        // 回调必须把数据读写到 EAGAIN 为止，否则不会再收到通知
+        void setEdgeTriggered(bool on);
+        bool isEdgeTriggered() const { return edgeTriggered_; }
+        // 实际注册到 poller 的事件掩码
+        int pollEvents() const;
+
+        // 完成式读：支持的 poller（io_uring 多发 recv）直接把数据收进自己的缓冲区再触发读回调，
+        // 数据只在本次读回调期间有效；其他 poller 忽略此设置，照常报告可读
+        struct ReadChunk
+        {
+            const char *data;
+            size_t len;
+        };
+        void setCompletedReadEnabled(bool on) { completedReadEnabled_ = on; }
+        bool completedReadEnabled() const { return completedReadEnabled_; }
+        bool hasCompletedRead() const { return completedRead_; }
+        const std::vector<ReadChunk> &completedReadChunks() const { return completedReadChunks_; }
+        int completedReadStatus() const { return completedReadStatus_; } // 1 正常，0 对端关闭，<0 为 -errno
+        void addCompletedRead(const char *data, size_t len);
+        void setCompletedReadStatus(int status);
+
+        // 完成式写：关注可写时，支持的 poller（io_uring）向 writeSource 取待发数据的 iovec 直接提交 sendmsg，
+        // 完成后以写回调报告结果。writeSource 返回 0 段时退回可写通知；iovec 指向的数据须保持到结果报告为止。
+        // owner 持有这些数据：注销 channel 时若发送仍在途，poller 保留 owner 的引用，直到内核不再读取
+        using WriteSource = base::InlineFunction<int(struct iovec *vec, int maxIov, int *flags)>;
+        void setCompletedWriteSource(WriteSource source, const std::shared_ptr<void> &owner)
+        {
+            writeSource_ = std::move(source);
+            writeOwner_ = owner;
+        }
+        bool completedWriteEnabled() const { return static_cast<bool>(writeSource_); }
+        std::shared_ptr<void> completedWriteOwner() const { return writeOwner_.lock(); }
+        int prepareCompletedWrite(struct iovec *vec, int maxIov, int *flags) { return writeSource_(vec, maxIov, flags); }
+        bool hasCompletedWrite() const { return completedWrite_; }
+        int completedWriteResult() const { return completedWriteResult_; } // 写出的字节数，<0 为 -errno
+        void setCompletedWrite(int result);
+
+        // 完成式接受：监听 socket 在支持的 poller（io_uring 多发 accept）上由内核直接接受连接，
+        // 新连接的 fd（<0 为 -errno）随读回调交付，回调须接管全部 fd；其他 poller 照常报告可读
+        void setCompletedAcceptEnabled(bool on) { completedAcceptEnabled_ = on; }
+        bool completedAcceptEnabled() const { return completedAcceptEnabled_; }
+        bool hasCompletedAccept() const { return !completedAccepts_.empty(); }
+        const std::vector<int> &completedAccepts() const { return completedAccepts_; }
+        void addCompletedAccept(int fd) { completedAccepts_.push_back(fd); }
+
         int fd() const { return fd_; }
 
         int events() const { return events_; }
@@ -60,6 +110,12 @@ namespace net
         int index() const { return index_; }
         void setIndex(int idx) { index_ = idx; }
 
+        // 供 poller 推迟提交使用：内核中已生效的掩码，以及是否在待刷新列表中
+        int committedEvents() const { return committedEvents_; }
+        void setCommittedEvents(int events) { committedEvents_ = events; }
+        bool updatePending() const { return updatePending_; }
+        void setUpdatePending(bool pending) { updatePending_ = pending; }
+
         void setRevents(int revt) { revents_ = revt; }
         int revents() const { return revents_; }
 
@@ -76,7 +132,21 @@ namespace net
         int events_;
         int revents_;
         int index_;
+        int committedEvents_;
+        bool updatePending_;
+        int registeredEvents_; // 最近一次提交给 poller 的掩码
         bool addedToLoop_;
+        bool edgeTriggered_;
+        bool completedReadEnabled_;
+        bool completedRead_;
+        int completedReadStatus_;
+        std::vector<ReadChunk> completedReadChunks_;
+        WriteSource writeSource_;
+        std::weak_ptr<void> writeOwner_;
+        bool completedWrite_;
+        int completedWriteResult_;
+        bool completedAcceptEnabled_;
+        std::vector<int> completedAccepts_;
         bool eventHandling_;
 
         ReadEventCallback readCallback_;
@@ -84,6 +154,7 @@ namespace net
         EventCallback closeCallback_;
         EventCallback errorCallback_;
         void update();
+        void handleReadWrite(base::Timestamp receiveTime);
     };
 
     std::string eventsToString(int fd, int ev);
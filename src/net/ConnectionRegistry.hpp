@@ -0,0 +1,125 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Callbacks.hpp"
+#include "Noncopyable.hpp"
+
+namespace net
+{
+    // 槽位表：按 64 位 ID 做 O(1) 插入、查找、删除，空闲槽位串成 LIFO 链表复用（刚释放的槽位还在缓存里）。
+    // ID 布局：高 16 位 loop 序号，中间 16 位槽位代数，低 32 位槽位下标；槽位每释放一次代数加一，
+    // 过期 ID 查不到新连接。只在所属 loop 线程中访问，不加锁。Ptr 须可判空（智能指针）
+    template <typename Ptr>
+    class SlotTable : base::Noncopyable
+    {
+    public:
+        static constexpr uint32_t kNoSlot = 0xffffffffu;
+
+        explicit SlotTable(uint16_t loopIndex = 0)
+            : loopIndex_(loopIndex), freeHead_(kNoSlot), size_(0)
+        {
+        }
+
+        static ConnectionId makeId(uint16_t loopIndex, uint16_t generation, uint32_t slot)
+        {
+            return (static_cast<ConnectionId>(loopIndex) << 48) | (static_cast<ConnectionId>(generation) << 32) | slot;
+        }
+        static uint16_t loopOf(ConnectionId id) { return static_cast<uint16_t>(id >> 48); }
+        static uint16_t generationOf(ConnectionId id) { return static_cast<uint16_t>(id >> 32); }
+        static uint32_t slotOf(ConnectionId id) { return static_cast<uint32_t>(id); }
+
+        ConnectionId insert(Ptr value)
+        {
+            uint32_t slot = freeHead_;
+            if (slot != kNoSlot)
+            {
+                freeHead_ = slots_[slot].nextFree;
+            }
+            else
+            {
+                slot = static_cast<uint32_t>(slots_.size());
+                slots_.emplace_back();
+            }
+            Slot &entry = slots_[slot];
+            entry.value = std::move(value);
+            entry.nextFree = kNoSlot;
+            ++size_;
+            return makeId(loopIndex_, entry.generation, slot);
+        }
+
+        // 不存在或 ID 已过期返回 nullptr
+        const Ptr *find(ConnectionId id) const
+        {
+            const Slot *entry = lookup(id);
+            return entry ? &entry->value : nullptr;
+        }
+
+        // 返回被删除的值，不存在时返回空
+        Ptr erase(ConnectionId id)
+        {
+            Slot *entry = const_cast<Slot *>(lookup(id));
+            if (!entry)
+            {
+                return Ptr();
+            }
+            Ptr value = std::move(entry->value);
+            entry->value = Ptr();
+            ++entry->generation;
+            entry->nextFree = freeHead_;
+            freeHead_ = slotOf(id);
+            --size_;
+            return value;
+        }
+
+        template <typename Func>
+        void forEach(Func &&func) const
+        {
+            for (size_t i = 0; i < slots_.size(); ++i)
+            {
+                if (slots_[i].value)
+                {
+                    func(makeId(loopIndex_, slots_[i].generation, static_cast<uint32_t>(i)), slots_[i].value);
+                }
+            }
+        }
+
+        void clear()
+        {
+            slots_.clear();
+            freeHead_ = kNoSlot;
+            size_ = 0;
+        }
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        size_t capacity() const { return slots_.size(); }
+
+    private:
+        struct Slot
+        {
+            Ptr value;
+            uint16_t generation = 0;
+            uint32_t nextFree = kNoSlot;
+        };
+
+        const Slot *lookup(ConnectionId id) const
+        {
+            uint32_t slot = slotOf(id);
+            if (loopOf(id) != loopIndex_ || slot >= slots_.size())
+            {
+                return nullptr;
+            }
+            const Slot &entry = slots_[slot];
+            return entry.value && entry.generation == generationOf(id) ? &entry : nullptr;
+        }
+
+        const uint16_t loopIndex_;
+        uint32_t freeHead_;
+        size_t size_;
+        std::vector<Slot> slots_;
+    };
+
+    using ConnectionRegistry = SlotTable<TcpConnectionPtr>;
+}
@@ -27,7 +27,8 @@ namespace net
     {
         LOG_DEBUG("Connector::~Connector()");
         loop_->assertInLoopThread();
-        assert(state_ == kDisconnected);
+        // 连接成功后状态停留在 kConnected，只需保证 channel 已经释放
+        assert(!channel_);
     }
 
     void Connector::start()
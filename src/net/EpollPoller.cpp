@@ -5,6 +5,14 @@
 #include <errno.h>
 #include <cstring>
 #include <cassert>
+
+// 每次 epoll_ctl 的 INFO 日志只编进调试构建；发布构建需要时用 -DRTSP_POLLER_TRACE 打开
+#if !defined(NDEBUG) || defined(RTSP_POLLER_TRACE)
+#define POLLER_TRACE(fmt, ...) LOG_INFO(fmt, ##__VA_ARGS__)
+#else
+#define POLLER_TRACE(fmt, ...) ((void)0)
+#endif
+
 namespace net
 {
     const int kNew = -1;
@@ -26,6 +34,7 @@ namespace net
 
     base::Timestamp EpollPoller::poll(int timeoutMs, ChannelList *activeChannels)
     {
+        flushUpdates();
         int numEvents = ::epoll_wait(epollfd_, events_.data(), static_cast<int>(events_.size()), timeoutMs);
         base::Timestamp now(base::Timestamp::now());
 
@@ -41,7 +50,7 @@ namespace net
         }
         else if (numEvents == 0)
         {
-            LOG_DEBUG("epoll_wait timeout in thread %d with %d channels", gettid(), channels_.size());
+            LOG_DEBUG("epoll_wait timeout in thread %d with %zu channels", gettid(), numChannels_);
         }
         else
         {
@@ -68,10 +77,10 @@ namespace net
     {
         struct epoll_event event;
         memset(&event, 0, sizeof(event));
-        event.events = channel->events();
+        event.events = channel->pollEvents();
         event.data.ptr = channel;
         int fd = channel->fd();
-        LOG_INFO("epoll_ctl op = %s fd = %d event = %04x",
+        POLLER_TRACE("epoll_ctl op = %s fd = %d event = %04x",
                  operation == EPOLL_CTL_ADD ? "ADD" : operation == EPOLL_CTL_DEL ? "DEL"
                                                                                  : "MOD",
                  fd, event.events);
@@ -86,57 +95,82 @@ namespace net
     {
         const int index = channel->index();
         int fd = channel->fd();
-        if (index == kNew || index == kDeleted)
+        if (index == kNew)
         {
-            if (index == kNew)
-            {
-                assert(channels_.find(fd) == channels_.end());
-                channels_[fd] = channel;
-            }
-            else
-            {
-                assert(channels_.find(fd) != channels_.end());
-                assert(channels_[fd] == channel);
-            }
-            channel->setIndex(kAdded);
-            update(EPOLL_CTL_ADD, channel);
+            assert(findChannel(fd) == nullptr);
+            addChannel(fd, channel);
+            channel->setIndex(kDeleted); // 已登记但尚未加入 epoll，下次 poll 前提交
+            channel->setCommittedEvents(0);
         }
         else
         {
-            assert(channels_.find(fd) != channels_.end());
-            assert(channels_[fd] == channel);
-            assert(index == kAdded);
-            if (channel->isNoneEvent())
+            assert(findChannel(fd) == channel);
+            assert(index == kAdded || index == kDeleted);
+        }
+        ++updateRequests_;
+        if (!channel->updatePending())
+        {
+            channel->setUpdatePending(true);
+            pendingFds_.push_back(fd);
+        }
+    }
+
+    void EpollPoller::flushUpdates()
+    {
+        // 同一轮内的多次开关只按最终状态提交一次，回到原状态的则完全省掉
+        for (int fd : pendingFds_)
+        {
+            Channel *channel = findChannel(fd);
+            if (channel == nullptr || !channel->updatePending())
+            {
+                continue; // 提交前已被移除
+            }
+            channel->setUpdatePending(false);
+            const int events = channel->pollEvents(); // 无关注事件时为 0
+            if (channel->index() == kAdded)
             {
-                update(EPOLL_CTL_DEL, channel);
-                channel->setIndex(kDeleted);
+                if (events == 0)
+                {
+                    update(EPOLL_CTL_DEL, channel);
+                    channel->setIndex(kDeleted);
+                    ++updatesIssued_;
+                }
+                else if (events != channel->committedEvents())
+                {
+                    update(EPOLL_CTL_MOD, channel);
+                    ++updatesIssued_;
+                }
             }
-            else
+            else if (events != 0)
             {
-                update(EPOLL_CTL_MOD, channel);
+                update(EPOLL_CTL_ADD, channel);
+                channel->setIndex(kAdded);
+                ++updatesIssued_;
             }
+            channel->setCommittedEvents(events);
         }
+        pendingFds_.clear();
     }
+
     void EpollPoller::removeChannel(Channel *channel)
     {
         int fd = channel->fd();
-        assert(channels_.find(fd) != channels_.end());
-        assert(channels_[fd] == channel);
+        assert(findChannel(fd) == channel);
         assert(channel->isNoneEvent());
         int index = channel->index();
         assert(index == kAdded || index == kDeleted);
-        [[maybe_unused]] size_t n = channels_.erase(fd);
-        assert(n == 1);
+        eraseChannel(fd);
+        channel->setUpdatePending(false); // pendingFds_ 中的残留项在刷新时按表查不到而跳过
         if (index == kAdded)
         {
             update(EPOLL_CTL_DEL, channel);
         }
         channel->setIndex(kNew);
+        channel->setCommittedEvents(0);
     }
 
     bool EpollPoller::hasChannel(Channel *channel) const
     {
-        auto it = channels_.find(channel->fd());
-        return it != channels_.end() && it->second == channel;
+        return findChannel(channel->fd()) == channel;
     }
 }
\ No newline at end of file
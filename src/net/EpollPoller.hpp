@@ -18,14 +18,17 @@ namespace net
         void updateChannel(Channel *channel) override;
         void removeChannel(Channel *channel) override;
         bool hasChannel(Channel *channel) const override;
+        const char *name() const override { return "epoll"; }
 
     private:
         static const int kInitEventListSize = 16;
         void fillActiveChannels(int numEvents, ChannelList *activeChannels) const;
         void update(int operation, Channel *channel);
+        void flushUpdates();
 
         using EventList = std::vector<struct epoll_event>;
         int epollfd_;
         EventList events_;
+        std::vector<int> pendingFds_; // 本轮修改过关注事件、等待提交的 fd
     };
 } // namespace name
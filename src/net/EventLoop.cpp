@@ -1,25 +1,64 @@
 #include "Logger.hpp"
 #include "EventLoop.hpp"
 #include "Poller.hpp"
+#include "Buffer.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
 namespace net
 {
     namespace
     {
         const int kPollTimeMs = 10000;
+        // 单轮最多执行的跨线程任务数，防止任务不断自我投递时饿死 IO
+        const int kMaxPendingFunctorsPerLoop = 4096;
+        // 每个 loop 预先分配的任务节点数，以及突发投递后保留的节点上限
+        const int kPreallocatedFunctors = 128;
+        const int kMaxFunctorNodes = 4096;
+
+        int createTimerfd()
+        {
+            int timerfd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+            if (timerfd < 0)
+            {
+                LOG_FATAL("timerfd_create failed in EventLoop::EventLoop");
+            }
+            return timerfd;
+        }
+
+        int64_t monotonicNanos()
+        {
+            timespec ts;
+            ::clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+        }
     }
 
-    EventLoop::EventLoop()
+    EventLoop::EventLoop(PollerBackend backend)
         : looping_(false),
           quit_(false),
+          iteration_(0),
           threadId_(std::this_thread::get_id()),
           pollReturnTime_(Timestamp::now()),
-          poller_(Poller::newDefaultPoller(this)),
+          poller_(Poller::newPoller(this, backend)),
           timerQueue_(new base::TimerQueue()),
+          timerfd_(createTimerfd()),
+          timerChannel_(new Channel(this, timerfd_)),
           wakeupFd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
           wakeUpChannel_(new Channel(this, wakeupFd_)),
-          callingPendingFunctors_(false)
+          freeFunctors_(nullptr),
+          functorNodes_(0),
+          wakeupPending_(false),
+          callingPendingFunctors_(false),
+          statsEnabled_(true),
+          iterationTimerNanos_(0),
+          computePool_(nullptr),
+          bufferPool_(16),
+          readScratch_(new char[kReadScratchSize]),
+          receivedAverage_(static_cast<int64_t>(Buffer::kInitialSize))
     {
         if (wakeupFd_ < 0)
         {
@@ -28,6 +67,13 @@ namespace net
         LOG_DEBUG("EventLoop created %p", this);
         wakeUpChannel_->setReadCallback(std::bind(&EventLoop::handleRead, this));
         wakeUpChannel_->enableReading();
+        timerChannel_->setReadCallback(std::bind(&EventLoop::handleTimer, this));
+        timerChannel_->enableReading();
+        for (int i = 0; i < kPreallocatedFunctors; ++i)
+        {
+            functorNodes_.fetch_add(1, std::memory_order_relaxed);
+            recyclePendingFunctor(new PendingFunctor());
+        }
     }
 
     EventLoop::~EventLoop()
@@ -38,6 +84,21 @@ namespace net
         wakeUpChannel_->disableAll();
         wakeUpChannel_->remove();
         ::close(wakeupFd_);
+        timerChannel_->disableAll();
+        timerChannel_->remove();
+        ::close(timerfd_);
+        poller_->drain(); // 保留的数据所有者可能归还内存池，须在成员析构前释放
+        while (PendingFunctor *task = pendingFunctors_.pop())
+        {
+            delete task;
+        }
+        PendingFunctor *task = freeFunctors_.exchange(nullptr, std::memory_order_acquire);
+        while (task != nullptr)
+        {
+            PendingFunctor *next = static_cast<PendingFunctor *>(task->next.load(std::memory_order_relaxed));
+            delete task;
+            task = next;
+        }
     }
 
     void EventLoop::loop()
@@ -45,22 +106,60 @@ namespace net
         assert(!looping_);
         assertInLoopThread();
         looping_ = true;
-        quit_ = false;
+        // 不在此处复位 quit_：其他线程可能在 loop() 开始前就已调用 quit()
         LOG_INFO("EventLoop %p start looping in thread %d", this, gettid());
+        int64_t waitStart = monotonicNanos();
         while (!quit_)
         {
             activeChannels_.clear();
             pollReturnTime_ = poller_->poll(kPollTimeMs, &activeChannels_);
+            ++iteration_;
+            load_.tick();
+            const bool recordStats = statsEnabled_;
+            const int64_t polled = recordStats ? monotonicNanos() : 0;
+            iterationTimerNanos_ = 0;
             for (auto it = activeChannels_.begin(); it != activeChannels_.end(); ++it)
             {
                 (*it)->handleEvent(pollReturnTime_);
             }
-            doPendingFunctors();
+            const int64_t handled = recordStats ? monotonicNanos() : 0;
+            const int functors = doPendingFunctors() + doIterationEndFunctors();
+            if (recordStats)
+            {
+                const int64_t done = monotonicNanos();
+                EventLoopStatsRecorder::Sample sample;
+                sample.pollNanos = polled - waitStart;
+                sample.eventNanos = handled - polled - iterationTimerNanos_;
+                sample.timerNanos = iterationTimerNanos_;
+                sample.functorNanos = done - handled;
+                sample.events = static_cast<int>(activeChannels_.size());
+                sample.functors = functors;
+                sample.avoidedPollerUpdates = poller_->avoidedUpdates();
+                stats_.record(sample);
+                waitStart = done;
+            }
         }
         LOG_INFO("EventLoop %p stop looping", this);
         looping_ = false;
     }
 
+    size_t EventLoop::receiveBufferHint() const
+    {
+        const size_t average = std::max(static_cast<size_t>(receivedAverage_), kMinReceiveBufferHint);
+        const size_t hint = size_t(1) << (64 - __builtin_clzll(average - 1));
+        return std::min(hint, kReadScratchSize);
+    }
+
+    EventLoopStats EventLoop::stats() const
+    {
+        EventLoopStats stats = stats_.snapshot();
+        stats.connections = load_.connections();
+        stats.bytesPerSecond = load_.bytesPerSecond();
+        stats.zeroCopyBytes = load_.zeroCopyBytes();
+        stats.zeroCopyCopiedBytes = load_.zeroCopyCopiedBytes();
+        return stats;
+    }
+
     void EventLoop::quit()
     {
         quit_ = true;
@@ -70,7 +169,7 @@ namespace net
         }
     }
 
-    void EventLoop::runInLoop(const Functor &cb)
+    void EventLoop::runInLoop(Functor &&cb)
     {
         if (isInLoopThread())
         {
@@ -78,42 +177,152 @@ namespace net
         }
         else
         {
-            queueInLoop(cb);
+            queueInLoop(std::move(cb));
         }
     }
 
-    void EventLoop::queueInLoop(const Functor &cb)
+    void EventLoop::queueInLoop(Functor &&cb)
     {
+        if (callingPendingFunctors_ && isInLoopThread())
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            pendingFunctors_.push_back(cb);
+            // 任务执行期间追加的任务推迟到下一轮 poll 之后，避免反复自我投递的任务（如边沿触发下
+            // 预算用完的续读）在同一轮里连续执行而饿死其他连接
+            deferredFunctors_.push_back(std::move(cb));
+            return;
         }
-        if (!isInLoopThread() || callingPendingFunctors_)
+        pendingFunctors_.push(newPendingFunctor(std::move(cb)));
+        if (!isInLoopThread())
         {
-            wakeup();
+            // 已有未处理的唤醒时无需再写 eventfd
+            if (!wakeupPending_.exchange(true, std::memory_order_acq_rel))
+            {
+                wakeup();
+            }
         }
     }
 
+    void EventLoop::runOffLoop(Functor &&task, Functor &&continuation)
+    {
+        base::WorkStealingPool &pool = computePool_ != nullptr ? *computePool_ : base::WorkStealingPool::instance();
+        pool.submit([this, task = std::move(task), continuation = std::move(continuation)]() mutable
+                    {
+                        task();
+                        if (continuation)
+                        {
+                            queueInLoop(std::move(continuation));
+                        } });
+    }
+
     TimerId EventLoop::runAt(const Timestamp &time, TimerCallback cb)
     {
-        return timerQueue_->addTimer(cb, time, 0.0);
+        // 在调用线程分配 TimerId，实际入队操作切回 loop 线程，TimerQueue 本身无需加锁
+        auto timer = std::make_shared<base::Timer>(std::move(cb), time, 0.0);
+        runInLoop(std::bind(&EventLoop::addTimerInLoop, this, timer));
+        return timer->timerId();
     }
 
     TimerId EventLoop::runAfter(double delay, TimerCallback cb)
     {
         Timestamp time(addTime(Timestamp::now(), delay));
-        return runAt(time, cb);
+        return runAt(time, std::move(cb));
     }
 
     TimerId EventLoop::runEvery(double interval, TimerCallback cb)
     {
         Timestamp time(addTime(Timestamp::now(), interval));
-        return timerQueue_->addTimer(cb, time, interval);
+        auto timer = std::make_shared<base::Timer>(std::move(cb), time, interval);
+        runInLoop(std::bind(&EventLoop::addTimerInLoop, this, timer));
+        return timer->timerId();
     }
 
     void EventLoop::cancel(TimerId timerId)
     {
-        return timerQueue_->cancel(timerId);
+        runInLoop(std::bind(&EventLoop::cancelInLoop, this, timerId));
+    }
+
+    void EventLoop::resetTimer(TimerId timerId, double delay)
+    {
+        Timestamp when(addTime(Timestamp::now(), delay));
+        runInLoop(std::bind(&EventLoop::resetTimerInLoop, this, timerId, when));
+    }
+
+    void EventLoop::useTimingWheel(double tickSeconds)
+    {
+        assertInLoopThread();
+        assert(timerQueue_->empty());
+        timerQueue_.reset(new base::TimingWheel(tickSeconds));
+    }
+
+    void EventLoop::addTimerInLoop(const std::shared_ptr<base::Timer> &timer)
+    {
+        assertInLoopThread();
+        timerQueue_->addTimer(timer);
+        rearmTimerfd();
+    }
+
+    void EventLoop::cancelInLoop(TimerId timerId)
+    {
+        assertInLoopThread();
+        timerQueue_->cancel(timerId);
+        rearmTimerfd();
+    }
+
+    void EventLoop::resetTimerInLoop(TimerId timerId, Timestamp when)
+    {
+        assertInLoopThread();
+        if (timerQueue_->reset(timerId, when))
+        {
+            rearmTimerfd();
+        }
+    }
+
+    void EventLoop::rearmTimerfd()
+    {
+        Timestamp earliest = timerQueue_->nextExpiration();
+        if (!(earliest == timerfdExpiration_))
+        {
+            resetTimerfd(earliest);
+        }
+    }
+
+    void EventLoop::resetTimerfd(Timestamp expiration)
+    {
+        struct itimerspec newValue;
+        memset(&newValue, 0, sizeof(newValue));
+        if (expiration.valid())
+        {
+            // 相对时间，微秒精度；已过期的定时器按 1us 处理，0 会解除 timerfd
+            int64_t microseconds = expiration.microSecondsSinceEpoch() - Timestamp::now().microSecondsSinceEpoch();
+            if (microseconds < 1)
+            {
+                microseconds = 1;
+            }
+            newValue.it_value.tv_sec = static_cast<time_t>(microseconds / Timestamp::kMicroSecondsPerSecond);
+            newValue.it_value.tv_nsec = static_cast<long>((microseconds % Timestamp::kMicroSecondsPerSecond) * 1000);
+        }
+        if (::timerfd_settime(timerfd_, 0, &newValue, nullptr) < 0)
+        {
+            LOG_ERROR("timerfd_settime failed in EventLoop::resetTimerfd");
+        }
+        timerfdExpiration_ = expiration;
+    }
+
+    void EventLoop::handleTimer()
+    {
+        uint64_t howmany = 0;
+        ssize_t n = ::read(timerfd_, &howmany, sizeof(howmany));
+        if (n != sizeof howmany && errno != EAGAIN)
+        {
+            LOG_ERROR("EventLoop::handleTimer() reads %ld bytes instead of 8", n);
+        }
+        timerfdExpiration_ = Timestamp::invalid();
+        const int64_t start = statsEnabled_ ? monotonicNanos() : 0;
+        timerQueue_->handleExpiredTimers(Timestamp::now());
+        if (statsEnabled_)
+        {
+            iterationTimerNanos_ += monotonicNanos() - start;
+        }
+        rearmTimerfd();
     }
 
     void EventLoop::updateChannel(Channel *channel)
@@ -157,20 +366,155 @@ namespace net
         }
     }
 
-    void EventLoop::doPendingFunctors()
+    int EventLoop::doPendingFunctors()
     {
-        std::vector<Functor> functors;
         callingPendingFunctors_ = true;
+        // 先清除标志再取任务：清除之后入队的生产者会重新写 eventfd
+        wakeupPending_.exchange(false, std::memory_order_acq_rel);
+        runningFunctors_.swap(deferredFunctors_);
+        for (Functor &functor : runningFunctors_)
+        {
+            functor();
+        }
+        const int deferred = static_cast<int>(runningFunctors_.size());
+        runningFunctors_.clear();
+        int n = 0;
+        while (n < kMaxPendingFunctorsPerLoop)
+        {
+            PendingFunctor *task = pendingFunctors_.pop();
+            if (task == nullptr)
+            {
+                break;
+            }
+            // 先回收节点再执行：任务可见的副作用发生时节点已可复用，任务自我投递也不会多占节点
+            Functor functor(std::move(task->functor));
+            recyclePendingFunctor(task);
+            functor();
+            ++n;
+        }
+        if ((n == kMaxPendingFunctorsPerLoop || !deferredFunctors_.empty()) &&
+            !wakeupPending_.exchange(true, std::memory_order_acq_rel))
+        {
+            wakeup(); // 还有剩余任务，避免下一轮阻塞在 epoll_wait
+        }
+        callingPendingFunctors_ = false;
+        return deferred + n;
+    }
+
+    void EventLoop::runAtIterationEnd(Functor &&cb)
+    {
+        assertInLoopThread();
+        iterationEndFunctors_.push_back(std::move(cb));
+        if (!looping_ && !wakeupPending_.exchange(true, std::memory_order_acq_rel))
+        {
+            wakeup(); // loop() 尚未开始，第一次 poll 不要阻塞
+        }
+    }
+
+    int EventLoop::doIterationEndFunctors()
+    {
+        if (iterationEndFunctors_.empty())
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            functors.swap(pendingFunctors_);
+            return 0;
         }
-        for (const Functor &functor : functors)
+        // 执行期间 loop 线程追加的任务同样推迟到下一轮
+        callingPendingFunctors_ = true;
+        runningIterationEnd_.swap(iterationEndFunctors_);
+        for (Functor &functor : runningIterationEnd_)
         {
             functor();
         }
+        const int n = static_cast<int>(runningIterationEnd_.size());
+        runningIterationEnd_.clear();
         callingPendingFunctors_ = false;
+        if ((!deferredFunctors_.empty() || !iterationEndFunctors_.empty()) &&
+            !wakeupPending_.exchange(true, std::memory_order_acq_rel))
+        {
+            wakeup();
+        }
+        return n;
     }
+
+    EventLoop::PendingFunctor *EventLoop::newPendingFunctor(Functor &&cb)
+    {
+        // 每个线程按目标 loop 缓存一串空闲节点；缓存为空时把该 loop 回收的节点整串取走（exchange 不存在 ABA）。
+        // 节点只在同一个 loop 的空闲链表和投递线程之间循环，预分配的节点够用时投递任务不再分配内存
+        struct Cache
+        {
+            std::vector<std::pair<const EventLoop *, PendingFunctor *>> heads;
+            ~Cache()
+            {
+                for (auto &entry : heads)
+                {
+                    PendingFunctor *head = entry.second;
+                    while (head != nullptr)
+                    {
+                        PendingFunctor *next = static_cast<PendingFunctor *>(head->next.load(std::memory_order_relaxed));
+                        delete head;
+                        head = next;
+                    }
+                }
+            }
+        };
+        static thread_local Cache cache;
+
+        auto entry = std::find_if(cache.heads.begin(), cache.heads.end(), [this](const std::pair<const EventLoop *, PendingFunctor *> &e)
+                                  { return e.first == this; });
+        if (entry == cache.heads.end())
+        {
+            cache.heads.emplace_back(this, nullptr);
+            entry = cache.heads.end() - 1;
+        }
+        PendingFunctor *&head = entry->second;
+        if (head == nullptr)
+        {
+            head = freeFunctors_.exchange(nullptr, std::memory_order_acquire);
+        }
+        PendingFunctor *task = head;
+        if (task != nullptr)
+        {
+            head = static_cast<PendingFunctor *>(task->next.load(std::memory_order_relaxed));
+        }
+        else
+        {
+            functorNodes_.fetch_add(1, std::memory_order_relaxed);
+            task = new PendingFunctor();
+        }
+        task->functor = std::move(cb);
+        return task;
+    }
+
+    void EventLoop::recyclePendingFunctor(PendingFunctor *task)
+    {
+        task->functor = nullptr; // 尽早释放捕获的资源
+        if (functorNodes_.load(std::memory_order_relaxed) > kMaxFunctorNodes)
+        {
+            functorNodes_.fetch_sub(1, std::memory_order_relaxed);
+            delete task; // 突发投递多分配的节点不长期占用内存
+            return;
+        }
+        PendingFunctor *head = freeFunctors_.load(std::memory_order_relaxed);
+        do
+        {
+            task->next.store(head, std::memory_order_relaxed);
+        } while (!freeFunctors_.compare_exchange_weak(head, task, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    const char *EventLoop::pollerName() const
+    {
+        return poller_->name();
+    }
+
+    bool EventLoop::completedWriteEnabled() const
+    {
+        return poller_->completedWriteEnabled();
+    }
+
+    int64_t EventLoop::avoidedPollerUpdates() const
+    {
+        return poller_->avoidedUpdates();
+    }
+
     void EventLoop::assertInLoopThread() const
     {
         if (!isInLoopThread())
@@ -3,37 +3,83 @@
 #include <atomic>
 #include <functional>
 #include <thread>
-#include <mutex>
+#include "Queue.hpp"
+#include "InlineFunction.hpp"
 #include "Timer.hpp"
+#include "TimingWheel.hpp"
 #include "Noncopyable.hpp"
 #include "Channel.hpp"
+#include "Poller.hpp"
+#include "EventLoopStats.hpp"
+#include "WorkStealingPool.hpp"
+#include "BlockPool.hpp"
 using namespace base;
 namespace net
 {
     class Channel;
     class Poller;
-    class TimerQueue;
 
     class EventLoop : base::Noncopyable
     {
     public:
-        using Functor = std::function<void()>;
+        using Functor = base::InlineFunction<void()>;
 
-        EventLoop();
+        explicit EventLoop(PollerBackend backend = PollerBackend::kDefault);
         ~EventLoop();
 
         void loop();
         void quit();
         void wakeup();
         Timestamp pollReturnTime() const { return pollReturnTime_; }
+        int64_t iteration() const { return iteration_; } // 已完成的 poll 轮数
+        const char *pollerName() const;
+        // poller 是否直接提交发送，此时连接不再自己调用 write，交给 poller 在下一轮一并提交
+        bool completedWriteEnabled() const;
+        // 关注事件变更被合并、未产生 epoll_ctl（或 io_uring SQE）的次数
+        int64_t avoidedPollerUpdates() const;
 
-        void runInLoop(const Functor &cb);
-        void queueInLoop(const Functor &cb);
+        // 运行统计快照，任何线程都可以无锁读取
+        EventLoopStats stats() const;
+        // 关闭后每轮不再读时钟和记录统计，须在 loop 线程中调用
+        void setStatsEnabled(bool on) { statsEnabled_ = on; }
+        // 记录本 loop 线程绑定的 CPU 和 NUMA 节点，出现在 stats() 中
+        void setPlacement(int cpu, int numaNode) { stats_.setPlacement(cpu, numaNode); }
+        // 连接数和收发速率，线程池据此挑选负载最轻的 loop
+        LoopLoad &load() { return load_; }
+        const LoopLoad &load() const { return load_; }
+        // 本 loop 上 TcpConnection（连同 shared_ptr 控制块）的定长块内存池
+        base::BlockPool &connectionPool() { return connectionPool_; }
+        // 本 loop 上各连接发送缓冲区共用的 slab 池
+        base::BlockPool &bufferPool() { return bufferPool_; }
+
+        static constexpr size_t kReadScratchSize = 64 * 1024;
+        static constexpr size_t kMinReceiveBufferHint = 256;
+        // 本 loop 上各连接共用的读溢出区，接收缓冲区放不下的数据先读到这里。只在 loop 线程使用
+        char *readScratch() { return readScratch_.get(); }
+        // 每次读完后记录接收缓冲区中待处理的字节数（约等于消息大小）
+        void recordReceived(size_t readable) { receivedAverage_ += (static_cast<int64_t>(readable) - receivedAverage_) / 8; }
+        // 新分配接收缓冲区的初始容量：上述字节数的滑动平均向上取 2 的幂
+        size_t receiveBufferHint() const;
+
+        void runInLoop(Functor &&cb);
+        void queueInLoop(Functor &&cb);
+        // 本轮事件和任务都处理完、下一次 poll 之前执行，用于把本轮的多次发送合并成一次写。
+        // 只能在 loop 线程调用；执行期间追加的在下一轮执行
+        void runAtIterationEnd(Functor &&cb);
+        // 在计算线程池中执行 task，完成后把 continuation 投递回本 loop 执行。
+        // 用于解析、建索引等会阻塞本 loop 上其他连接的计算；本 loop 须活到 continuation 执行完
+        void runOffLoop(Functor &&task, Functor &&continuation = Functor());
+        // 默认使用进程共享的 WorkStealingPool::instance()，须在 loop 线程中调用
+        void setComputePool(base::WorkStealingPool *pool) { computePool_ = pool; }
 
         TimerId runAt(const Timestamp &time, TimerCallback cb);
         TimerId runAfter(double delay, TimerCallback cb);
         TimerId runEvery(double interval, TimerCallback cb);
         void cancel(TimerId timerId);
+        // 把定时器推迟到 delay 秒之后，用于空闲超时刷新
+        void resetTimer(TimerId timerId, double delay);
+        // 改用分层时间轮管理定时器，须在 loop 线程中、添加任何定时器之前调用
+        void useTimingWheel(double tickSeconds = base::TimingWheel::kDefaultTick);
 
         void updateChannel(Channel *channel);
         void removeChannel(Channel *channel);
@@ -45,21 +91,57 @@ namespace net
 
     private:
         void handleRead();
-        void doPendingFunctors();
+        void handleTimer();
+        void resetTimerfd(Timestamp expiration);
+        void addTimerInLoop(const std::shared_ptr<base::Timer> &timer);
+        void cancelInLoop(TimerId timerId);
+        void resetTimerInLoop(TimerId timerId, Timestamp when);
+        void rearmTimerfd();
+        int doPendingFunctors();
+        int doIterationEndFunctors();
         using ChannelList = std::vector<Channel *>;
 
         std::atomic<bool> looping_;
         std::atomic<bool> quit_;
+        int64_t iteration_;
         const std::thread::id threadId_;
         Timestamp pollReturnTime_;
         std::unique_ptr<Poller> poller_;
-        std::unique_ptr<base::TimerQueue> timerQueue_;
+        std::unique_ptr<base::TimerQueueBase> timerQueue_;
         ChannelList activeChannels_;
 
+        int timerfd_;
+        std::unique_ptr<Channel> timerChannel_;
+        Timestamp timerfdExpiration_; // timerfd 当前设定的到期时间
+
         int wakeupFd_;
         std::unique_ptr<Channel> wakeUpChannel_;
-        std::mutex mutex_;
-        std::vector<Functor> pendingFunctors_;
+
+        struct PendingFunctor : base::MpscNode
+        {
+            Functor functor;
+        };
+        PendingFunctor *newPendingFunctor(Functor &&cb);
+        void recyclePendingFunctor(PendingFunctor *task);
+
+        base::MpscQueue<PendingFunctor> pendingFunctors_;
+        std::atomic<PendingFunctor *> freeFunctors_; // loop 线程回收的空闲节点，生产者整串取走复用
+        std::atomic<int> functorNodes_;              // 属于本 loop 的节点数，超过上限的回收节点直接释放
+        std::atomic<bool> wakeupPending_; // eventfd 已写入、loop 尚未处理，生产者可省去一次 write
         std::atomic<bool> callingPendingFunctors_;
+        std::vector<Functor> deferredFunctors_; // 任务执行期间 loop 线程追加的任务，下一轮执行
+        std::vector<Functor> runningFunctors_;
+        std::vector<Functor> iterationEndFunctors_;
+        std::vector<Functor> runningIterationEnd_;
+
+        bool statsEnabled_;
+        int64_t iterationTimerNanos_; // 本轮定时器回调耗时，从事件处理时间中扣除
+        EventLoopStatsRecorder stats_;
+        LoopLoad load_;
+        base::WorkStealingPool *computePool_;
+        base::BlockPool connectionPool_;
+        base::BlockPool bufferPool_;
+        std::unique_ptr<char[]> readScratch_;
+        int64_t receivedAverage_;
     };
 }
\ No newline at end of file
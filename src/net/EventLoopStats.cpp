@@ -0,0 +1,250 @@
+#include "EventLoopStats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <time.h>
+#include <cstdio>
+
+namespace net
+{
+    uint64_t LatencyHistogram::bucketUpperBound(int bucket)
+    {
+        if (bucket < (1 << kSubBucketBits))
+        {
+            return static_cast<uint64_t>(bucket);
+        }
+        const int exponent = (bucket >> kSubBucketBits) + kSubBucketBits - 1;
+        const uint64_t sub = static_cast<uint64_t>(bucket & ((1 << kSubBucketBits) - 1));
+        const uint64_t width = uint64_t(1) << (exponent - kSubBucketBits);
+        return (uint64_t(1) << exponent) + sub * width + (width - 1);
+    }
+
+    uint64_t LatencyHistogram::count() const
+    {
+        uint64_t total = 0;
+        for (uint64_t n : buckets)
+        {
+            total += n;
+        }
+        return total;
+    }
+
+    uint64_t LatencyHistogram::percentile(double q) const
+    {
+        const uint64_t total = count();
+        if (total == 0)
+        {
+            return 0;
+        }
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(total) + 0.5));
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i)
+        {
+            seen += buckets[i];
+            if (seen >= rank)
+            {
+                return bucketUpperBound(i);
+            }
+        }
+        return bucketUpperBound(kBuckets - 1);
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram &other)
+    {
+        for (int i = 0; i < kBuckets; ++i)
+        {
+            buckets[i] += other.buckets[i];
+        }
+    }
+
+    void EventLoopStats::merge(const EventLoopStats &other)
+    {
+        iterations += other.iterations;
+        wakeups += other.wakeups;
+        events += other.events;
+        maxEventsPerWakeup = std::max(maxEventsPerWakeup, other.maxEventsPerWakeup);
+        pollNanos += other.pollNanos;
+        eventNanos += other.eventNanos;
+        timerNanos += other.timerNanos;
+        functorNanos += other.functorNanos;
+        functors += other.functors;
+        maxFunctorsPerIteration = std::max(maxFunctorsPerIteration, other.maxFunctorsPerIteration);
+        avoidedPollerUpdates += other.avoidedPollerUpdates;
+        connections += other.connections;
+        bytesPerSecond += other.bytesPerSecond;
+        zeroCopyBytes += other.zeroCopyBytes;
+        zeroCopyCopiedBytes += other.zeroCopyCopiedBytes;
+        if (loops == 0)
+        {
+            cpu = other.cpu;
+            numaNode = other.numaNode;
+        }
+        else
+        {
+            cpu = cpu == other.cpu ? cpu : -1;
+            numaNode = numaNode == other.numaNode ? numaNode : -1;
+        }
+        loops += other.loops;
+        iterationNanos.merge(other.iterationNanos);
+    }
+
+    void AcceptStats::merge(const AcceptStats &other)
+    {
+        accepted += other.accepted;
+        wakeups += other.wakeups;
+        maxBatch = std::max(maxBatch, other.maxBatch);
+        shed += other.shed;
+        errors += other.errors;
+    }
+
+    std::string EventLoopStats::toString() const
+    {
+        char buf[704];
+        snprintf(buf, sizeof buf,
+                 "loops=%d cpu=%d node=%d connections=%d bytes/s=%.0f iterations=%ld wakeups=%ld events/wakeup=%.2f (max %ld) "
+                 "poll=%.3fs events=%.3fs timers=%.3fs functors=%.3fs (%ld run, max %ld/iteration) "
+                 "avoidedUpdates=%ld zeroCopy=%ld (copied %ld) iteration p50=%luns p99=%luns p999=%luns",
+                 loops, cpu, numaNode, connections, bytesPerSecond, static_cast<long>(iterations), static_cast<long>(wakeups), eventsPerWakeup(),
+                 static_cast<long>(maxEventsPerWakeup),
+                 static_cast<double>(pollNanos) / 1e9, static_cast<double>(eventNanos) / 1e9,
+                 static_cast<double>(timerNanos) / 1e9, static_cast<double>(functorNanos) / 1e9,
+                 static_cast<long>(functors), static_cast<long>(maxFunctorsPerIteration),
+                 static_cast<long>(avoidedPollerUpdates), static_cast<long>(zeroCopyBytes), static_cast<long>(zeroCopyCopiedBytes),
+                 static_cast<unsigned long>(iterationNanos.percentile(0.5)),
+                 static_cast<unsigned long>(iterationNanos.percentile(0.99)),
+                 static_cast<unsigned long>(iterationNanos.percentile(0.999)));
+        return buf;
+    }
+
+    EventLoopStatsRecorder::EventLoopStatsRecorder()
+        : seq_(0),
+          iterations_(0),
+          wakeups_(0),
+          events_(0),
+          maxEventsPerWakeup_(0),
+          pollNanos_(0),
+          eventNanos_(0),
+          timerNanos_(0),
+          functorNanos_(0),
+          functors_(0),
+          maxFunctorsPerIteration_(0),
+          avoidedPollerUpdates_(0),
+          cpu_(-1),
+          numaNode_(-1)
+    {
+        for (auto &bucket : histogram_)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void EventLoopStatsRecorder::record(const Sample &sample)
+    {
+        const uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        add(iterations_, 1);
+        if (sample.events > 0)
+        {
+            add(wakeups_, 1);
+            add(events_, sample.events);
+            max(maxEventsPerWakeup_, sample.events);
+        }
+        add(pollNanos_, sample.pollNanos);
+        add(eventNanos_, sample.eventNanos);
+        add(timerNanos_, sample.timerNanos);
+        add(functorNanos_, sample.functorNanos);
+        add(functors_, sample.functors);
+        max(maxFunctorsPerIteration_, sample.functors);
+        avoidedPollerUpdates_.store(sample.avoidedPollerUpdates, std::memory_order_relaxed);
+        const int64_t busy = sample.eventNanos + sample.timerNanos + sample.functorNanos;
+        std::atomic<uint64_t> &bucket = histogram_[LatencyHistogram::bucketOf(static_cast<uint64_t>(std::max<int64_t>(busy, 0)))];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    EventLoopStats EventLoopStatsRecorder::snapshot() const
+    {
+        EventLoopStats stats;
+        for (;;)
+        {
+            const uint64_t begin = seq_.load(std::memory_order_acquire);
+            if (begin & 1)
+            {
+                continue; // loop 线程正在写
+            }
+            stats.iterations = iterations_.load(std::memory_order_relaxed);
+            stats.wakeups = wakeups_.load(std::memory_order_relaxed);
+            stats.events = events_.load(std::memory_order_relaxed);
+            stats.maxEventsPerWakeup = maxEventsPerWakeup_.load(std::memory_order_relaxed);
+            stats.pollNanos = pollNanos_.load(std::memory_order_relaxed);
+            stats.eventNanos = eventNanos_.load(std::memory_order_relaxed);
+            stats.timerNanos = timerNanos_.load(std::memory_order_relaxed);
+            stats.functorNanos = functorNanos_.load(std::memory_order_relaxed);
+            stats.functors = functors_.load(std::memory_order_relaxed);
+            stats.maxFunctorsPerIteration = maxFunctorsPerIteration_.load(std::memory_order_relaxed);
+            stats.avoidedPollerUpdates = avoidedPollerUpdates_.load(std::memory_order_relaxed);
+            for (int i = 0; i < LatencyHistogram::kBuckets; ++i)
+            {
+                stats.iterationNanos.buckets[i] = histogram_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == begin)
+            {
+                break;
+            }
+        }
+        stats.loops = 1;
+        stats.cpu = cpu_.load(std::memory_order_relaxed);
+        stats.numaNode = numaNode_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    LoopLoad::LoopLoad()
+        : connections_(0),
+          bytes_(0),
+          zeroCopyBytes_(0),
+          zeroCopyCopiedBytes_(0),
+          lastBytes_(0),
+          lastTickNanos_(coarseNanos()),
+          rate_(0.0)
+    {
+    }
+
+    int64_t LoopLoad::coarseNanos()
+    {
+        // 精度为一个时钟节拍，走 vDSO，每轮调用的代价可以忽略
+        timespec ts;
+        ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    void LoopLoad::tick()
+    {
+        const int64_t now = coarseNanos();
+        const int64_t elapsed = now - lastTickNanos_.load(std::memory_order_relaxed);
+        if (elapsed < kRateIntervalNanos)
+        {
+            return;
+        }
+        const int64_t bytes = bytes_.load(std::memory_order_relaxed);
+        const double instant = static_cast<double>(bytes - lastBytes_) * 1e9 / static_cast<double>(elapsed);
+        const double alpha = 1.0 - std::exp(-static_cast<double>(elapsed) / kRateDecayNanos);
+        const double rate = rate_.load(std::memory_order_relaxed);
+        rate_.store(rate + alpha * (instant - rate), std::memory_order_relaxed);
+        lastBytes_ = bytes;
+        lastTickNanos_.store(now, std::memory_order_relaxed);
+    }
+
+    double LoopLoad::bytesPerSecond() const
+    {
+        const double rate = rate_.load(std::memory_order_relaxed);
+        const int64_t idle = coarseNanos() - lastTickNanos_.load(std::memory_order_relaxed);
+        if (idle <= 2 * kRateIntervalNanos)
+        {
+            return rate;
+        }
+        return rate * std::exp(-static_cast<double>(idle) / kRateDecayNanos);
+    }
+}
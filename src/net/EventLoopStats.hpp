@@ -0,0 +1,175 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace net
+{
+    // 对数-线性直方图：每个 2 的幂区间再等分为 4 个子桶，相对误差不超过 25%，单位纳秒
+    struct LatencyHistogram
+    {
+        static constexpr int kSubBucketBits = 2;
+        static constexpr int kBuckets = 256;
+
+        static int bucketOf(uint64_t value)
+        {
+            if (value < (1u << kSubBucketBits))
+            {
+                return static_cast<int>(value);
+            }
+            const int exponent = 63 - __builtin_clzll(value);
+            const int sub = static_cast<int>((value >> (exponent - kSubBucketBits)) & ((1u << kSubBucketBits) - 1));
+            return ((exponent - kSubBucketBits + 1) << kSubBucketBits) + sub;
+        }
+        // 桶的上界（含），用于估计分位数
+        static uint64_t bucketUpperBound(int bucket);
+
+        uint64_t count() const;
+        // q 取 0~1，返回落在该分位的桶上界；没有样本时为 0
+        uint64_t percentile(double q) const;
+        void merge(const LatencyHistogram &other);
+
+        uint64_t buckets[kBuckets] = {};
+    };
+
+    // 某一时刻的统计快照，可以跨 loop 累加
+    struct EventLoopStats
+    {
+        int64_t iterations = 0;       // poll 返回次数
+        int64_t wakeups = 0;          // 带有活跃事件的 poll 次数
+        int64_t events = 0;           // 分发的 channel 事件总数
+        int64_t maxEventsPerWakeup = 0;
+        int64_t pollNanos = 0;        // 阻塞在 poll 中的时间
+        int64_t eventNanos = 0;       // handleEvent（不含定时器回调）
+        int64_t timerNanos = 0;       // 定时器回调
+        int64_t functorNanos = 0;     // doPendingFunctors
+        int64_t functors = 0;         // 执行的任务数
+        int64_t maxFunctorsPerIteration = 0; // 单轮取出的任务数峰值，即任务队列深度
+        int64_t avoidedPollerUpdates = 0;
+        int loops = 0;                // 参与累加的 loop 数
+        int cpu = -1;                 // 绑定的 CPU，未绑核或各 loop 不一致时为 -1
+        int numaNode = -1;            // cpu 所在的 NUMA 节点
+        int connections = 0;          // 当前挂在 loop 上的连接数
+        double bytesPerSecond = 0;    // 收发字节速率的指数滑动平均
+        int64_t zeroCopyBytes = 0;    // MSG_ZEROCOPY 发出并已收到完成通知的字节
+        int64_t zeroCopyCopiedBytes = 0; // 其中内核报告仍然做了拷贝的字节（如回环、网卡不支持）
+        LatencyHistogram iterationNanos; // 每轮 poll 返回后的处理耗时（不含等待）
+
+        double eventsPerWakeup() const { return wakeups == 0 ? 0.0 : static_cast<double>(events) / static_cast<double>(wakeups); }
+        void merge(const EventLoopStats &other);
+        std::string toString() const;
+    };
+
+    // Acceptor 接受连接的计数，按时间差分即得接受速率
+    struct AcceptStats
+    {
+        int64_t accepted = 0; // 成功接受的连接
+        int64_t wakeups = 0;  // 监听 socket 可读事件次数
+        int64_t maxBatch = 0; // 单次事件接受的最多连接数
+        int64_t shed = 0;     // fd 耗尽时借备用 fd 接下后立即关闭的连接
+        int64_t errors = 0;   // 其他 accept 错误
+
+        void merge(const AcceptStats &other);
+    };
+
+    // 单个 loop 的统计块：只有 loop 线程写，任何线程都可以无锁读取快照。
+    // 写端每轮一次 seqlock 写入（序号先变奇数、更新、再变偶数），读端序号不一致时重试
+    class EventLoopStatsRecorder
+    {
+    public:
+        struct Sample
+        {
+            int64_t pollNanos;
+            int64_t eventNanos;
+            int64_t timerNanos;
+            int64_t functorNanos;
+            int events;
+            int functors;
+            int64_t avoidedPollerUpdates;
+        };
+
+        EventLoopStatsRecorder();
+
+        void record(const Sample &sample);
+        // loop 线程绑核后记录一次
+        void setPlacement(int cpu, int numaNode)
+        {
+            cpu_.store(cpu, std::memory_order_relaxed);
+            numaNode_.store(numaNode, std::memory_order_relaxed);
+        }
+        EventLoopStats snapshot() const;
+
+    private:
+        using Counter = std::atomic<int64_t>;
+
+        // 单写者，不需要原子的读-改-写
+        static void add(Counter &counter, int64_t value)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+        static void max(Counter &counter, int64_t value)
+        {
+            if (value > counter.load(std::memory_order_relaxed))
+            {
+                counter.store(value, std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic<uint64_t> seq_;
+        Counter iterations_;
+        Counter wakeups_;
+        Counter events_;
+        Counter maxEventsPerWakeup_;
+        Counter pollNanos_;
+        Counter eventNanos_;
+        Counter timerNanos_;
+        Counter functorNanos_;
+        Counter functors_;
+        Counter maxFunctorsPerIteration_;
+        Counter avoidedPollerUpdates_;
+        std::atomic<int> cpu_;
+        std::atomic<int> numaNode_;
+        std::atomic<uint64_t> histogram_[LatencyHistogram::kBuckets];
+    };
+
+    // 单个 loop 的负载，供线程池挑选 loop 时无锁读取。
+    // 字节数只由 loop 线程累加；连接数在创建 / 析构 TcpConnection 的线程增减
+    class LoopLoad
+    {
+    public:
+        static constexpr int64_t kRateIntervalNanos = 100 * 1000 * 1000; // 速率最多 100ms 更新一次
+        static constexpr double kRateDecayNanos = 1e9;                    // 滑动平均的时间常数
+
+        LoopLoad();
+
+        void addBytes(int64_t n) { bytes_.store(bytes_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+        void addZeroCopy(int64_t sent, int64_t copied)
+        {
+            zeroCopyBytes_.store(zeroCopyBytes_.load(std::memory_order_relaxed) + sent, std::memory_order_relaxed);
+            zeroCopyCopiedBytes_.store(zeroCopyCopiedBytes_.load(std::memory_order_relaxed) + copied, std::memory_order_relaxed);
+        }
+        void connectionOpened() { connections_.fetch_add(1, std::memory_order_relaxed); }
+        void connectionClosed() { connections_.fetch_sub(1, std::memory_order_relaxed); }
+
+        // loop 线程每轮调用，间隔够长时把这段时间的字节数折入速率
+        void tick();
+
+        int connections() const { return connections_.load(std::memory_order_relaxed); }
+        int64_t zeroCopyBytes() const { return zeroCopyBytes_.load(std::memory_order_relaxed); }
+        int64_t zeroCopyCopiedBytes() const { return zeroCopyCopiedBytes_.load(std::memory_order_relaxed); }
+        // loop 长时间阻塞在 poll 中时没有 tick，读取时按空闲时长衰减
+        double bytesPerSecond() const;
+
+    private:
+        static int64_t coarseNanos();
+
+        std::atomic<int> connections_;
+        std::atomic<int64_t> bytes_;
+        std::atomic<int64_t> zeroCopyBytes_;
+        std::atomic<int64_t> zeroCopyCopiedBytes_;
+        int64_t lastBytes_; // 只在 loop 线程访问
+        std::atomic<int64_t> lastTickNanos_;
+        std::atomic<double> rate_;
+    };
+}
@@ -1,15 +1,16 @@
 #include "EventLoopThread.hpp"
 #include "Logger.hpp"
+#include "ThreadPlacement.hpp"
 #include <functional>
 namespace net
 {
     EventLoopThread::EventLoopThread(const ThreadInitCallback &initCallback, const std::string &name)
         : loop_(nullptr),
-
-          thread_(std::bind(&EventLoopThread::threadFunc, this)),
+          thread_(), // 线程在 startLoop() 中启动，保证其余成员已完成初始化
           callback_(initCallback), // 初始化回调
           exiting_(false),
-          name_(name) // 线程名称
+          name_(name), // 线程名称
+          cpu_(-1)
     {
     }
     EventLoopThread::EventLoopThread() : EventLoopThread(ThreadInitCallback(), "EventLoopThread")
@@ -22,6 +23,10 @@ namespace net
 
     EventLoop *EventLoopThread::startLoop()
     {
+        if (!thread_.joinable())
+        {
+            thread_ = std::thread(std::bind(&EventLoopThread::threadFunc, this));
+        }
         {
             std::unique_lock<std::mutex> lock(mutex_);
             while (loop_ == nullptr)
@@ -35,9 +40,12 @@ namespace net
     void EventLoopThread::stopLoop()
     {
         exiting_ = true;
-        if (loop_ != nullptr)
         {
-            loop_->quit();
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (loop_ != nullptr)
+            {
+                loop_->quit();
+            }
         }
         if (thread_.joinable())
         {
@@ -47,7 +55,13 @@ namespace net
 
     void EventLoopThread::threadFunc()
     {
+        // 先绑核，poller、定时器和后续缓冲区都在本地节点上分配
+        const bool bound = ThreadPlacement::bindCurrentThread(cpu_);
         EventLoop loop;
+        if (bound)
+        {
+            loop.setPlacement(cpu_, CpuTopology::instance().nodeOf(cpu_));
+        }
         if (callback_)
         {
             callback_(&loop);
@@ -58,6 +72,10 @@ namespace net
             cond_.notify_one();
         }
         loop.loop();
+        if (exitCallback_)
+        {
+            exitCallback_(&loop);
+        }
         {
             std::unique_lock<std::mutex> lock(mutex_);
             loop_ = nullptr;
@@ -16,6 +16,10 @@ namespace net
         ~EventLoopThread();
 
         EventLoop *getLoop() const { return loop_; }
+        // 须在 startLoop() 之前设置，线程在创建 EventLoop 之前绑定到 cpu，-1 表示不绑核
+        void setCpu(int cpu) { cpu_ = cpu; }
+        // 须在 startLoop() 之前设置，loop 退出后、EventLoop 销毁前在本线程调用
+        void setExitCallback(const ThreadInitCallback &cb) { exitCallback_ = cb; }
         EventLoop *startLoop();
         void stopLoop();
 
@@ -26,7 +30,9 @@ namespace net
         std::mutex mutex_;
         std::condition_variable cond_;
         ThreadInitCallback callback_;
+        ThreadInitCallback exitCallback_;
         bool exiting_;
         std::string name_;
+        int cpu_;
     };
 }
\ No newline at end of file
@@ -12,7 +12,9 @@ EventLoopThreadPool::EventLoopThreadPool(EventLoop *baseLoop, const std::string
       name_(nameArg),
       started_(false),
       numThreads_(0),
-      next_(0)
+      next_(0),
+      strategy_(LoadBalance::kRoundRobin),
+      random_(reinterpret_cast<uintptr_t>(this) | 1)
 {
 }
 
@@ -21,18 +23,24 @@ EventLoopThreadPool::~EventLoopThreadPool()
     LOG_DEBUG("EventLoopThreadPool::~EventLoopThreadPool()");
 }
 
-void EventLoopThreadPool::start(const ThreadInitCallback &cb)
+void EventLoopThreadPool::start(const ThreadInitCallback &cb, const ThreadInitCallback &exitCb)
 {
     assert(!started_);
     baseLoop_->assertInLoopThread();
 
     started_ = true;
 
+    if (placement_.policy() != ThreadPlacement::Policy::kNone)
+    {
+        LOG_INFO("%s: placing %d io threads (%s)", name_.c_str(), numThreads_, placement_.toString().c_str());
+    }
     for (int i = 0; i < numThreads_; ++i)
     {
         char buf[128];
         snprintf(buf, sizeof buf, "%s%d", name_.c_str(), i);
         threads_.push_back(std::unique_ptr<EventLoopThread>(new EventLoopThread(cb, buf)));
+        threads_.back()->setCpu(placement_.cpuFor(i));
+        threads_.back()->setExitCallback(exitCb);
         loops_.push_back(threads_.back()->startLoop());
     }
     if (numThreads_ == 0 && cb)
@@ -41,22 +49,99 @@ void EventLoopThreadPool::start(const ThreadInitCallback &cb)
     }
 }
 
-EventLoop *EventLoopThreadPool::getNextLoop()
+void EventLoopThreadPool::stop()
+{
+    baseLoop_->assertInLoopThread();
+    for (auto &thread : threads_)
+    {
+        thread->stopLoop();
+    }
+}
+
+EventLoop *EventLoopThreadPool::getNextLoop(size_t hashCode)
 {
     baseLoop_->assertInLoopThread();
     assert(started_);
-    EventLoop *loop = baseLoop_;
+    if (loops_.empty())
+    {
+        return baseLoop_;
+    }
+    if (chooser_)
+    {
+        return chooser_(loops_, hashCode);
+    }
 
-    if (!loops_.empty())
+    switch (strategy_)
+    {
+    case LoadBalance::kLeastConnections:
+        return leastLoaded([](const LoopLoad &a, const LoopLoad &b)
+                           { return a.connections() < b.connections(); });
+    case LoadBalance::kLeastBytesPerSecond:
+        return leastLoaded([](const LoopLoad &a, const LoopLoad &b)
+                           {
+                               const double ra = a.bytesPerSecond();
+                               const double rb = b.bytesPerSecond();
+                               return ra < rb || (ra == rb && a.connections() < b.connections()); });
+    case LoadBalance::kPowerOfTwoChoices:
+        return powerOfTwoChoices();
+    case LoadBalance::kHash:
+        return loops_[hashCode % loops_.size()];
+    case LoadBalance::kRoundRobin:
+        break;
+    }
+
+    EventLoop *loop = loops_[next_];
+    ++next_;
+    if (static_cast<size_t>(next_) >= loops_.size())
     {
-        loop = loops_[next_];
-        ++next_;
-        if (static_cast<size_t>(next_) >= loops_.size())
+        next_ = 0;
+    }
+    return loop;
+}
+
+template <typename Less>
+EventLoop *EventLoopThreadPool::leastLoaded(Less less)
+{
+    // 从 next_ 开始扫描，负载相同时依次轮到不同的 loop
+    const size_t n = loops_.size();
+    size_t best = static_cast<size_t>(next_);
+    for (size_t i = 1; i < n; ++i)
+    {
+        const size_t candidate = (static_cast<size_t>(next_) + i) % n;
+        if (less(loops_[candidate]->load(), loops_[best]->load()))
         {
-            next_ = 0;
+            best = candidate;
         }
     }
-    return loop;
+    next_ = static_cast<int>((static_cast<size_t>(next_) + 1) % n);
+    return loops_[best];
+}
+
+EventLoop *EventLoopThreadPool::powerOfTwoChoices()
+{
+    const size_t n = loops_.size();
+    if (n == 1)
+    {
+        return loops_[0];
+    }
+    random_ ^= random_ << 13;
+    random_ ^= random_ >> 7;
+    random_ ^= random_ << 17;
+    const size_t first = static_cast<size_t>(random_ % n);
+    size_t second = static_cast<size_t>((random_ >> 32) % (n - 1));
+    if (second >= first)
+    {
+        ++second;
+    }
+    const LoopLoad &a = loops_[first]->load();
+    const LoopLoad &b = loops_[second]->load();
+    const double ra = a.bytesPerSecond();
+    const double rb = b.bytesPerSecond();
+    if (ra != rb)
+    {
+        return ra < rb ? loops_[first] : loops_[second];
+    }
+    return a.connections() <= b.connections() ? loops_[first] : loops_[second];
 }
 
 EventLoop *EventLoopThreadPool::getLoopForHash(size_t hashCode)
@@ -84,4 +169,34 @@ std::vector<EventLoop *> EventLoopThreadPool::getAllLoops()
     {
         return loops_;
     }
-}
\ No newline at end of file
+}
+
+EventLoopStats EventLoopThreadPool::stats() const
+{
+    assert(started_);
+    if (loops_.empty())
+    {
+        return baseLoop_->stats();
+    }
+    EventLoopStats total;
+    for (EventLoop *loop : loops_)
+    {
+        total.merge(loop->stats());
+    }
+    return total;
+}
+
+std::vector<EventLoopStats> EventLoopThreadPool::statsPerLoop() const
+{
+    assert(started_);
+    std::vector<EventLoopStats> result;
+    if (loops_.empty())
+    {
+        result.push_back(baseLoop_->stats());
+    }
+    for (EventLoop *loop : loops_)
+    {
+        result.push_back(loop->stats());
+    }
+    return result;
+}
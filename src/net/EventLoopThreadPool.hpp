@@ -4,6 +4,8 @@
 #include <memory>
 #include "EventLoopThread.hpp"
 #include "Noncopyable.hpp"
+#include "EventLoopStats.hpp"
+#include "ThreadPlacement.hpp"
 
 namespace net
 {
@@ -14,23 +16,60 @@ namespace net
     {
     public:
         typedef std::function<void(EventLoop *)> ThreadInitCallback;
+        // 自定义挑选策略：从 loops 中选一个，hashCode 由调用方给出（如对端地址的哈希）
+        typedef std::function<EventLoop *(const std::vector<EventLoop *> &loops, size_t hashCode)> LoopChooser;
+
+        // getNextLoop 的内置策略，负载数据来自各 loop 的 LoopLoad，读取不加锁
+        enum class LoadBalance
+        {
+            kRoundRobin,          // 轮询（默认）
+            kLeastConnections,    // 连接数最少
+            kLeastBytesPerSecond, // 收发速率最低，速率相同再比连接数
+            kPowerOfTwoChoices,   // 随机取两个，选速率较低的一个
+            kHash,                // 按 hashCode 固定到某个 loop，同 getLoopForHash
+        };
 
         EventLoopThreadPool(EventLoop *baseLoop, const std::string &nameArg);
         ~EventLoopThreadPool();
 
         void setThreadNum(int numThreads) { numThreads_ = numThreads; }
-        void start(const ThreadInitCallback &cb = ThreadInitCallback());
+        // 第 i 个 IO 线程绑定到 placement.cpuFor(i)，须在 start() 之前设置
+        void setThreadPlacement(const ThreadPlacement &placement) { placement_ = placement; }
+        // cb 在每个 IO 线程进入 loop 前调用（未开线程时在 baseLoop 上调用），
+        // exitCb 在每个 IO 线程的 loop 退出后、EventLoop 销毁前调用，无论 loop 因 stop() 还是其他原因退出
+        void start(const ThreadInitCallback &cb = ThreadInitCallback(), const ThreadInitCallback &exitCb = ThreadInitCallback());
+        // 退出并回收所有 IO 线程，之后不能再挑选 loop 或读取统计，可重复调用
+        void stop();
+
+        void setLoadBalance(LoadBalance strategy) { strategy_ = strategy; }
+        // 设置后优先于 setLoadBalance 的内置策略
+        void setLoopChooser(LoopChooser chooser) { chooser_ = std::move(chooser); }
 
-        EventLoop *getNextLoop();
+        // 按当前策略挑选 IO loop，hashCode 只有 kHash 和自定义策略使用
+        EventLoop *getNextLoop(size_t hashCode = 0);
+        // 当前策略是否用到 getNextLoop 的 hashCode，不用时调用方可省去计算
+        bool usesHashCode() const { return chooser_ || strategy_ == LoadBalance::kHash; }
         EventLoop *getLoopForHash(size_t hashCode);
         std::vector<EventLoop *> getAllLoops();
+        // 所有 IO loop 的统计之和（未开线程时为 baseLoop），start() 之后可在任意线程调用
+        EventLoopStats stats() const;
+        // 每个 IO loop 各自的统计，可用来查看各线程的绑核情况
+        std::vector<EventLoopStats> statsPerLoop() const;
 
     private:
+        template <typename Less>
+        EventLoop *leastLoaded(Less less);
+        EventLoop *powerOfTwoChoices();
+
         EventLoop *baseLoop_;
         std::string name_;
         bool started_;
         int numThreads_;
         int next_;
+        ThreadPlacement placement_;
+        LoadBalance strategy_;
+        LoopChooser chooser_;
+        uint64_t random_; // xorshift 状态，只在 baseLoop 线程使用
         std::vector<std::unique_ptr<EventLoopThread>> threads_;
         std::vector<EventLoop *> loops_;
     };
@@ -1,5 +1,6 @@
 #include "InetAddress.hpp"
 #include "Logger.hpp"
+#include <cstdint>
 #include <cstring>
 namespace net
 {
@@ -47,6 +48,24 @@ namespace net
         }
     }
 
+    size_t InetAddress::ipHash() const
+    {
+        // FNV-1a，IPv4 取 4 字节地址，IPv6 取 16 字节地址
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&addr4_.sin_addr);
+        size_t len = sizeof(addr4_.sin_addr);
+        if (addr6_.sin6_family == AF_INET6)
+        {
+            bytes = addr6_.sin6_addr.s6_addr;
+            len = sizeof(addr6_.sin6_addr);
+        }
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < len; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return static_cast<size_t>(hash);
+    }
+
     std::string InetAddress::ip() const
     {
         char buf[INET6_ADDRSTRLEN];
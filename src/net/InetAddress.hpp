@@ -14,6 +14,8 @@ namespace net
         explicit InetAddress(const struct sockaddr_in6 &addr) : addr6_(addr) {}
 
         std::string ip() const;
+        // 只由 IP 决定的哈希，直接对地址字节计算，不格式化字符串
+        size_t ipHash() const;
         std::string toIpPort() const;
         uint16_t toPort() const;
 
@@ -0,0 +1,773 @@
+#include "IoUringPoller.hpp"
+#include "Channel.hpp"
+#include "Logger.hpp"
+#include <linux/io_uring.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+namespace net
+{
+    namespace
+    {
+        int ioUringSetup(unsigned entries, io_uring_params *params)
+        {
+            return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, void *arg, size_t argSize)
+        {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize));
+        }
+
+        int ioUringRegister(int fd, unsigned opcode, void *arg, unsigned nrArgs)
+        {
+            return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+        }
+    }
+
+    IoUringPoller *IoUringPoller::create(EventLoop *loop)
+    {
+        IoUringPoller *poller = new IoUringPoller(loop);
+        if (!poller->setupRing())
+        {
+            delete poller;
+            return nullptr;
+        }
+        poller->setupBufferRing();
+        return poller;
+    }
+
+    IoUringPoller::IoUringPoller(EventLoop *loop)
+        : Poller(loop),
+          ringFd_(-1),
+          sqRing_(nullptr),
+          sqRingSize_(0),
+          cqRing_(nullptr),
+          cqRingSize_(0),
+          sqes_(nullptr),
+          sqesSize_(0),
+          sqHead_(nullptr),
+          sqTail_(nullptr),
+          sqMask_(0),
+          sqArray_(nullptr),
+          sqEntries_(0),
+          cqHead_(nullptr),
+          cqTail_(nullptr),
+          cqMask_(0),
+          cqes_(nullptr),
+          sqPending_(0),
+          bufRing_(nullptr),
+          bufRingSize_(0),
+          recvBuffers_(nullptr),
+          recvEnabled_(false),
+          acceptEnabled_(true),
+          sendEnabled_(true),
+          nextEpoch_(1),
+          pollStamp_(0)
+    {
+    }
+
+    IoUringPoller::~IoUringPoller()
+    {
+        if (cqes_ != nullptr)
+        {
+            // 已被内核接受、还没交给 channel 的连接
+            const unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+            for (unsigned head = *cqHead_; head != tail; ++head)
+            {
+                const io_uring_cqe &cqe = cqes_[head & cqMask_];
+                if (static_cast<Op>(cqe.user_data >> 60) == kOpAccept && cqe.res >= 0)
+                {
+                    ::close(cqe.res);
+                }
+            }
+        }
+        if (bufRing_ != nullptr)
+        {
+            ::munmap(bufRing_, bufRingSize_);
+        }
+        if (recvBuffers_ != nullptr)
+        {
+            ::munmap(recvBuffers_, static_cast<size_t>(kRecvBuffers) * kRecvBufferSize);
+        }
+        if (sqes_ != nullptr)
+        {
+            ::munmap(sqes_, sqesSize_);
+        }
+        if (cqRing_ != nullptr && cqRing_ != sqRing_)
+        {
+            ::munmap(cqRing_, cqRingSize_);
+        }
+        if (sqRing_ != nullptr)
+        {
+            ::munmap(sqRing_, sqRingSize_);
+        }
+        if (ringFd_ >= 0)
+        {
+            ::close(ringFd_); // 关闭 ring 时内核会取消所有未完成的请求
+        }
+    }
+
+    bool IoUringPoller::setupRing()
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_COOP_TASKRUN;
+        params.cq_entries = kCqEntries;
+        ringFd_ = ioUringSetup(kSqEntries, &params);
+        if (ringFd_ < 0 && errno == EINVAL)
+        {
+            // 5.19 之前的内核不认识 COOP_TASKRUN
+            std::memset(&params, 0, sizeof(params));
+            params.flags = IORING_SETUP_CQSIZE;
+            params.cq_entries = kCqEntries;
+            ringFd_ = ioUringSetup(kSqEntries, &params);
+        }
+        if (ringFd_ < 0)
+        {
+            LOG_WARN("io_uring_setup failed: %s", strerror(errno));
+            return false;
+        }
+        // EXT_ARG (5.11) 用于带超时的等待，RSRC_TAGS (5.13) 与多发 poll 同期引入，用作其存在的标志
+        const unsigned required = IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG | IORING_FEAT_RSRC_TAGS;
+        if ((params.features & required) != required)
+        {
+            LOG_WARN("io_uring lacks required features (0x%x)", params.features);
+            return false;
+        }
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap)
+        {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+        void *sq = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+        if (sq == MAP_FAILED)
+        {
+            LOG_WARN("io_uring sq ring mmap failed: %s", strerror(errno));
+            return false;
+        }
+        sqRing_ = sq;
+        if (singleMmap)
+        {
+            cqRing_ = sqRing_;
+        }
+        else
+        {
+            void *cq = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_CQ_RING);
+            if (cq == MAP_FAILED)
+            {
+                LOG_WARN("io_uring cq ring mmap failed: %s", strerror(errno));
+                return false;
+            }
+            cqRing_ = cq;
+        }
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        void *sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+        {
+            LOG_WARN("io_uring sqes mmap failed: %s", strerror(errno));
+            return false;
+        }
+        sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+        char *sqBase = static_cast<char *>(sqRing_);
+        sqHead_ = reinterpret_cast<unsigned *>(sqBase + params.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned *>(sqBase + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned *>(sqBase + params.sq_off.ring_mask);
+        sqEntries_ = *reinterpret_cast<unsigned *>(sqBase + params.sq_off.ring_entries);
+        sqArray_ = reinterpret_cast<unsigned *>(sqBase + params.sq_off.array);
+
+        char *cqBase = static_cast<char *>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned *>(cqBase + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned *>(cqBase + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned *>(cqBase + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe *>(cqBase + params.cq_off.cqes);
+        return true;
+    }
+
+    void IoUringPoller::setupBufferRing()
+    {
+        bufRingSize_ = kRecvBuffers * sizeof(io_uring_buf);
+        void *ring = ::mmap(nullptr, bufRingSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        void *buffers = ::mmap(nullptr, static_cast<size_t>(kRecvBuffers) * kRecvBufferSize,
+                               PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ring == MAP_FAILED || buffers == MAP_FAILED)
+        {
+            LOG_WARN("io_uring buffer ring allocation failed: %s", strerror(errno));
+            if (ring != MAP_FAILED)
+            {
+                ::munmap(ring, bufRingSize_);
+            }
+            if (buffers != MAP_FAILED)
+            {
+                ::munmap(buffers, static_cast<size_t>(kRecvBuffers) * kRecvBufferSize);
+            }
+            return;
+        }
+        bufRing_ = static_cast<io_uring_buf_ring *>(ring);
+        recvBuffers_ = static_cast<char *>(buffers);
+
+        io_uring_buf_reg reg;
+        std::memset(&reg, 0, sizeof(reg));
+        reg.ring_addr = reinterpret_cast<uint64_t>(bufRing_);
+        reg.ring_entries = kRecvBuffers;
+        reg.bgid = kBufferGroup;
+        if (ioUringRegister(ringFd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+        {
+            LOG_INFO("io_uring buffer ring unsupported (%s), reads use poll readiness", strerror(errno));
+            return;
+        }
+        for (uint16_t bid = 0; bid < kRecvBuffers; ++bid)
+        {
+            deliveredBuffers_.push_back(bid);
+        }
+        recycleBuffers();
+        recvEnabled_ = true;
+    }
+
+    base::Timestamp IoUringPoller::poll(int timeoutMs, ChannelList *activeChannels)
+    {
+        ++pollStamp_;
+        recycleBuffers();
+        for (int fd : dirtyFds_)
+        {
+            Registration *reg = findRegistration(fd);
+            if (reg != nullptr && reg->dirty)
+            {
+                reg->dirty = false;
+                const unsigned before = *sqTail_;
+                sync(fd, *reg);
+                if (*sqTail_ != before)
+                {
+                    ++updatesIssued_;
+                }
+            }
+        }
+        dirtyFds_.clear();
+
+        // 提交本轮积累的 SQE 并等待完成事件，合并为一次系统调用
+        __kernel_timespec ts;
+        ts.tv_sec = timeoutMs / 1000;
+        ts.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+        io_uring_getevents_arg arg;
+        std::memset(&arg, 0, sizeof(arg));
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts = timeoutMs < 0 ? 0 : reinterpret_cast<uint64_t>(&ts);
+
+        unsigned flags = IORING_ENTER_EXT_ARG;
+        unsigned minComplete = 0;
+        const bool ready = *cqHead_ != __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        if (!ready && timeoutMs != 0)
+        {
+            flags |= IORING_ENTER_GETEVENTS;
+            minComplete = 1;
+        }
+        int ret = ioUringEnter(ringFd_, sqPending_, minComplete, flags, &arg, sizeof(arg));
+        int savedErrno = errno;
+        base::Timestamp now(base::Timestamp::now());
+        if (ret >= 0)
+        {
+            sqPending_ -= std::min(static_cast<unsigned>(ret), sqPending_);
+        }
+        else if (savedErrno != ETIME && savedErrno != EINTR)
+        {
+            LOG_ERROR("IoUringPoller::poll() error: %s", strerror(savedErrno));
+        }
+
+        unsigned head = *cqHead_;
+        const unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        while (head != tail)
+        {
+            handleCompletion(cqes_[head & cqMask_], activeChannels);
+            ++head;
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+        if (!activeChannels->empty())
+        {
+            LOG_DEBUG("io_uring return %zu channels in thread %d", activeChannels->size(), gettid());
+        }
+        return now;
+    }
+
+    void IoUringPoller::handleCompletion(const io_uring_cqe &cqe, ChannelList *activeChannels)
+    {
+        const uint64_t userData = cqe.user_data;
+        const Op op = static_cast<Op>(userData >> 60);
+        if (op == kOpIgnore)
+        {
+            return;
+        }
+        const uint8_t gen = static_cast<uint8_t>((userData >> 52) & 0xFF);
+        const uint32_t epoch = static_cast<uint32_t>((userData >> 32) & 0xFFFFF);
+        const int fd = static_cast<int>(userData & 0xFFFFFFFF);
+        Registration *reg = findRegistration(fd);
+        const bool live = reg != nullptr && (reg->epoch & 0xFFFFF) == epoch;
+
+        switch (op)
+        {
+        case kOpRecv:
+            handleRecv(cqe, fd, reg, live, activeChannels);
+            return;
+        case kOpAccept:
+            handleAccept(cqe, fd, reg, live, activeChannels);
+            return;
+        case kOpSend:
+            handleSend(cqe, fd, reg, live, activeChannels);
+            return;
+        default:
+            break;
+        }
+
+        if (!live || gen != reg->pollGen)
+        {
+            return; // 已被取消或掩码已变的旧 poll
+        }
+        if ((cqe.flags & IORING_CQE_F_MORE) == 0)
+        {
+            reg->pollInFlight = false; // 单发 poll 触发后需要重新提交
+            markDirty(fd, *reg);
+        }
+        if (cqe.res > 0)
+        {
+            activate(*reg, cqe.res, activeChannels);
+        }
+        else if (cqe.res < 0 && cqe.res != -ECANCELED)
+        {
+            LOG_ERROR("io_uring poll fd = %d error: %s", fd, strerror(-cqe.res));
+        }
+    }
+
+    void IoUringPoller::handleRecv(const io_uring_cqe &cqe, int fd, Registration *reg, bool live, ChannelList *activeChannels)
+    {
+        const bool hasBuffer = (cqe.flags & IORING_CQE_F_BUFFER) != 0;
+        const uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        if (hasBuffer)
+        {
+            deliveredBuffers_.push_back(bid); // 本轮回调结束后归还
+        }
+        if (!live)
+        {
+            return; // 已注销的 channel，数据随缓冲区一起丢弃
+        }
+        if ((cqe.flags & IORING_CQE_F_MORE) == 0)
+        {
+            reg->recvInFlight = false;
+            reg->recvCancelling = false;
+            markDirty(fd, *reg);
+        }
+        if (cqe.res > 0 && hasBuffer)
+        {
+            reg->channel->addCompletedRead(recvBuffers_ + static_cast<size_t>(bid) * kRecvBufferSize,
+                                           static_cast<size_t>(cqe.res));
+            activate(*reg, POLLIN, activeChannels);
+        }
+        else if (cqe.res == 0)
+        {
+            reg->channel->setCompletedReadStatus(0);
+            activate(*reg, POLLIN, activeChannels);
+        }
+        else if (cqe.res == -EINVAL)
+        {
+            // 内核不支持多发 recv，回退到 poll 就绪通知
+            LOG_WARN("io_uring multishot recv unsupported, falling back to poll readiness");
+            recvEnabled_ = false;
+        }
+        else if (cqe.res != -ENOBUFS && cqe.res != -ECANCELED)
+        {
+            reg->channel->setCompletedReadStatus(cqe.res);
+            activate(*reg, POLLIN, activeChannels);
+        }
+        // ENOBUFS：缓冲区暂时用完，下一轮归还后重新提交
+    }
+
+    void IoUringPoller::handleAccept(const io_uring_cqe &cqe, int fd, Registration *reg, bool live, ChannelList *activeChannels)
+    {
+        if (!live)
+        {
+            if (cqe.res >= 0)
+            {
+                ::close(cqe.res); // 监听 channel 已注销，没有人接管这个连接
+            }
+            return;
+        }
+        if ((cqe.flags & IORING_CQE_F_MORE) == 0)
+        {
+            // 出错（如 EMFILE）或被取消后多发 accept 结束，下一轮按需重新提交
+            reg->acceptInFlight = false;
+            reg->acceptCancelling = false;
+            markDirty(fd, *reg);
+        }
+        if (cqe.res == -EINVAL)
+        {
+            LOG_WARN("io_uring multishot accept unsupported, falling back to poll readiness");
+            acceptEnabled_ = false;
+        }
+        else if (cqe.res != -ECANCELED)
+        {
+            reg->channel->addCompletedAccept(cqe.res);
+            activate(*reg, POLLIN, activeChannels);
+        }
+    }
+
+    void IoUringPoller::handleSend(const io_uring_cqe &cqe, int fd, Registration *reg, bool live, ChannelList *activeChannels)
+    {
+        if (!live)
+        {
+            // channel 已注销：内核不再读取这次发送的数据，释放 removeChannel 保留的所有者
+            auto it = std::find_if(retainedSends_.begin(), retainedSends_.end(),
+                                   [&cqe](const std::pair<uint64_t, std::shared_ptr<void>> &retained)
+                                   { return retained.first == cqe.user_data; });
+            if (it != retainedSends_.end())
+            {
+                std::shared_ptr<void> owner = std::move(it->second); // 可能是最后一个引用，移出后再析构
+                std::swap(*it, retainedSends_.back());
+                retainedSends_.pop_back();
+            }
+            return;
+        }
+        reg->sendInFlight = false;
+        markDirty(fd, *reg); // 还有数据时下一轮继续提交
+        if (cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP)
+        {
+            // 数据没有发出，仍在 channel 的缓冲区里，改由可写通知驱动
+            LOG_WARN("io_uring sendmsg failed (%s), falling back to poll readiness", strerror(-cqe.res));
+            sendEnabled_ = false;
+        }
+        else if (cqe.res != -ECANCELED)
+        {
+            reg->channel->setCompletedWrite(cqe.res);
+            activate(*reg, POLLOUT, activeChannels);
+        }
+    }
+
+    void IoUringPoller::activate(Registration &reg, int revents, ChannelList *activeChannels)
+    {
+        if (reg.activeStamp != pollStamp_)
+        {
+            reg.activeStamp = pollStamp_;
+            reg.channel->setRevents(revents);
+            activeChannels->push_back(reg.channel);
+        }
+        else
+        {
+            reg.channel->setRevents(reg.channel->revents() | revents);
+        }
+    }
+
+    void IoUringPoller::updateChannel(Channel *channel)
+    {
+        const int fd = channel->fd();
+        assert(fd >= 0);
+        if (static_cast<size_t>(fd) >= registrations_.size())
+        {
+            registrations_.resize(std::max<size_t>(fd + 1, registrations_.size() * 2));
+        }
+        Registration &reg = registrations_[fd];
+        if (reg.channel == nullptr)
+        {
+            reg = Registration();
+            reg.channel = channel;
+            reg.epoch = nextEpoch_++;
+            channel->setIndex(1);
+        }
+        assert(reg.channel == channel);
+        ++updateRequests_;
+        markDirty(fd, reg); // 推迟到下一次 poll 统一提交，同一轮内的多次修改只产生一组 SQE
+    }
+
+    void IoUringPoller::removeChannel(Channel *channel)
+    {
+        const int fd = channel->fd();
+        Registration *reg = findRegistration(fd);
+        assert(reg != nullptr && reg->channel == channel);
+        assert(channel->isNoneEvent());
+        if (reg->pollInFlight)
+        {
+            cancel(encode(kOpPoll, reg->pollGen, reg->epoch, fd));
+        }
+        if (reg->recvInFlight && !reg->recvCancelling)
+        {
+            cancel(encode(kOpRecv, 0, reg->epoch, fd));
+        }
+        if (reg->acceptInFlight && !reg->acceptCancelling)
+        {
+            // 立即提交：多发 accept 持有监听 socket 的引用，不能等到下一轮，否则端口一直被占用
+            cancel(encode(kOpAccept, 0, reg->epoch, fd));
+            submitPending();
+        }
+        if (reg->sendInFlight)
+        {
+            // channel 的所有者随后可能释放发送缓冲区：保留所有者到取消后的完成事件到达，不在这里阻塞等待
+            const uint64_t userData = encode(kOpSend, 0, reg->epoch, fd);
+            std::shared_ptr<void> owner = channel->completedWriteOwner();
+            if (owner)
+            {
+                cancel(userData);
+                retainedSends_.emplace_back(userData, std::move(owner));
+            }
+            else
+            {
+                cancelSendAndWait(userData);
+            }
+        }
+        *reg = Registration();
+        channel->setIndex(-1);
+    }
+
+    bool IoUringPoller::hasChannel(Channel *channel) const
+    {
+        const int fd = channel->fd();
+        return fd >= 0 && static_cast<size_t>(fd) < registrations_.size() && registrations_[fd].channel == channel;
+    }
+
+    IoUringPoller::Registration *IoUringPoller::findRegistration(int fd)
+    {
+        if (fd < 0 || static_cast<size_t>(fd) >= registrations_.size() || registrations_[fd].channel == nullptr)
+        {
+            return nullptr;
+        }
+        return &registrations_[fd];
+    }
+
+    void IoUringPoller::markDirty(int fd, Registration &reg)
+    {
+        if (!reg.dirty)
+        {
+            reg.dirty = true;
+            dirtyFds_.push_back(fd);
+        }
+    }
+
+    void IoUringPoller::sync(int fd, Registration &reg)
+    {
+        Channel *channel = reg.channel;
+        const int events = channel->pollEvents();
+        const bool edgeTriggered = (events & static_cast<int>(EPOLLET)) != 0;
+        const bool wantRecv = recvEnabled_ && channel->completedReadEnabled() && channel->isReading();
+        const bool wantAccept = acceptEnabled_ && channel->completedAcceptEnabled() && channel->isReading();
+        const bool wantSend = sendEnabled_ && channel->completedWriteEnabled() && channel->isWriting();
+        uint32_t mask = static_cast<uint32_t>(events) & ~static_cast<uint32_t>(EPOLLET);
+        if (wantRecv || wantAccept)
+        {
+            mask &= ~static_cast<uint32_t>(POLLIN | POLLPRI); // 可读由 recv / accept 负责
+        }
+
+        if (wantRecv && !reg.recvInFlight)
+        {
+            armRecv(fd, reg);
+        }
+        else if (!wantRecv && reg.recvInFlight && !reg.recvCancelling)
+        {
+            cancel(encode(kOpRecv, 0, reg.epoch, fd));
+            reg.recvCancelling = true;
+        }
+
+        if (wantAccept && !reg.acceptInFlight)
+        {
+            armAccept(fd, reg);
+        }
+        else if (!wantAccept && reg.acceptInFlight && !reg.acceptCancelling)
+        {
+            cancel(encode(kOpAccept, 0, reg.epoch, fd));
+            reg.acceptCancelling = true;
+        }
+
+        // 在途的发送完成前不再提交；没有可发的内存段（如文件段）时退回可写通知
+        if (reg.sendInFlight || (wantSend && armSend(fd, reg)))
+        {
+            mask &= ~static_cast<uint32_t>(POLLOUT);
+        }
+
+        if (reg.pollInFlight && (mask != reg.pollMask || edgeTriggered != reg.pollMultishot))
+        {
+            cancel(encode(kOpPoll, reg.pollGen, reg.epoch, fd));
+            reg.pollInFlight = false;
+            ++reg.pollGen; // 旧 poll 迟到的完成事件按代数丢弃
+        }
+        if (!reg.pollInFlight && mask != 0)
+        {
+            armPoll(fd, reg, mask, edgeTriggered);
+        }
+    }
+
+    void IoUringPoller::armPoll(int fd, Registration &reg, uint32_t mask, bool multishot)
+    {
+        // 水平触发用单发 poll，触发后下一轮按最新关注位重新提交，语义与 epoll LT 一致
+        io_uring_sqe *sqe = getSqe();
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = fd;
+        sqe->poll32_events = mask;
+        sqe->len = multishot ? IORING_POLL_ADD_MULTI : 0;
+        sqe->user_data = encode(kOpPoll, reg.pollGen, reg.epoch, fd);
+        reg.pollMask = mask;
+        reg.pollMultishot = multishot;
+        reg.pollInFlight = true;
+    }
+
+    void IoUringPoller::armRecv(int fd, Registration &reg)
+    {
+        io_uring_sqe *sqe = getSqe();
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = fd;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = kBufferGroup;
+        sqe->user_data = encode(kOpRecv, 0, reg.epoch, fd);
+        reg.recvInFlight = true;
+    }
+
+    void IoUringPoller::armAccept(int fd, Registration &reg)
+    {
+        // 不带地址：多发请求共用一份 sockaddr 会被后面的连接覆盖，对端地址由 Acceptor 另行获取
+        io_uring_sqe *sqe = getSqe();
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->fd = fd;
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+        sqe->user_data = encode(kOpAccept, 0, reg.epoch, fd);
+        reg.acceptInFlight = true;
+    }
+
+    bool IoUringPoller::armSend(int fd, Registration &reg)
+    {
+        if (!reg.send)
+        {
+            reg.send.reset(new SendState);
+        }
+        int flags = 0;
+        const int iovcnt = reg.channel->prepareCompletedWrite(reg.send->vec, kSendIovecs, &flags);
+        if (iovcnt <= 0)
+        {
+            return false;
+        }
+        std::memset(&reg.send->msg, 0, sizeof(reg.send->msg));
+        reg.send->msg.msg_iov = reg.send->vec;
+        reg.send->msg.msg_iovlen = static_cast<size_t>(iovcnt);
+        io_uring_sqe *sqe = getSqe();
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(&reg.send->msg);
+        sqe->len = 1;
+        sqe->msg_flags = static_cast<uint32_t>(flags | MSG_NOSIGNAL);
+        sqe->user_data = encode(kOpSend, 0, reg.epoch, fd);
+        reg.sendInFlight = true;
+        return true;
+    }
+
+    void IoUringPoller::cancelSendAndWait(uint64_t userData)
+    {
+        cancel(userData);
+        submitPending();
+        // 发送若已挂在 socket 上等待空间，取消后会补一个完成事件；只看不取，留给下一轮 poll 按已注销丢弃
+        for (;;)
+        {
+            const unsigned head = *cqHead_;
+            const unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+            for (unsigned i = head; i != tail; ++i)
+            {
+                if (cqes_[i & cqMask_].user_data == userData)
+                {
+                    return;
+                }
+            }
+            // 等到多出一个完成事件，COOP_TASKRUN 下内核也在这里处理挂起的完成
+            if (ioUringEnter(ringFd_, 0, tail - head + 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                errno != EINTR && errno != ETIME)
+            {
+                LOG_ERROR("io_uring wait for cancelled send error: %s", strerror(errno));
+                return;
+            }
+        }
+    }
+
+    void IoUringPoller::drain()
+    {
+        // 取消请求已在 removeChannel 中排队，等它们的完成事件；期间报告的活跃 channel 不再处理
+        ChannelList ignored;
+        while (!retainedSends_.empty())
+        {
+            poll(100, &ignored);
+            ignored.clear();
+        }
+    }
+
+    void IoUringPoller::cancel(uint64_t userData)
+    {
+        io_uring_sqe *sqe = getSqe();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = userData;
+        sqe->user_data = encode(kOpIgnore, 0, 0, 0);
+    }
+
+    io_uring_sqe *IoUringPoller::getSqe()
+    {
+        unsigned tail = *sqTail_;
+        if (tail - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) >= sqEntries_)
+        {
+            submitPending(); // SQ 已满，先提交一批
+            tail = *sqTail_;
+        }
+        const unsigned index = tail & sqMask_;
+        io_uring_sqe *sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray_[index] = index;
+        // 没有 SQPOLL，内核只在 io_uring_enter 时读取 tail，调用方随后填写的字段一定可见
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+        ++sqPending_;
+        return sqe;
+    }
+
+    void IoUringPoller::submitPending()
+    {
+        while (sqPending_ > 0)
+        {
+            int ret = ioUringEnter(ringFd_, sqPending_, 0, 0, nullptr, 0);
+            if (ret < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                LOG_ERROR("io_uring_enter submit error: %s", strerror(errno));
+                return;
+            }
+            sqPending_ -= std::min(static_cast<unsigned>(ret), sqPending_);
+        }
+    }
+
+    void IoUringPoller::recycleBuffers()
+    {
+        if (deliveredBuffers_.empty() || bufRing_ == nullptr)
+        {
+            deliveredBuffers_.clear();
+            return;
+        }
+        // 只有本线程写 tail；注意 bufs[0] 的 resv 字段与 tail 重叠，只能逐个字段赋值。
+        // 内核头文件的柔性数组在 C++ 下会被空结构体挤到偏移 8，这里直接从环首地址取缓冲区数组
+        io_uring_buf *bufs = reinterpret_cast<io_uring_buf *>(bufRing_);
+        uint16_t tail = bufRing_->tail;
+        const unsigned mask = kRecvBuffers - 1;
+        for (uint16_t bid : deliveredBuffers_)
+        {
+            io_uring_buf *buf = &bufs[tail & mask];
+            buf->addr = reinterpret_cast<uint64_t>(recvBuffers_ + static_cast<size_t>(bid) * kRecvBufferSize);
+            buf->len = kRecvBufferSize;
+            buf->bid = bid;
+            ++tail;
+        }
+        __atomic_store_n(&bufRing_->tail, tail, __ATOMIC_RELEASE);
+        deliveredBuffers_.clear();
+    }
+} // namespace net
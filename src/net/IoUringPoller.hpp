@@ -0,0 +1,158 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "Poller.hpp"
+#include "Timer.hpp"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+namespace net
+{
+    class EventLoop;
+    class Channel;
+
+    // 基于 io_uring 的 Poller，直接使用系统调用，不依赖 liburing。
+    // 就绪通知用 POLL_ADD 实现：水平触发的 channel 每次触发后在下一轮重新提交单发 poll，
+    // 边沿触发的 channel 使用多发 poll；开启完成式读的 channel 改用多发 recv + 提供缓冲区环，
+    // 数据由内核直接写入缓冲区，省去每次可读后的 readv。
+    // 开启完成式接受的监听 channel 使用多发 accept，每个新连接一个完成事件，不再可读后循环 accept4；
+    // 设置了 writeSource 的 channel 关注可写时直接提交 sendmsg，省去可写通知和随后的 writev。
+    // 所有 SQE 在 poll() 里与等待合并为一次 io_uring_enter 提交，channel 的增删改和本轮所有连接的发送
+    // 不再各自产生系统调用。
+    class IoUringPoller : public Poller
+    {
+    public:
+        // 内核不支持（io_uring_setup 失败或缺少所需特性）时返回 nullptr
+        static IoUringPoller *create(EventLoop *loop);
+        ~IoUringPoller() override;
+
+        base::Timestamp poll(int timeoutMs, ChannelList *activeChannels) override;
+        void updateChannel(Channel *channel) override;
+        void removeChannel(Channel *channel) override;
+        bool hasChannel(Channel *channel) const override;
+        const char *name() const override { return "io_uring"; }
+
+        bool completedWriteEnabled() const override { return sendEnabled_; }
+        void drain() override;
+
+        // 多发 recv 是否可用（需要 5.19+ 的提供缓冲区环与 6.0+ 的多发 recv）
+        bool recvMultishotEnabled() const { return recvEnabled_; }
+        // 多发 accept 是否可用（5.19+）
+        bool acceptMultishotEnabled() const { return acceptEnabled_; }
+
+    private:
+        static const unsigned kSqEntries = 1024;
+        static const unsigned kCqEntries = 16384;
+        static const unsigned kRecvBuffers = 256; // 必须是 2 的幂
+        static const unsigned kRecvBufferSize = 16 * 1024;
+        static const uint16_t kBufferGroup = 0;
+        static const int kSendIovecs = 64; // 每次 sendmsg 最多的段数，slab 为 16 KB 时约 1 MB
+
+        // user_data 编码：op(4) | gen(8) | epoch(20) | fd(32)
+        enum Op : uint64_t
+        {
+            kOpIgnore = 0, // 取消请求本身的完成事件
+            kOpPoll = 1,
+            kOpRecv = 2,
+            kOpAccept = 3,
+            kOpSend = 4,
+        };
+
+        // 在途 sendmsg 的参数，内核在完成前可能还要读取
+        struct SendState
+        {
+            struct msghdr msg;
+            struct iovec vec[kSendIovecs];
+        };
+
+        // 每个 fd 的注册状态，epoch 区分 fd 被关闭后复用的新注册
+        struct Registration
+        {
+            Channel *channel = nullptr;
+            uint32_t epoch = 0;
+            uint8_t pollGen = 0;
+            uint32_t pollMask = 0;
+            bool pollMultishot = false;
+            bool pollInFlight = false;
+            bool recvInFlight = false;
+            bool recvCancelling = false;
+            bool acceptInFlight = false;
+            bool acceptCancelling = false;
+            bool sendInFlight = false;
+            bool dirty = false;
+            uint64_t activeStamp = 0;
+            std::unique_ptr<SendState> send; // 第一次提交发送时分配
+        };
+
+        explicit IoUringPoller(EventLoop *loop);
+        bool setupRing();
+        void setupBufferRing();
+
+        io_uring_sqe *getSqe();
+        void submitPending();
+        void markDirty(int fd, Registration &reg);
+        void sync(int fd, Registration &reg);
+        void armPoll(int fd, Registration &reg, uint32_t mask, bool multishot);
+        void armRecv(int fd, Registration &reg);
+        void armAccept(int fd, Registration &reg);
+        // 向 channel 取待发数据并提交 sendmsg，没有可发的内存段时返回 false
+        bool armSend(int fd, Registration &reg);
+        // 取消在途的发送并等到它的完成事件出现，之后内核不再读取发送的数据；仅用于没有数据所有者可保留的 channel
+        void cancelSendAndWait(uint64_t userData);
+        void handleRecv(const io_uring_cqe &cqe, int fd, Registration *reg, bool live, ChannelList *activeChannels);
+        void handleAccept(const io_uring_cqe &cqe, int fd, Registration *reg, bool live, ChannelList *activeChannels);
+        void handleSend(const io_uring_cqe &cqe, int fd, Registration *reg, bool live, ChannelList *activeChannels);
+        void cancel(uint64_t userData);
+        void handleCompletion(const io_uring_cqe &cqe, ChannelList *activeChannels);
+        void activate(Registration &reg, int revents, ChannelList *activeChannels);
+        void recycleBuffers();
+        Registration *findRegistration(int fd);
+
+        static uint64_t encode(Op op, uint8_t gen, uint32_t epoch, int fd)
+        {
+            return (static_cast<uint64_t>(op) << 60) | (static_cast<uint64_t>(gen) << 52) |
+                   (static_cast<uint64_t>(epoch & 0xFFFFF) << 32) | static_cast<uint32_t>(fd);
+        }
+
+        int ringFd_;
+        // SQ / CQ 环映射
+        void *sqRing_;
+        size_t sqRingSize_;
+        void *cqRing_;
+        size_t cqRingSize_;
+        io_uring_sqe *sqes_;
+        size_t sqesSize_;
+        unsigned *sqHead_;
+        unsigned *sqTail_;
+        unsigned sqMask_;
+        unsigned *sqArray_;
+        unsigned sqEntries_;
+        unsigned *cqHead_;
+        unsigned *cqTail_;
+        unsigned cqMask_;
+        io_uring_cqe *cqes_;
+        unsigned sqPending_; // 已填写、尚未提交的 SQE 数
+
+        // 提供给多发 recv 的缓冲区环
+        io_uring_buf_ring *bufRing_;
+        size_t bufRingSize_;
+        char *recvBuffers_;
+        bool recvEnabled_;
+        std::vector<uint16_t> deliveredBuffers_; // 上一轮交给 channel 的缓冲区，下一轮 poll 时归还
+        bool acceptEnabled_;
+        bool sendEnabled_;
+        // 已注销 channel 在途发送的 user_data 与数据所有者，收到该发送的完成事件后释放
+        std::vector<std::pair<uint64_t, std::shared_ptr<void>>> retainedSends_;
+
+        std::vector<Registration> registrations_; // 以 fd 为下标
+        std::vector<int> dirtyFds_;
+        uint32_t nextEpoch_;
+        uint64_t pollStamp_;
+    };
+} // namespace net
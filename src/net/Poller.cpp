@@ -1,12 +1,33 @@
-
 #include "Poller.hpp"
 #include "EpollPoller.hpp"
+#include "IoUringPoller.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 namespace net
 {
 
-    Poller::Poller(EventLoop *loop) : loop_(loop), channels_()
+    Poller::Poller(EventLoop *loop) : loop_(loop), channels_(), numChannels_(0), updateRequests_(0), updatesIssued_(0)
+    {
+    }
+
+    void Poller::addChannel(int fd, Channel *channel)
+    {
+        if (static_cast<size_t>(fd) >= channels_.size())
+        {
+            // 按 2 倍增长，避免 fd 逐个递增时反复扩容
+            channels_.resize(std::max<size_t>(static_cast<size_t>(fd) + 1, channels_.size() * 2), nullptr);
+        }
+        channels_[fd] = channel;
+        ++numChannels_;
+    }
+
+    void Poller::eraseChannel(int fd)
     {
+        channels_[fd] = nullptr;
+        --numChannels_;
     }
 
     Poller::~Poller() = default;
@@ -14,7 +35,26 @@ namespace net
     // 实现静态工厂方法
     Poller *Poller::newDefaultPoller(EventLoop *loop)
     {
+        return newPoller(loop, PollerBackend::kDefault);
+    }
+
+    Poller *Poller::newPoller(EventLoop *loop, PollerBackend backend)
+    {
+        if (backend == PollerBackend::kDefault)
+        {
+            const char *env = ::getenv("RTSP_POLLER");
+            backend = (env != nullptr && std::strcmp(env, "io_uring") == 0) ? PollerBackend::kIoUring
+                                                                             : PollerBackend::kEpoll;
+        }
+        if (backend == PollerBackend::kIoUring)
+        {
+            if (Poller *poller = IoUringPoller::create(loop))
+            {
+                return poller;
+            }
+            LOG_WARN("io_uring is not available, falling back to epoll");
+        }
         return new EpollPoller(loop);
     }
 
-} // namespace net
\ No newline at end of file
+} // namespace net
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <map>
+#include <cstdint>
 #include <vector>
 #include "Timer.hpp"
 #include "Noncopyable.hpp"
@@ -10,24 +10,54 @@ namespace net
     class EventLoop;
     class Channel;
     class EpollPoller;
+
+    // kDefault 读取环境变量 RTSP_POLLER（epoll / io_uring），未设置时使用 epoll
+    enum class PollerBackend
+    {
+        kDefault,
+        kEpoll,
+        kIoUring
+    };
+
     class Poller : base::Noncopyable
     {
     public:
         using ChannelList = std::vector<Channel *>;
         explicit Poller(EventLoop *loop);
 
-        ~Poller();
+        virtual ~Poller();
 
         virtual base::Timestamp poll(int timeoutMs, ChannelList *activeChannels) = 0;
         virtual void updateChannel(Channel *channel) = 0;
         virtual void removeChannel(Channel *channel) = 0;
         virtual bool hasChannel(Channel *channel) const = 0;
+        virtual const char *name() const = 0;
+        // 是否会为设置了 writeSource 的 channel 直接提交发送（见 Channel::setCompletedWriteSource）
+        virtual bool completedWriteEnabled() const { return false; }
+        // loop 析构前调用：等待注销 channel 时仍在途的异步请求结束，释放它们引用的数据
+        virtual void drain() {}
+
+        // updateChannel 请求数减去实际提交给内核的次数，即合并掉的 epoll_ctl / SQE
+        int64_t avoidedUpdates() const { return updateRequests_ - updatesIssued_; }
 
         static Poller *newDefaultPoller(EventLoop *loop);
+        // 内核不支持所选后端时回退到 epoll
+        static Poller *newPoller(EventLoop *loop, PollerBackend backend);
 
     protected:
-        using ChannelMap = std::map<int, Channel *>;
+        // 以 fd 为下标的 channel 表，空位为 nullptr。内核总是分配最小的可用 fd，表保持稠密
+        using ChannelTable = std::vector<Channel *>;
+        Channel *findChannel(int fd) const
+        {
+            return fd >= 0 && static_cast<size_t>(fd) < channels_.size() ? channels_[fd] : nullptr;
+        }
+        void addChannel(int fd, Channel *channel);
+        void eraseChannel(int fd);
+
         EventLoop *loop_;
-        ChannelMap channels_;
+        ChannelTable channels_;
+        size_t numChannels_;
+        int64_t updateRequests_;
+        int64_t updatesIssued_;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,270 @@
+#include "RingBuffer.hpp"
+#include "ByteScan.hpp"
+#include <algorithm>
+#include <cstring>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace net
+{
+    namespace
+    {
+        size_t roundToPages(size_t len)
+        {
+            static const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            return std::max(pageSize, (len + pageSize - 1) / pageSize * pageSize);
+        }
+
+        // 先占住 2 * capacity 的地址空间，再把同一个 memfd 固定映射到前后两半；失败返回 nullptr，errno 保留失败原因
+        char *mapMirrored(size_t capacity)
+        {
+            int fd = ::memfd_create("net-ring", MFD_CLOEXEC);
+            if (fd < 0)
+            {
+                return nullptr;
+            }
+            if (::ftruncate(fd, static_cast<off_t>(capacity)) != 0)
+            {
+                const int savedErrno = errno;
+                ::close(fd);
+                errno = savedErrno;
+                return nullptr;
+            }
+            void *region = ::mmap(nullptr, 2 * capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (region == MAP_FAILED)
+            {
+                const int savedErrno = errno;
+                ::close(fd);
+                errno = savedErrno;
+                return nullptr;
+            }
+            char *base = static_cast<char *>(region);
+            if (::mmap(base, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+                ::mmap(base + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+            {
+                const int savedErrno = errno;
+                ::munmap(region, 2 * capacity);
+                ::close(fd);
+                errno = savedErrno;
+                return nullptr;
+            }
+            ::close(fd); // 映射持有页面，fd 不再需要
+            return base;
+        }
+    }
+
+    char RingBuffer::emptyStorage_[1];
+
+    RingBuffer::RingBuffer(size_t capacity)
+        : base_(nullptr), capacity_(roundToPages(capacity)), readIndex_(0), writeIndex_(0)
+    {
+    }
+
+    RingBuffer::~RingBuffer()
+    {
+        if (base_)
+        {
+            ::munmap(base_, 2 * capacity_);
+        }
+    }
+
+    void RingBuffer::shrink()
+    {
+        if (base_ && readableBytes() == 0)
+        {
+            ::munmap(base_, 2 * capacity_);
+            base_ = nullptr;
+            readIndex_ = writeIndex_ = 0;
+        }
+    }
+
+    void RingBuffer::swap(RingBuffer &rhs)
+    {
+        std::swap(base_, rhs.base_);
+        std::swap(capacity_, rhs.capacity_);
+        std::swap(readIndex_, rhs.readIndex_);
+        std::swap(writeIndex_, rhs.writeIndex_);
+    }
+
+    const char *RingBuffer::findCRLF() const
+    {
+        return findCRLF(peek());
+    }
+    const char *RingBuffer::findCRLF(const char *start) const
+    {
+        const char *crlf = base::scan::findCRLF(start, beginWrite());
+        return crlf == beginWrite() ? nullptr : crlf;
+    }
+    const char *RingBuffer::findCRLFCRLF() const
+    {
+        return findCRLFCRLF(peek());
+    }
+    const char *RingBuffer::findCRLFCRLF(const char *start) const
+    {
+        const char *crlf = base::scan::findCRLFCRLF(start, beginWrite());
+        return crlf == beginWrite() ? nullptr : crlf;
+    }
+    const char *RingBuffer::findAnyOf(const char *set, size_t setSize) const
+    {
+        return findAnyOf(peek(), set, setSize);
+    }
+    const char *RingBuffer::findAnyOf(const char *start, const char *set, size_t setSize) const
+    {
+        const char *hit = base::scan::findAnyOf(start, beginWrite(), set, setSize);
+        return hit == beginWrite() ? nullptr : hit;
+    }
+    const char *RingBuffer::findByte(char c) const
+    {
+        return findByte(peek(), c);
+    }
+    const char *RingBuffer::findByte(const char *start, char c) const
+    {
+        const char *hit = base::scan::findByte(start, beginWrite(), c);
+        return hit == beginWrite() ? nullptr : hit;
+    }
+
+    void RingBuffer::retrieve(size_t len)
+    {
+        if (len < readableBytes())
+        {
+            readIndex_ += len;
+            if (readIndex_ >= capacity_)
+            {
+                // 读位置进入后一半映射，整体平移回前一半，数据不动
+                readIndex_ -= capacity_;
+                writeIndex_ -= capacity_;
+            }
+        }
+        else
+        {
+            retrieveAll();
+        }
+    }
+
+    void RingBuffer::retrieveUntil(const char *end)
+    {
+        retrieve(end - peek());
+    }
+
+    void RingBuffer::retrieveAll()
+    {
+        readIndex_ = writeIndex_ = 0;
+    }
+
+    std::string RingBuffer::retrieveAllAsString()
+    {
+        return retrieveAsString(readableBytes());
+    }
+
+    std::string RingBuffer::retrieveAsString(size_t len)
+    {
+        std::string str(peek(), len);
+        retrieve(len);
+        return str;
+    }
+
+    bool RingBuffer::append(const char *data, size_t len)
+    {
+        if (!ensureWritableBytes(len))
+        {
+            return false;
+        }
+        std::memcpy(beginWrite(), data, len);
+        writeIndex_ += len;
+        return true;
+    }
+
+    bool RingBuffer::ensureWritableBytes(size_t len)
+    {
+        if (!base_ && len > 0)
+        {
+            return remap(std::max(capacity_, len));
+        }
+        else if (writableBytes() < len)
+        {
+            return remap(std::max(2 * capacity_, readableBytes() + len));
+        }
+        return true;
+    }
+
+    bool RingBuffer::remap(size_t capacity)
+    {
+        capacity = roundToPages(capacity);
+        char *base = mapMirrored(capacity);
+        if (!base)
+        {
+            return false; // 原有映射和未读数据保持不变
+        }
+        const size_t readable = readableBytes();
+        if (base_)
+        {
+            std::memcpy(base, peek(), readable);
+            ::munmap(base_, 2 * capacity_);
+        }
+        base_ = base;
+        capacity_ = capacity;
+        readIndex_ = 0;
+        writeIndex_ = readable;
+        return true;
+    }
+
+    ssize_t RingBuffer::readFd(int fd, int *savedErrno)
+    {
+        char extrabuf[65536];
+        return readFd(fd, savedErrno, extrabuf, sizeof(extrabuf));
+    }
+
+    ssize_t RingBuffer::readFd(int fd, int *savedErrno, char *scratch, size_t scratchSize)
+    {
+        if (!base_ && !remap(capacity_))
+        {
+            *savedErrno = errno;
+            return -1;
+        }
+        // 剩余空间跨过环尾时在地址上也是连续的，不用拆成两段
+        struct iovec vec[2];
+        const size_t writable = writableBytes();
+        vec[0].iov_base = beginWrite();
+        vec[0].iov_len = writable;
+        vec[1].iov_base = scratch;
+        vec[1].iov_len = scratchSize;
+
+        const int iovcnt = writable < scratchSize ? 2 : 1;
+        const ssize_t n = ::readv(fd, vec, iovcnt);
+        if (n < 0)
+        {
+            *savedErrno = errno;
+        }
+        else if (static_cast<size_t>(n) <= writable)
+        {
+            writeIndex_ += n;
+        }
+        else
+        {
+            writeIndex_ += writable;
+            if (!append(scratch, n - writable))
+            {
+                // 已经从 socket 取走的数据放不下，只能按错误上报
+                *savedErrno = errno;
+                return -1;
+            }
+        }
+        return n;
+    }
+
+    ssize_t RingBuffer::writeFd(int fd, int *savedErrno)
+    {
+        const ssize_t n = ::write(fd, peek(), readableBytes());
+        if (n < 0)
+        {
+            *savedErrno = errno;
+        }
+        else
+        {
+            retrieve(static_cast<size_t>(n));
+        }
+        return n;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <string>
+#include <sys/types.h>
+
+namespace net
+{
+    // 与 Buffer 读写接口相同的环形缓冲区：同一段 memfd 页面在虚拟地址上背靠背映射两次，
+    // 可读数据跨过环尾时在地址上仍然连续，取出数据只移动下标，不需要像 Buffer 那样搬移未读数据。
+    // 适合长时间高速率的流式输入（如 RTSP 交织的 RTP），容量按页对齐，存储在第一次写入时才映射
+    class RingBuffer
+    {
+    public:
+        static const size_t kDefaultCapacity = 64 * 1024;
+
+        explicit RingBuffer(size_t capacity = kDefaultCapacity);
+        ~RingBuffer();
+        RingBuffer(const RingBuffer &) = delete;
+        RingBuffer &operator=(const RingBuffer &) = delete;
+
+        size_t readableBytes() const { return writeIndex_ - readIndex_; }
+        size_t writableBytes() const { return base_ ? capacity_ - readableBytes() : 0; }
+        // 已映射的容量，未映射时为 0
+        size_t capacity() const { return base_ ? capacity_ : 0; }
+        // 没有未读数据时解除映射，下一次写入再映射
+        void shrink();
+        void swap(RingBuffer &rhs);
+
+        const char *peek() const { return begin() + readIndex_; }
+
+        char *beginWrite() { return begin() + writeIndex_; }
+        const char *beginWrite() const { return begin() + writeIndex_; }
+
+        const char *findCRLF() const;
+        const char *findCRLF(const char *start) const;
+        const char *findCRLFCRLF() const;
+        const char *findCRLFCRLF(const char *start) const;
+        const char *findAnyOf(const char *set, size_t setSize) const;
+        const char *findAnyOf(const char *start, const char *set, size_t setSize) const;
+        const char *findByte(char c) const;
+        const char *findByte(const char *start, char c) const;
+
+        void retrieve(size_t len);
+        void retrieveUntil(const char *delim);
+        void retrieveAll();
+        std::string retrieveAllAsString();
+        std::string retrieveAsString(size_t len);
+
+        // 扩容时映射失败返回 false，errno 为失败原因，已有数据不变
+        bool append(const char *data, size_t len);
+        bool append(const std::string &data)
+        {
+            return append(data.data(), data.size());
+        }
+        bool append(const void *data, size_t len)
+        {
+            return append(static_cast<const char *>(data), len);
+        }
+
+        ssize_t readFd(int fd, int *savedErrno);
+        // 先读进剩余空间，放不下的部分落到调用方提供的 scratch 再追加（会扩容）；
+        // 映射失败与读失败一样返回 -1 并设置 *savedErrno
+        ssize_t readFd(int fd, int *savedErrno, char *scratch, size_t scratchSize);
+        ssize_t writeFd(int fd, int *savedErrno);
+
+    private:
+        // 未映射时指向静态的空区间
+        const char *begin() const { return base_ ? base_ : emptyStorage_; }
+        char *begin() { return base_ ? base_ : emptyStorage_; }
+        bool ensureWritableBytes(size_t len);
+        // 映射至少 capacity 字节的新环并把未读数据拷过去，失败时保持原状
+        bool remap(size_t capacity);
+
+        static char emptyStorage_[1];
+
+        char *base_;
+        size_t capacity_;
+        // readIndex_ 保持在 [0, capacity_)，writeIndex_ 不超过 readIndex_ + capacity_
+        size_t readIndex_;
+        size_t writeIndex_;
+    };
+}
@@ -0,0 +1,77 @@
+#include "SharedSlice.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace net
+{
+    SharedSlice::SharedSlice(const void *data, size_t len)
+        : storage_(nullptr), offset_(0), size_(len)
+    {
+        if (len == 0)
+        {
+            return;
+        }
+        void *memory = ::operator new(sizeof(Storage) + len);
+        storage_ = new (memory) Storage;
+        storage_->refs.store(1, std::memory_order_relaxed);
+        std::memcpy(storage_->bytes(), data, len);
+    }
+
+    SharedSlice::SharedSlice(const SharedSlice &other)
+        : storage_(other.storage_), offset_(other.offset_), size_(other.size_)
+    {
+        if (storage_)
+        {
+            storage_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    SharedSlice::SharedSlice(SharedSlice &&other) noexcept
+        : storage_(other.storage_), offset_(other.offset_), size_(other.size_)
+    {
+        other.storage_ = nullptr;
+        other.offset_ = 0;
+        other.size_ = 0;
+    }
+
+    SharedSlice &SharedSlice::operator=(SharedSlice other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    SharedSlice::~SharedSlice()
+    {
+        if (storage_ && storage_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            storage_->~Storage();
+            ::operator delete(storage_);
+        }
+    }
+
+    const char *SharedSlice::data() const
+    {
+        return storage_ ? storage_->bytes() + offset_ : nullptr;
+    }
+
+    SharedSlice SharedSlice::slice(size_t offset, size_t len) const
+    {
+        SharedSlice sub(*this);
+        sub.offset_ = offset_ + std::min(offset, size_);
+        sub.size_ = std::min(len, size_ - std::min(offset, size_));
+        return sub;
+    }
+
+    long SharedSlice::useCount() const
+    {
+        return storage_ ? storage_->refs.load(std::memory_order_relaxed) : 0;
+    }
+
+    void SharedSlice::swap(SharedSlice &other) noexcept
+    {
+        std::swap(storage_, other.storage_);
+        std::swap(offset_, other.offset_);
+        std::swap(size_, other.size_);
+    }
+}
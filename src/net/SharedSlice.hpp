@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace net
+{
+    // 不可变的引用计数字节块：计数和数据在同一次分配中，复制只增加计数。
+    // 同一个 RTP 包发给多个订阅者时，各连接的发送缓冲区只记录引用，writev 直接从这块内存读，
+    // 最后一个连接写完时释放。可以跨线程传递
+    class SharedSlice
+    {
+    public:
+        SharedSlice() : storage_(nullptr), offset_(0), size_(0) {}
+        // 拷贝一次数据，之后共享
+        SharedSlice(const void *data, size_t len);
+        explicit SharedSlice(const std::string &data) : SharedSlice(data.data(), data.size()) {}
+
+        SharedSlice(const SharedSlice &other);
+        SharedSlice(SharedSlice &&other) noexcept;
+        SharedSlice &operator=(SharedSlice other) noexcept;
+        ~SharedSlice();
+
+        const char *data() const;
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        // 共享同一块内存的子区间
+        SharedSlice slice(size_t offset, size_t len) const;
+
+        // 当前引用数，只用于测试和统计
+        long useCount() const;
+
+        void swap(SharedSlice &other) noexcept;
+
+    private:
+        struct Storage
+        {
+            std::atomic<long> refs;
+            long padding; // 让数据按 16 字节对齐
+            // 数据紧跟在结构体后面
+            char *bytes() { return reinterpret_cast<char *>(this + 1); }
+        };
+
+        Storage *storage_;
+        size_t offset_;
+        size_t size_;
+    };
+}
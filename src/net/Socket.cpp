@@ -1,15 +1,18 @@
 #include "Socket.hpp"
 #include "Logger.hpp"
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 #include <unistd.h>
 #include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <linux/filter.h>
 namespace net
 {
     Socket::Socket()
     {
-        sockfd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockfd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
         if (sockfd_ == -1)
             throw std::runtime_error("Socket creation failed");
     }
@@ -35,9 +38,9 @@ namespace net
     {
         sockaddr_in addr;
         socklen_t len = sizeof(addr);
-        int connfd = ::accept(sockfd_, (sockaddr *)&addr, &len);
+        int connfd = ::accept4(sockfd_, (sockaddr *)&addr, &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
         if (connfd == -1)
-            throw std::runtime_error("Accept failed");
+            return -1;
         peeraddr->setSockAddr((const sockaddr *)&addr, len);
         return connfd;
     }
@@ -68,6 +71,28 @@ namespace net
             throw std::runtime_error("Setsockopt failed");
     }
 
+    void Socket::setReusePortCpuSteering(const std::vector<int> &cpus)
+    {
+        std::vector<sock_filter> code;
+        code.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU))); // A = 当前 CPU
+        for (size_t i = 0; i < cpus.size(); ++i)
+        {
+            if (cpus[i] >= 0)
+            {
+                code.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, static_cast<uint32_t>(cpus[i]), 0, 1));
+                code.push_back(BPF_STMT(BPF_RET | BPF_K, static_cast<uint32_t>(i)));
+            }
+        }
+        code.push_back(BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, static_cast<uint32_t>(std::max<size_t>(cpus.size(), 1))));
+        code.push_back(BPF_STMT(BPF_RET | BPF_A, 0));
+
+        sock_fprog prog;
+        prog.len = static_cast<unsigned short>(code.size());
+        prog.filter = code.data();
+        if (::setsockopt(sockfd_, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) == -1)
+            throw std::runtime_error("Setsockopt failed");
+    }
+
     void Socket::setKeepAlive(bool on)
     {
         int optval = on ? 1 : 0;
@@ -78,6 +103,7 @@ namespace net
     InetAddress Socket::getPeerAddr(int sockfd)
     {
         sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr)); // 对端已断开时 getpeername 失败，返回全零地址
         socklen_t len = sizeof(addr);
         if (getpeername(sockfd, (sockaddr *)&addr, &len) == -1)
         {
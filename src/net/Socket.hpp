@@ -1,6 +1,7 @@
 #pragma once
 #include "InetAddress.hpp"
 #include "Noncopyable.hpp"
+#include <vector>
 namespace net
 {
     class InetAddress;
@@ -21,6 +22,8 @@ namespace net
 
         void listen();
 
+        // 监听 socket 为非阻塞；返回的连接同样是非阻塞、close-on-exec 的。
+        // 失败返回 -1 并保留 errno（EAGAIN、EMFILE 等由调用方处理），不抛异常
         int accept(InetAddress *peeraddr);
 
         void shutdownWrite();
@@ -31,6 +34,10 @@ namespace net
 
         void setReusePort(bool on);
 
+        // 给 SO_REUSEPORT 组挂 CBPF 程序：收包 CPU 等于 cpus[i] 的连接交给组内第 i 个监听 socket，
+        // 未列出的 CPU 按 cpu % 组大小分配
+        void setReusePortCpuSteering(const std::vector<int> &cpus);
+
         void setKeepAlive(bool on);
 
         static InetAddress getLocalAddr(int sockfd);
@@ -28,7 +28,7 @@ namespace net
         bool unique = false;
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            unique = connection_.unique();
+            unique = connection_.use_count() == 2; // 除 connection_ 外只剩连接自身的 self()
             conn = connection_;
         }
 
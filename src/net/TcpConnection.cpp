@@ -1,7 +1,11 @@
 #include "TcpConnection.hpp"
 #include "Logger.hpp"
+#include "ConnectionRegistry.hpp"
 #include <errno.h>
 #include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <fcntl.h>
 #include <functional>
 #include <assert.h>
 
@@ -10,22 +14,34 @@ namespace net
     TcpConnection::TcpConnection(EventLoop *loop, const std::string &name, int sockfd,
                                  const InetAddress &localAddr, const InetAddress &peerAddr) : loop_(loop),                                                                                      // 1. 匹配声明顺序
                                                                                               name_(name),                                                                                      // 2.
+                                                                                              id_(0),
                                                                                               state_(kConnecting),                                                                              // 3.
                                                                                               sockfd_(sockfd),                                                                                  // 4.
-                                                                                              channel_(new Channel(loop, sockfd)),                                                              // 5.
+                                                                                              channel_(loop, sockfd),                                                                            // 5.
                                                                                               localAddr_(localAddr),                                                                            // 6.
                                                                                               peerAddr_(peerAddr),                                                                              // 7.
-                                                                                              connectionCallback_(std::bind(&TcpConnection::defaultConnectionCallback, std::placeholders::_1)), // 8.
+                                                                                              connectionCallback_(&TcpConnection::defaultConnectionCallback),                                   // 8.
                                                                                               messageCallback_(),                                                                               // 9.（若未初始化可留空，或按实际需求赋值）
                                                                                               writeCompleteCallback_(),                                                                         // 10.
-                                                                                              closeCallback_(std::bind(&TcpConnection::defaultCloseCallback, std::placeholders::_1)),           // 11.
+                                                                                              closeCallback_(&TcpConnection::defaultCloseCallback),                                             // 11.
                                                                                               highWaterMarkCallback_(),                                                                         // 12.
-                                                                                              HighWaterMark_(10 * 1024 * 1024)                                                                  // 13.
+                                                                                              HighWaterMark_(10 * 1024 * 1024),                                                                 // 13.
+                                                                                              edgeTriggered_(false),                                                                            // 14.
+                                                                                              ioBudget_(kDefaultIoBudget),                                                                      // 15.
+                                                                                              readResumePending_(false),                                                                        // 16.
+                                                                                              readSinceSweep_(false),
+                                                                                              writeResumePending_(false),                                                                       // 17.
+                                                                                              batchWrites_(false),
+                                                                                              flushPending_(false),
+                                                                                              batchFlags_(0),
+                                                                                              flushRequested_(false),
+                                                                                              outputBuffer_(&loop->bufferPool())
     {
-        channel_->setReadCallback(std::bind(&TcpConnection::handleRead, this, std::placeholders::_1));
-        channel_->setWriteCallback(std::bind(&TcpConnection::handleWrite, this));
-        channel_->setCloseCallback(std::bind(&TcpConnection::handleClose, this));
-        channel_->setErrorCallback(std::bind(&TcpConnection::handleError, this));
+        channel_.setReadCallback(std::bind(&TcpConnection::handleRead, this, std::placeholders::_1));
+        channel_.setWriteCallback(std::bind(&TcpConnection::handleWrite, this, 0));
+        channel_.setCloseCallback(std::bind(&TcpConnection::handleClose, this));
+        channel_.setErrorCallback(std::bind(&TcpConnection::handleError, this));
+        loop_->load().connectionOpened(); // 在挑选 loop 的线程里立即计入，连续 accept 时也能看到
         LOG_DEBUG("TcpConnection::ctor[%s] at %p fd=%d",
                   name_.c_str(), this, sockfd_);
     }
@@ -36,9 +52,30 @@ namespace net
                   name_.c_str(), this, sockfd_, static_cast<int>(state_.load()));
         assert(state_ == kDisconnected);
         //        loop_->removeChannel(channel_.get());
+        loop_->load().connectionClosed();
         close(sockfd_);
     }
 
+    const std::string &TcpConnection::getName() const
+    {
+        std::call_once(nameOnce_, [this]()
+                       {
+                           if (name_.empty() && namePrefix_)
+                           {
+                               char buf[48];
+                               snprintf(buf, sizeof buf, "#%u.%u.%u", ConnectionRegistry::loopOf(id_),
+                                        ConnectionRegistry::slotOf(id_), ConnectionRegistry::generationOf(id_));
+                               name_ = *namePrefix_ + buf;
+                           } });
+        return name_;
+    }
+
+    void TcpConnection::setId(ConnectionId id, std::shared_ptr<const std::string> namePrefix)
+    {
+        id_ = id;
+        namePrefix_ = std::move(namePrefix);
+    }
+
     void TcpConnection::send(const std::string &message)
     {
         if (state_.load() == kConnected)
@@ -49,27 +86,48 @@ namespace net
             }
             else
             {
-                loop_->runInLoop(
-                    std::bind(static_cast<void (TcpConnection::*)(const std::string &)>(&TcpConnection::sendInLoop),
-                              this,
-                              message));
+                loop_->runInLoop([conn = shared_from_this(), message]()
+                                 { conn->sendInLoop(message); });
+            }
+        }
+    }
+
+    void TcpConnection::send(std::string &&message)
+    {
+        if (state_.load() == kConnected)
+        {
+            if (loop_->isInLoopThread())
+            {
+                sendInLoop(message);
+            }
+            else
+            {
+                loop_->runInLoop([conn = shared_from_this(), message = std::move(message)]()
+                                 { conn->sendInLoop(message); });
             }
         }
     }
 
     void TcpConnection::send(Buffer *buf)
+    {
+        send(std::move(*buf));
+    }
+
+    void TcpConnection::send(Buffer &&buf)
     {
         if (state_.load() == kConnected)
         {
             if (loop_->isInLoopThread())
             {
-                sendInLoop(buf->retrieveAllAsString());
+                sendInLoop(&buf);
             }
             else
             {
-                loop_->runInLoop(std::bind(static_cast<void (TcpConnection::*)(const std::string &)>(&TcpConnection::sendInLoop),
-                                           this,
-                                           buf->retrieveAllAsString()));
+                // 交换到局部对象再移入任务，buf 保留自己的初始容量设置
+                Buffer message;
+                message.swap(buf);
+                loop_->runInLoop([conn = shared_from_this(), message = std::move(message)]() mutable
+                                 { conn->sendInLoop(&message); });
             }
         }
     }
@@ -84,10 +142,40 @@ namespace net
             }
             else
             {
-                loop_->runInLoop(
-                    std::bind(static_cast<void (TcpConnection::*)(const std::string &)>(&TcpConnection::sendInLoop),
-                              this,
-                              std::string(static_cast<const char *>(data), len)));
+                loop_->runInLoop([conn = shared_from_this(), message = std::string(static_cast<const char *>(data), len)]()
+                                 { conn->sendInLoop(message); });
+            }
+        }
+    }
+
+    void TcpConnection::send(SharedSlice slice)
+    {
+        if (state_.load() == kConnected)
+        {
+            if (loop_->isInLoopThread())
+            {
+                sendInLoop(slice);
+            }
+            else
+            {
+                loop_->runInLoop([conn = shared_from_this(), slice = std::move(slice)]()
+                                 { conn->sendInLoop(slice); });
+            }
+        }
+    }
+
+    void TcpConnection::sendFile(int fd, off_t offset, size_t len)
+    {
+        if (state_.load() == kConnected)
+        {
+            if (loop_->isInLoopThread())
+            {
+                sendFileInLoop(fd, offset, len);
+            }
+            else
+            {
+                loop_->runInLoop([conn = shared_from_this(), fd, offset, len]()
+                                 { conn->sendFileInLoop(fd, offset, len); });
             }
         }
     }
@@ -102,7 +190,35 @@ namespace net
         sendInLoop(buf->peek(), buf->readableBytes());
         buf->retrieveAll();
     }
+    void TcpConnection::sendInLoop(const SharedSlice &slice)
+    {
+        if (!outputBuffer_.zeroCopyEligible(slice.size()))
+        {
+            sendInLoop(slice.data(), slice.size(), &slice);
+            return;
+        }
+        // 零拷贝段不直接 write，统一由发送缓冲区用 MSG_ZEROCOPY 发出并保留引用
+        loop_->assertInLoopThread();
+        if (state_.load() == kDisconnected)
+        {
+            LOG_WARN("disconnected, give up writing");
+            return;
+        }
+        if (outputBuffer_.pinnedCount() > 0)
+        {
+            int errors = 0;
+            reapZeroCopy(&errors); // io_uring 下不写时没有 poll 在等 POLLERR，顺便回收
+        }
+        outputBuffer_.append(slice);
+        writeQueued();
+    }
+
     void TcpConnection::sendInLoop(const void *data, size_t len)
+    {
+        sendInLoop(data, len, nullptr);
+    }
+
+    void TcpConnection::sendInLoop(const void *data, size_t len, const SharedSlice *shared)
     {
         loop_->assertInLoopThread();
         ssize_t nwrote = 0;
@@ -115,16 +231,17 @@ namespace net
             return;
         }
 
-        if (!channel_->isWriting() && outputBuffer_.readableBytes() == 0)
+        if (!batchWrites_ && !channel_.isWriting() && outputBuffer_.readableBytes() == 0 && !pollerSends())
         {
             nwrote = ::write(sockfd_, data, len);
             if (nwrote >= 0)
             {
+                loop_->load().addBytes(nwrote);
                 remaining = len - nwrote;
                 if (remaining == 0 && writeCompleteCallback_)
                 {
-                    loop_->queueInLoop(
-                        std::bind(writeCompleteCallback_, shared_from_this()));
+                    loop_->queueInLoop([conn = shared_from_this()]()
+                                       { conn->writeCompleteCallback_(conn); });
                 }
             }
             else
@@ -148,49 +265,256 @@ namespace net
             {
                 if (highWaterMarkCallback_)
                 {
-                    loop_->queueInLoop(
-                        std::bind(highWaterMarkCallback_,
-                                  shared_from_this(),
-                                  oldLen + remaining));
+                    loop_->queueInLoop([conn = shared_from_this(), size = oldLen + remaining]()
+                                       { conn->highWaterMarkCallback_(conn, size); });
                 }
             }
-            outputBuffer_.append(static_cast<const char *>(data) + nwrote, remaining);
-            if (!channel_->isWriting())
+            if (shared)
             {
-                channel_->enableWriting();
+                outputBuffer_.append(shared->slice(static_cast<size_t>(nwrote), remaining));
+            }
+            else
+            {
+                outputBuffer_.append(static_cast<const char *>(data) + nwrote, remaining);
+            }
+            if (batchWrites_)
+            {
+                scheduleFlush();
+            }
+            else if (!channel_.isWriting())
+            {
+                channel_.enableWriting();
             }
         }
     }
 
+    void TcpConnection::sendFileInLoop(int fd, off_t offset, size_t len)
+    {
+        loop_->assertInLoopThread();
+        if (state_.load() == kDisconnected)
+        {
+            LOG_WARN("disconnected, give up writing");
+            return;
+        }
+
+        outputBuffer_.appendFile(fd, offset, len);
+        writeQueued();
+    }
+
+    void TcpConnection::writeQueued()
+    {
+        if (batchWrites_)
+        {
+            scheduleFlush();
+        }
+        else if (!channel_.isWriting())
+        {
+            channel_.enableWriting();
+            if (!pollerSends())
+            {
+                handleWrite(); // 前面没有排队数据，和 sendInLoop 一样立即尝试发送
+            }
+        }
+        const size_t queued = outputBuffer_.readableBytes();
+        if (queued >= HighWaterMark_ && highWaterMarkCallback_)
+        {
+            loop_->queueInLoop([conn = shared_from_this(), queued]()
+                               { conn->highWaterMarkCallback_(conn, queued); });
+        }
+    }
+
+    void TcpConnection::scheduleFlush()
+    {
+        // 已在等可写事件时由 handleWrite 发送
+        if (!flushPending_ && !channel_.isWriting())
+        {
+            flushPending_ = true;
+            loop_->runAtIterationEnd([conn = shared_from_this()]()
+                                     {
+                                         conn->flushPending_ = false;
+                                         conn->flushInLoop(conn->batchFlags_); });
+        }
+    }
+
+    void TcpConnection::flushInLoop(int flags)
+    {
+        loop_->assertInLoopThread();
+        if (state_.load() == kDisconnected || outputBuffer_.readableBytes() == 0)
+        {
+            return;
+        }
+        if (pollerSends())
+        {
+            // poller 在本轮结束后的 poll 中提交，和其他连接的发送合并为一次 io_uring_enter
+            flushRequested_ = flushRequested_ || flags == 0;
+            if (!channel_.isWriting())
+            {
+                channel_.enableWriting();
+            }
+            return;
+        }
+        if (!channel_.isWriting())
+        {
+            channel_.enableWriting();
+            handleWrite(flags);
+        }
+    }
+
+    bool TcpConnection::pollerSends() const
+    {
+        // 边沿触发按预算循环写，仍走同步路径
+        return !edgeTriggered_ && loop_->completedWriteEnabled();
+    }
+
+    int TcpConnection::prepareCompletedWrite(struct iovec *vec, int maxIov, int *flags)
+    {
+        if (edgeTriggered_)
+        {
+            return 0;
+        }
+        const int iovcnt = outputBuffer_.peekIovecs(vec, maxIov);
+        if (iovcnt > 0)
+        {
+            *flags = batchWrites_ && !flushRequested_ ? batchFlags_ : 0;
+            flushRequested_ = false;
+        }
+        return iovcnt;
+    }
+
+    void TcpConnection::flush()
+    {
+        loop_->runInLoop([conn = shared_from_this()]()
+                         { conn->flushInLoop(0); });
+    }
+
+    void TcpConnection::setWriteBatching(bool on, bool moreHint)
+    {
+        loop_->assertInLoopThread();
+        batchWrites_ = on;
+        batchFlags_ = on && moreHint ? MSG_MORE : 0;
+        if (!on)
+        {
+            flushInLoop(0); // 关闭时把已排队的数据立即写出
+        }
+    }
+
     void TcpConnection::shutdown()
     {
         if (state_.load() == kConnected)
         {
             setState(kDisconnecting);
-            loop_->runInLoop(std::bind(&TcpConnection::shutdownInLoop, this));
+            loop_->runInLoop([conn = shared_from_this()]()
+                             { conn->shutdownInLoop(); });
         }
     }
 
     void TcpConnection::shutdownInLoop()
     {
         loop_->assertInLoopThread();
-        if (!channel_->isWriting())
+        if (!channel_.isWriting())
         {
-            ::shutdown(sockfd_, SHUT_WR);
+            if (outputBuffer_.readableBytes() > 0)
+            {
+                // 批量写还有本轮未发出的数据，写完后 handleWrite 再关闭写端
+                flushInLoop(0);
+            }
+            else
+            {
+                ::shutdown(sockfd_, SHUT_WR);
+            }
         }
     }
 
     void TcpConnection::setTcpNoDelay(bool on)
     {
-        ::setsockopt(sockfd_, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        int optval = on ? 1 : 0; // 内核要求 int 大小的选项值，传 bool 会返回 EINVAL
+        ::setsockopt(sockfd_, IPPROTO_TCP, TCP_NODELAY, &optval, sizeof(optval));
+    }
+
+    bool TcpConnection::setZeroCopy(size_t minBytes)
+    {
+        loop_->assertInLoopThread();
+        if (minBytes > 0)
+        {
+            int on = 1;
+            if (::setsockopt(sockfd_, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) < 0)
+            {
+                LOG_WARN("SO_ZEROCOPY unsupported, keep copying sends");
+                return false;
+            }
+        }
+        outputBuffer_.setZeroCopyThreshold(minBytes);
+        return true;
+    }
+
+    void TcpConnection::setRingInput(RingMessageCallback cb, size_t capacity)
+    {
+        loop_->assertInLoopThread();
+        ringMessageCallback_ = std::move(cb);
+        if (!ringInput_)
+        {
+            ringInput_.reset(new RingBuffer(capacity));
+            if (inputBuffer_.readableBytes() > 0 && !ringInput_->append(inputBuffer_.peek(), inputBuffer_.readableBytes()))
+            {
+                // 已收到的数据搬不过去，连接上的字节流断了，只能关闭
+                LOG_ERROR("TcpConnection::setRingInput [%s] - map failed, errno = %d", getName().c_str(), errno);
+                forceCloseInLoop();
+            }
+            Buffer().swap(inputBuffer_);
+        }
+    }
+
+    bool TcpConnection::reapZeroCopy(int *errors)
+    {
+        size_t sent = 0;
+        size_t copied = 0;
+        int queueErrors = 0;
+        int lastErrno = 0;
+        const int notifications = outputBuffer_.reapZeroCopy(sockfd_, &sent, &copied, &queueErrors, &lastErrno);
+        if (queueErrors > 0)
+        {
+            LOG_ERROR("TcpConnection::reapZeroCopy [%s] - %d error queue entries, last errno = %d",
+                      getName().c_str(), queueErrors, lastErrno);
+            *errors += queueErrors;
+        }
+        if (notifications == 0)
+        {
+            return false;
+        }
+        loop_->load().addZeroCopy(static_cast<int64_t>(sent), static_cast<int64_t>(copied));
+        if (copied > 0 && copied == sent && outputBuffer_.zeroCopyEligible(static_cast<size_t>(-1)))
+        {
+            // 内核全部退回拷贝（回环、网卡不支持分散聚集等），继续零拷贝只会多出通知开销
+            LOG_DEBUG("zero-copy sends were copied by the kernel, fall back to copying");
+            outputBuffer_.setZeroCopyThreshold(0);
+        }
+        return true;
+    }
+
+    void TcpConnection::setEdgeTriggered(bool on, size_t budget)
+    {
+        edgeTriggered_ = on;
+        ioBudget_ = budget;
+        if (on)
+        {
+            int flags = ::fcntl(sockfd_, F_GETFL, 0);
+            ::fcntl(sockfd_, F_SETFL, flags | O_NONBLOCK);
+        }
+        channel_.setEdgeTriggered(on);
     }
 
     void TcpConnection::connectEstablished()
     {
         loop_->assertInLoopThread();
         setState(kConnected);
-        channel_->enableReading();
-        connectionCallback_(shared_from_this());
+        self_ = shared_from_this();
+        channel_.setCompletedReadEnabled(true); // io_uring 下由内核直接把数据收进缓冲区环
+        // io_uring 下发送缓冲区的数据由 poller 直接提交 sendmsg，完成前留在缓冲区里
+        channel_.setCompletedWriteSource([this](struct iovec *vec, int maxIov, int *flags)
+                                         { return prepareCompletedWrite(vec, maxIov, flags); },
+                                         self_);
+        channel_.enableReading();
+        connectionCallback_(self_);
     }
 
     void TcpConnection::connectDestroyed()
@@ -199,20 +523,32 @@ namespace net
         if (state_.load() == kConnected)
         {
             setState(kDisconnected);
-            channel_->disableAll();
+            channel_.disableAll();
             connectionCallback_(shared_from_this());
         }
-        channel_->remove();
+        channel_.remove();
+        self_.reset(); // 调用方（排队的回调）仍持有引用
     }
 
     void TcpConnection::handleRead(Timestamp receiveTime)
     {
         loop_->assertInLoopThread();
+        if (channel_.hasCompletedRead())
+        {
+            handleCompletedRead(receiveTime);
+            return;
+        }
+        if (edgeTriggered_)
+        {
+            handleReadEdgeTriggered(receiveTime);
+            return;
+        }
         int savedErrno = 0;
-        ssize_t n = inputBuffer_.readFd(sockfd_, &savedErrno);
+        ssize_t n = readInput(&savedErrno);
         if (n > 0)
         {
-            messageCallback_(shared_from_this(), &inputBuffer_, receiveTime);
+            loop_->load().addBytes(n);
+            deliverInput(self_, receiveTime);
         }
         else if (n == 0)
         {
@@ -220,44 +556,239 @@ namespace net
         }
         else
         {
-            errno = savedErrno;
-            LOG_ERROR("TcpConnection::handleRead");
-            handleError();
+            handleReadError(savedErrno);
         }
     }
 
-    void TcpConnection::handleWrite()
+    void TcpConnection::handleReadError(int savedErrno)
+    {
+        errno = savedErrno;
+        LOG_ERROR("TcpConnection::handleRead");
+        handleError();
+        if (savedErrno != EAGAIN && savedErrno != EWOULDBLOCK && savedErrno != EINTR)
+        {
+            // 硬错误（含接收缓冲区扩容失败）下一轮只会重复失败，只关掉这一条连接
+            forceCloseInLoop();
+        }
+    }
+
+    ssize_t TcpConnection::readInput(int *savedErrno)
+    {
+        ssize_t n;
+        if (ringInput_)
+        {
+            n = ringInput_->readFd(sockfd_, savedErrno, loop_->readScratch(), EventLoop::kReadScratchSize);
+        }
+        else
+        {
+            prepareInput();
+            n = inputBuffer_.readFd(sockfd_, savedErrno, loop_->readScratch(), EventLoop::kReadScratchSize);
+        }
+        if (n > 0)
+        {
+            inputReceived();
+        }
+        return n;
+    }
+
+    void TcpConnection::prepareInput()
+    {
+        if (inputBuffer_.capacity() == 0)
+        {
+            inputBuffer_.setInitialSize(loop_->receiveBufferHint());
+        }
+    }
+
+    void TcpConnection::inputReceived()
+    {
+        readSinceSweep_ = true;
+        loop_->recordReceived(inputBytes());
+    }
+
+    size_t TcpConnection::inputBytes() const
+    {
+        return ringInput_ ? ringInput_->readableBytes() : inputBuffer_.readableBytes();
+    }
+
+    void TcpConnection::deliverInput(const TcpConnectionPtr &conn, Timestamp receiveTime)
+    {
+        if (ringInput_)
+        {
+            ringMessageCallback_(conn, ringInput_.get(), receiveTime);
+        }
+        else
+        {
+            messageCallback_(conn, &inputBuffer_, receiveTime);
+        }
+    }
+
+    void TcpConnection::releaseIdleBuffers()
     {
         loop_->assertInLoopThread();
-        if (channel_->isWriting())
+        if (!readSinceSweep_)
+        {
+            if (ringInput_)
+            {
+                ringInput_->shrink();
+            }
+            else if (inputBuffer_.capacity() > 0)
+            {
+                inputBuffer_.shrink();
+            }
+        }
+        readSinceSweep_ = false;
+        if (outputBuffer_.readableBytes() == 0)
+        {
+            outputBuffer_.shrink();
+        }
+    }
+
+    void TcpConnection::handleCompletedRead(Timestamp receiveTime)
+    {
+        // poller 已经收好数据，缓冲区只在本次回调内有效，先拷进 inputBuffer_
+        const TcpConnectionPtr &guardThis = self_; // 关闭时 connectDestroyed 排在本轮之后，回调期间一直有效
+        size_t total = 0;
+        prepareInput();
+        for (const Channel::ReadChunk &chunk : channel_.completedReadChunks())
+        {
+            if (ringInput_)
+            {
+                if (!ringInput_->append(chunk.data, chunk.len))
+                {
+                    handleReadError(errno);
+                    return;
+                }
+            }
+            else
+            {
+                inputBuffer_.append(chunk.data, chunk.len);
+            }
+            total += chunk.len;
+        }
+        if (total > 0)
+        {
+            inputReceived();
+            loop_->load().addBytes(static_cast<int64_t>(total));
+            deliverInput(guardThis, receiveTime);
+        }
+        const int status = channel_.completedReadStatus();
+        if (status <= 0 && (state_.load() == kConnected || state_.load() == kDisconnecting))
+        {
+            if (status == 0)
+            {
+                handleClose();
+            }
+            else
+            {
+                handleReadError(-status);
+            }
+        }
+    }
+
+    void TcpConnection::handleReadEdgeTriggered(Timestamp receiveTime)
+    {
+        const TcpConnectionPtr &guardThis = self_;
+        size_t total = 0;
+        while (total < ioBudget_)
         {
-            ssize_t n = ::write(sockfd_,
-                                outputBuffer_.peek(),
-                                outputBuffer_.readableBytes());
+            int savedErrno = 0;
+            ssize_t n = readInput(&savedErrno);
             if (n > 0)
             {
-                outputBuffer_.retrieve(n);
-                if (outputBuffer_.readableBytes() == 0)
+                total += static_cast<size_t>(n);
+                loop_->load().addBytes(n);
+                deliverInput(guardThis, receiveTime);
+                if (!channel_.isReading())
                 {
-                    channel_->disableWriting();
-                    if (writeCompleteCallback_)
+                    return; // 回调中连接已关闭
+                }
+            }
+            else if (n == 0)
+            {
+                handleClose();
+                return;
+            }
+            else if (savedErrno == EAGAIN || savedErrno == EWOULDBLOCK)
+            {
+                return; // 已读空，等下一个边沿
+            }
+            else if (savedErrno != EINTR)
+            {
+                handleReadError(savedErrno);
+                return;
+            }
+        }
+        // 预算用完时 socket 里可能还有数据，边沿不会再来，排队继续读
+        if (!readResumePending_)
+        {
+            readResumePending_ = true;
+            loop_->queueInLoop([guardThis]()
+                               {
+                                   guardThis->readResumePending_ = false;
+                                   if (guardThis->channel_.isReading())
+                                   {
+                                       guardThis->handleReadEdgeTriggered(guardThis->loop_->pollReturnTime());
+                                   } });
+        }
+    }
+
+    void TcpConnection::handleWrite(int flags)
+    {
+        loop_->assertInLoopThread();
+        if (channel_.hasCompletedWrite())
+        {
+            handleCompletedWrite();
+            return;
+        }
+        if (channel_.isWriting())
+        {
+            // 水平触发每次事件写一次；边沿触发写到内核缓冲区满或预算用完
+            size_t total = 0;
+            do
+            {
+                const size_t readable = outputBuffer_.readableBytes();
+                const size_t request = edgeTriggered_ ? std::min(readable, ioBudget_ - total) : readable;
+                int savedErrno = 0;
+                size_t offered = 0;
+                ssize_t n = outputBuffer_.writeFd(sockfd_, &savedErrno, request, &offered, flags);
+                if (n <= 0)
+                {
+                    if (n < 0 && (savedErrno == EAGAIN || savedErrno == EWOULDBLOCK))
                     {
-                        loop_->queueInLoop(
-                            std::bind(writeCompleteCallback_, shared_from_this()));
+                        return;
                     }
-                    if (state_.load() == kDisconnecting)
+                    errno = savedErrno;
+                    LOG_ERROR("TcpConnection::handleWrite");
+                    if (savedErrno == EIO)
                     {
-                        shutdownInLoop();
+                        forceCloseInLoop(); // 文件段读取失败，后续数据无法按序发出
                     }
+                    return;
                 }
-                else
+                total += static_cast<size_t>(n);
+                loop_->load().addBytes(n);
+                if (outputBuffer_.readableBytes() == 0)
+                {
+                    writeDrained();
+                    return;
+                }
+                if (edgeTriggered_ && static_cast<size_t>(n) < offered)
                 {
-                    LOG_DEBUG("I am going to write more data");
+                    return; // 短写说明发送缓冲区已满，缓冲区腾出空间时会有新的可写边沿
                 }
+            } while (edgeTriggered_ && total < ioBudget_);
+
+            if (edgeTriggered_ && !writeResumePending_)
+            {
+                writeResumePending_ = true;
+                loop_->queueInLoop([conn = shared_from_this()]()
+                                   {
+                                       conn->writeResumePending_ = false;
+                                       conn->handleWrite(); });
             }
-            else
+            else if (!edgeTriggered_)
             {
-                LOG_ERROR("TcpConnection::handleWrite");
+                LOG_DEBUG("I am going to write more data");
             }
         }
         else
@@ -266,24 +797,76 @@ namespace net
         }
     }
 
+    void TcpConnection::handleCompletedWrite()
+    {
+        // poller 提交的 sendmsg 已完成，写出的数据此时才从缓冲区取出
+        const int result = channel_.completedWriteResult();
+        if (result < 0)
+        {
+            errno = -result;
+            LOG_ERROR("TcpConnection::handleWrite");
+            channel_.disableWriting(); // 不再重复提交，连接由读端的关闭或错误处理
+            return;
+        }
+        outputBuffer_.retrieve(static_cast<size_t>(result));
+        loop_->load().addBytes(result);
+        if (outputBuffer_.readableBytes() == 0 && channel_.isWriting())
+        {
+            writeDrained();
+        }
+    }
+
+    void TcpConnection::writeDrained()
+    {
+        channel_.disableWriting();
+        if (writeCompleteCallback_)
+        {
+            loop_->queueInLoop([conn = shared_from_this()]()
+                               { conn->writeCompleteCallback_(conn); });
+        }
+        if (state_.load() == kDisconnecting)
+        {
+            shutdownInLoop();
+        }
+    }
+
     void TcpConnection::handleClose()
     {
         loop_->assertInLoopThread();
         LOG_DEBUG("fd = %d state = %d", sockfd_, static_cast<int>(state_.load()));
         assert(state_.load() == kConnected || state_.load() == kDisconnecting);
+        setState(kDisconnected);
+        channel_.disableAll();
 
-        channel_->disableAll();
-        closeCallback_(shared_from_this());
+        TcpConnectionPtr guardThis(shared_from_this());
+        connectionCallback_(guardThis);
+        closeCallback_(guardThis);
     }
 
     void TcpConnection::handleError()
     {
-        LOG_ERROR("TcpConnection::handleError [%s] - SO_ERROR = %d", name_.c_str(), errno);
+        // 读 SO_ERROR 会清掉挂起的错误，只读一次，后面的日志用同一个值
+        int err = 0;
+        socklen_t optlen = sizeof(err);
+        if (::getsockopt(sockfd_, SOL_SOCKET, SO_ERROR, &err, &optlen) < 0)
+        {
+            err = errno;
+        }
+        int queueErrors = 0;
+        if (outputBuffer_.pinnedCount() > 0 && reapZeroCopy(&queueErrors) && queueErrors == 0 && err == 0 &&
+            (channel_.revents() & POLLERR))
+        {
+            // 只是零拷贝完成通知：清掉 POLLERR，Channel 会继续分发同时到达的读写
+            channel_.setRevents(channel_.revents() & ~POLLERR);
+            return;
+        }
+        LOG_ERROR("TcpConnection::handleError [%s] - SO_ERROR = %d", getName().c_str(), err);
     }
 
     void TcpConnection::forceClose()
     {
-        loop_->runInLoop(std::bind(&TcpConnection::forceCloseInLoop, this));
+        loop_->runInLoop([conn = shared_from_this()]()
+                         { conn->forceCloseInLoop(); });
     }
 
     void TcpConnection::forceCloseInLoop()
@@ -2,8 +2,11 @@
 #include <string>
 #include <memory>
 #include <atomic>
+#include <mutex>
 #include "Noncopyable.hpp"
 #include "Buffer.hpp"
+#include "ChainBuffer.hpp"
+#include "RingBuffer.hpp"
 #include "Callbacks.hpp"
 #include "InetAddress.hpp"
 #include "Timer.hpp"
@@ -23,7 +26,17 @@ namespace net
 
         EventLoop *getLoop() const { return loop_; }
 
-        const std::string &getName() const { return name_; }
+        // 连接自身持有的引用，connectEstablished 到 connectDestroyed 之间有效。
+        // loop 线程内传引用不产生原子计数；跨线程使用时复制一份
+        const TcpConnectionPtr &self() const { return self_; }
+
+        // 服务端连接的名字在第一次取用时才拼接（通常只在打日志时）
+        const std::string &getName() const;
+
+        // 服务端连接 ID，TcpClient 创建的连接为 0
+        ConnectionId id() const { return id_; }
+        // 由 TcpServer 在所属 loop 中登记后、connectEstablished 之前调用，名字为 namePrefix#loop.slot.generation
+        void setId(ConnectionId id, std::shared_ptr<const std::string> namePrefix);
 
         const InetAddress &getLocalAddr() const { return localAddr_; }
 
@@ -32,25 +45,57 @@ namespace net
         bool connected() const { return state_ == kConnected; }
 
         void send(const std::string &message);
+        // 右值和 Buffer 版本跨线程时把存储移交给任务，不拷贝数据；调用后 buf 为空
+        void send(std::string &&message);
         void send(Buffer *buf);
+        void send(Buffer &&buf);
         void send(const void *data, size_t len);
+        // 同一块数据发给多个连接时使用：排队只记录引用，跨线程也只转移引用
+        void send(SharedSlice slice);
+        // 发送文件 fd 的 [offset, offset + len)，与内存数据按调用顺序排队，用 sendfile（管道用 splice）发送。
+        // 不转移 fd 所有权：调用方需保持 fd 打开，直到写完成回调或连接断开
+        void sendFile(int fd, off_t offset, size_t len);
 
         void shutdown();
         void setTcpNoDelay(bool on);
 
-        void setConnectionCallback(const ConnectionCallback cb) { connectionCallback_ = std::move(cb); }
-
-        void setMessageCallback(const MessageCallback cb) { messageCallback_ = std::move(cb); }
-
-        void setWriteCompleteCallback(const WriteCompleteCallback cb) { writeCompleteCallback_ = std::move(cb); }
-        void setHighWaterMarkCallback(const HighWaterMarkCallback cb, size_t HighWaterMark)
+        static constexpr size_t kDefaultIoBudget = 1024 * 1024;
+        // 边沿触发模式：每次事件把 socket 读写到 EAGAIN，单次最多处理 budget 字节，
+        // 预算用完则排到本轮末尾继续，避免大流量连接饿死同一 loop 上的其他连接。
+        // 会把 fd 设为非阻塞，须在 connectEstablished 之前调用
+        void setEdgeTriggered(bool on, size_t budget = kDefaultIoBudget);
+
+        static constexpr size_t kDefaultZeroCopyBytes = 64 * 1024;
+        // 对不小于 minBytes 的 send(SharedSlice) 使用 MSG_ZEROCOPY，数据保留到内核完成通知到达；0 关闭。
+        // 内核不支持 SO_ZEROCOPY 时返回 false 并保持拷贝发送；完成通知报告内核仍做了拷贝时自动关闭。
+        // 在 loop 线程调用（如连接回调中）。发出与退回拷贝的字节数计入 EventLoop::stats()
+        bool setZeroCopy(size_t minBytes = kDefaultZeroCopyBytes);
+
+        // 批量写：loop 线程中的 send 不再立即 write，只进发送缓冲区，本轮事件和任务处理完后
+        // 每个连接用一次 writev 发出，把逐个 RTP 包的小写合并。moreHint 为 true 时这次写带 MSG_MORE，
+        // 不足一个报文段的尾部留在内核等后续数据，调用方在一帧结束时调用 flush() 推出。在 loop 线程调用
+        void setWriteBatching(bool on, bool moreHint = false);
+        // 立即写出已排队的数据且不带 MSG_MORE，用于时延敏感的控制应答；可跨线程调用
+        void flush();
+
+        void setConnectionCallback(ConnectionCallback cb) { connectionCallback_ = std::move(cb); }
+
+        void setMessageCallback(MessageCallback cb) { messageCallback_ = std::move(cb); }
+        // 接收缓冲区换成双重映射的 RingBuffer，之后收到的数据交给 cb 而不是消息回调；
+        // 已收到未取走的数据一并转入。适合长时间高速率的流式输入，在 loop 线程调用（如连接回调中）
+        void setRingInput(RingMessageCallback cb, size_t capacity = RingBuffer::kDefaultCapacity);
+
+        void setWriteCompleteCallback(WriteCompleteCallback cb) { writeCompleteCallback_ = std::move(cb); }
+        void setHighWaterMarkCallback(HighWaterMarkCallback cb, size_t HighWaterMark)
         {
             highWaterMarkCallback_ = std::move(cb);
             HighWaterMark_ = HighWaterMark;
         }
-        void setCloseCallback(const CloseCallback cb) { closeCallback_ = std::move(cb); }
+        void setCloseCallback(CloseCallback cb) { closeCallback_ = std::move(cb); }
         void connectEstablished();
         void connectDestroyed();
+        // 由所属 loop 定期调用：两次调用之间没有读到数据则释放接收缓冲区，发送缓冲区已空时释放段表
+        void releaseIdleBuffers();
         void forceClose();
 
         static void defaultConnectionCallback(const TcpConnectionPtr &conn);
@@ -66,23 +111,56 @@ namespace net
             kDisconnecting
         };
         void handleRead(Timestamp receiveTime);
-        void handleWrite();
+        void handleReadEdgeTriggered(Timestamp receiveTime);
+        void handleCompletedRead(Timestamp receiveTime);
+        // 用 loop 共用的溢出区读 socket，接收缓冲区按 loop 的提示值首次分配
+        ssize_t readInput(int *savedErrno);
+        void prepareInput();
+        void inputReceived();
+        size_t inputBytes() const;
+        void deliverInput(const TcpConnectionPtr &conn, Timestamp receiveTime);
+        // flags 传给 sendmsg，批量写带 MSG_MORE 时使用
+        void handleWrite(int flags = 0);
         void handleClose();
         void handleError();
+        // 读失败：记录错误，非 EAGAIN/EINTR 时关闭连接
+        void handleReadError(int savedErrno);
 
         void sendInLoop(const std::string &message);
         void sendInLoop(Buffer *buf);
         void sendInLoop(const void *data, size_t len);
+        void sendInLoop(const SharedSlice &slice);
+        // 先尝试直接写，剩余部分放进发送缓冲区；shared 非空时剩余部分按引用排队
+        void sendInLoop(const void *data, size_t len, const SharedSlice *shared);
+        void sendFileInLoop(int fd, off_t offset, size_t len);
+        // 数据已放进发送缓冲区后调用：没有在等可写事件时立即尝试发送
+        void writeQueued();
+        // 批量写模式下登记本轮结束时的写，每轮每个连接一次
+        void scheduleFlush();
+        void flushInLoop(int flags);
+        // 发送是否交给 poller 异步提交（io_uring 且非边沿触发）
+        bool pollerSends() const;
+        // poller 提交发送前取待发数据，见 Channel::setCompletedWriteSource
+        int prepareCompletedWrite(struct iovec *vec, int maxIov, int *flags);
+        void handleCompletedWrite();
+        // 发送缓冲区写空后停止关注可写，通知写完并处理挂起的关闭
+        void writeDrained();
+        // 处理 MSG_ZEROCOPY 完成通知，返回是否读到了通知；同时取出的其他错误记日志并累加到 *errors
+        bool reapZeroCopy(int *errors);
 
         void setState(StateE state) { state_ = state; }
         void shutdownInLoop();
         void forceCloseInLoop();
 
         EventLoop *loop_;
-        const std::string name_;
+        mutable std::string name_;
+        mutable std::once_flag nameOnce_;
+        ConnectionId id_;
+        std::shared_ptr<const std::string> namePrefix_;
         std::atomic<StateE> state_;
         int sockfd_;
-        std::unique_ptr<Channel> channel_;
+        Channel channel_; // 与连接同一块内存
+        TcpConnectionPtr self_;
 
         InetAddress localAddr_;
         InetAddress peerAddr_;
@@ -92,9 +170,20 @@ namespace net
         CloseCallback closeCallback_;
         HighWaterMarkCallback highWaterMarkCallback_;
         size_t HighWaterMark_;
+        bool edgeTriggered_;
+        size_t ioBudget_; // 边沿触发下单次事件最多读/写的字节数
+        bool readResumePending_;  // 已排队续读，新的边沿不再重复排队
+        bool readSinceSweep_;     // 上次 releaseIdleBuffers 之后是否读到过数据
+        bool writeResumePending_; // 已排队续写
+        bool batchWrites_;
+        bool flushPending_; // 已登记本轮结束时的写
+        int batchFlags_;    // 本轮结束时写的 sendmsg 标志
+        bool flushRequested_; // poller 下一次提交的发送不带 batchFlags_
 
         Buffer inputBuffer_;
-        Buffer outputBuffer_;
+        std::unique_ptr<RingBuffer> ringInput_; // 非空时取代 inputBuffer_
+        RingMessageCallback ringMessageCallback_;
+        ChainBuffer outputBuffer_; // 分段存放，用 writev 发送
         std::mutex mutex_;
     };
 }
\ No newline at end of file
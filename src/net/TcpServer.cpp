@@ -4,6 +4,7 @@
 #include "EventLoopThreadPool.hpp"
 #include "Acceptor.hpp"
 #include <assert.h>
+#include <future>
 namespace net
 {
 
@@ -11,96 +12,236 @@ namespace net
         : loop_(loop),
           ipPort_(listenAddr.toIpPort()),
           name_(name),
+          listenAddr_(listenAddr),
+          reusePort_(reusePort),
           acceptor_(new Acceptor(loop, listenAddr, reusePort)),
           threadPool_(new EventLoopThreadPool(loop, name)),
-          connectionCallback_(nullptr),
-          messageCallback_(nullptr),
+          connectionCallback_(TcpConnection::defaultConnectionCallback),
+          messageCallback_(TcpConnection::defaultMessageCallback),
           writeCompleteCallback_(nullptr),
           highWaterMarkCallback_(nullptr),
           highWaterMark_(10 * 1024 * 1024),
-          started_(false),
-          nextConnId_(1)
+          edgeTriggered_(false),
+          ioBudget_(0),
+          acceptorPerLoop_(false),
+          steerByCpu_(false),
+          acceptBatch_(Acceptor::kDefaultAcceptBatch),
+          idleBufferSeconds_(kDefaultIdleBufferSeconds),
+          namePrefix_(std::make_shared<const std::string>(name + "-" + ipPort_)),
+          started_(false)
     {
         acceptor_->setNewConnectionCallback(
             std::bind(&TcpServer::newConnection, this, std::placeholders::_1, std::placeholders::_2));
     }
 
+    // Acceptor 只在此处完整可见
+    TcpServer::LoopContext::LoopContext(uint16_t loopIndex, EventLoop *ioLoop)
+        : index(loopIndex), loop(ioLoop), connections(loopIndex)
+    {
+    }
+
+    TcpServer::LoopContext::~LoopContext() = default;
+
     TcpServer::~TcpServer()
     {
         LOG_DEBUG("TcpServer:~TcpServer[%s] destructing", name_.c_str());
         loop_->assertInLoopThread();
 
-        for (auto &item : connections_)
+        // 未开 IO 线程时连接都在 baseLoop 上，直接销毁；IO loop 的监听器和连接只能在各自线程中销毁，
+        // 由线程退出前的回调完成（见 start），已经先行退出的 loop 也已清理过，这里不向可能不再运行的 loop 投递任务
+        for (auto &slot : loopContexts_)
         {
-            TcpConnectionPtr conn(item.second);
-            item.second.reset();
-            conn->getLoop()->runInLoop(std::bind(&TcpConnection::connectDestroyed, conn));
+            if (slot->loop == loop_)
+            {
+                destroyLoopContext(slot.get());
+            }
         }
+        threadPool_->stop();
     }
 
-    void TcpServer::setThreadNum(int Threads)
+    void TcpServer::setThreadNum(int Threads, const ThreadPlacement &placement)
     {
         threadPool_->setThreadNum(Threads);
+        threadPool_->setThreadPlacement(placement);
+    }
+
+    void TcpServer::setLoadBalance(EventLoopThreadPool::LoadBalance strategy)
+    {
+        threadPool_->setLoadBalance(strategy);
+    }
+
+    void TcpServer::setLoopChooser(EventLoopThreadPool::LoopChooser chooser)
+    {
+        threadPool_->setLoopChooser(std::move(chooser));
+    }
+
+    void TcpServer::setAcceptBatch(int batch)
+    {
+        acceptBatch_ = batch;
+        acceptor_->setAcceptBatch(batch);
     }
 
     void TcpServer::start()
     {
         if (!started_.exchange(true))
         {
-            threadPool_->start();
+            // 每个 loop 的上下文在该 loop 开始运行前建好，在它退出后、销毁前拆掉
+            threadPool_->start([this](EventLoop *ioLoop)
+                               { addLoopContext(ioLoop); },
+                               [this](EventLoop *ioLoop)
+                               { destroyLoopContext(contextOf(ioLoop)); });
+            if (acceptorPerLoop_ && !reusePort_)
+            {
+                LOG_WARN("TcpServer [%s] acceptor per loop needs reuseport, using a single acceptor", name_.c_str());
+            }
+            if (acceptorPerLoop_ && reusePort_ && threadPool_->getAllLoops().front() != loop_)
+            {
+                startLoopAcceptors();
+                return;
+            }
             assert(!acceptor_->listenning());
             loop_->runInLoop(std::bind(&Acceptor::listen, acceptor_.get()));
         }
     }
+
+    void TcpServer::addLoopContext(EventLoop *ioLoop)
+    {
+        ioLoop->assertInLoopThread();
+        loopContexts_.emplace_back(new LoopContext(static_cast<uint16_t>(loopContexts_.size()), ioLoop));
+        if (idleBufferSeconds_ > 0)
+        {
+            LoopContext *context = loopContexts_.back().get();
+            context->idleBufferTimer = ioLoop->runEvery(idleBufferSeconds_, [context]()
+                                                        { context->connections.forEach([](ConnectionId, const TcpConnectionPtr &conn)
+                                                                                       { conn->releaseIdleBuffers(); }); });
+        }
+    }
+
+    void TcpServer::destroyLoopContext(LoopContext *context)
+    {
+        context->loop->assertInLoopThread();
+        context->loop->cancel(context->idleBufferTimer);
+        context->acceptor.reset();
+        context->connections.forEach([](ConnectionId, const TcpConnectionPtr &conn)
+                                     { conn->connectDestroyed(); });
+        context->connections.clear();
+    }
+
+    EventLoopStats TcpServer::loopStats() const
+    {
+        return threadPool_->stats();
+    }
+
+    AcceptStats TcpServer::acceptStats() const
+    {
+        AcceptStats stats = acceptor_->stats();
+        for (const auto &slot : loopContexts_)
+        {
+            if (slot->acceptor)
+            {
+                stats.merge(slot->acceptor->stats());
+            }
+        }
+        return stats;
+    }
     void TcpServer::newConnection(int sockfd, const InetAddress &peerAddr)
     {
         loop_->assertInLoopThread();
-        EventLoop *ioLoop = threadPool_->getNextLoop();
-        char buf[64];
-        snprintf(buf, sizeof buf, "-%s#%d", ipPort_.c_str(), nextConnId_);
-        ++nextConnId_;
-        std::string connName = name_ + buf;
+        EventLoop *ioLoop = threadPool_->getNextLoop(threadPool_->usesHashCode() ? peerAddr.ipHash() : 0);
+        LoopContext *context = contextOf(ioLoop);
+        TcpConnectionPtr conn = createConnection(ioLoop, sockfd, peerAddr);
+        // 连接表属于 IO loop，登记和移除都在该线程完成，关闭时不再回到 baseLoop
+        ioLoop->runInLoop(std::bind(&TcpServer::registerConnection, this, context, conn));
+    }
 
-        LOG_INFO("TcpServer::newConnection [%s] - new connection [%s] from %s",
-                 name_.c_str(), connName.c_str(), peerAddr.toIpPort().c_str());
+    void TcpServer::newLoopConnection(LoopContext *context, int sockfd, const InetAddress &peerAddr)
+    {
+        context->loop->assertInLoopThread();
+        registerConnection(context, createConnection(context->loop, sockfd, peerAddr));
+    }
 
+    TcpConnectionPtr TcpServer::createConnection(EventLoop *ioLoop, int sockfd, const InetAddress &peerAddr)
+    {
         InetAddress localAddr(Socket::getLocalAddr(sockfd));
-        TcpConnectionPtr conn(new TcpConnection(ioLoop,
-                                                connName,
-                                                sockfd,
-                                                localAddr,
-                                                peerAddr));
-
-        connections_[connName] = conn;
+        // 连接和 shared_ptr 控制块放在所属 loop 内存池的同一块里，一次分配
+        TcpConnectionPtr conn = std::allocate_shared<TcpConnection>(base::PoolAllocator<TcpConnection>(&ioLoop->connectionPool()),
+                                                                    ioLoop,
+                                                                    std::string(),
+                                                                    sockfd,
+                                                                    localAddr,
+                                                                    peerAddr);
         conn->setConnectionCallback(connectionCallback_);
         conn->setMessageCallback(messageCallback_);
         conn->setWriteCompleteCallback(writeCompleteCallback_);
         conn->setHighWaterMarkCallback(highWaterMarkCallback_, highWaterMark_);
+        if (edgeTriggered_)
+        {
+            conn->setEdgeTriggered(true, ioBudget_ > 0 ? ioBudget_ : TcpConnection::kDefaultIoBudget);
+        }
+        return conn;
+    }
 
-        conn->setCloseCallback(
-            std::bind(&TcpServer::removeConnection, this, std::placeholders::_1));
+    void TcpServer::registerConnection(LoopContext *context, const TcpConnectionPtr &conn)
+    {
+        context->loop->assertInLoopThread();
+        conn->setId(context->connections.insert(conn), namePrefix_);
+        // 两个指针的 lambda 放得进 std::function 的内联存储，不额外分配
+        conn->setCloseCallback([this, context](const TcpConnectionPtr &closed)
+                               { removeConnection(context, closed); });
+        conn->connectEstablished();
+    }
 
-        ioLoop->runInLoop(std::bind(&TcpConnection::connectEstablished, conn));
+    void TcpServer::removeConnection(LoopContext *context, const TcpConnectionPtr &conn)
+    {
+        context->loop->assertInLoopThread();
+        TcpConnectionPtr removed = context->connections.erase(conn->id());
+        (void)removed;
+        assert(removed == conn);
+        // 当前仍在 handleClose 的调用栈中，延后销毁 channel
+        context->loop->queueInLoop(
+            std::bind(&TcpConnection::connectDestroyed, conn));
     }
-    void TcpServer::removeConnection(const TcpConnectionPtr &conn)
+
+    TcpServer::LoopContext *TcpServer::contextOf(EventLoop *ioLoop) const
     {
-        loop_->runInLoop(
-            std::bind(&TcpServer::removeConnectionInLoop, this, conn));
+        // loop 数量很少，线性查找即可
+        for (const auto &slot : loopContexts_)
+        {
+            if (slot->loop == ioLoop)
+            {
+                return slot.get();
+            }
+        }
+        assert(false);
+        return nullptr;
     }
 
-    void TcpServer::removeConnectionInLoop(const TcpConnectionPtr &conn)
+    void TcpServer::startLoopAcceptors()
     {
         loop_->assertInLoopThread();
-        LOG_INFO("TcpServer::removeConnectionInLoop [%s] - connection %s",
-                 name_.c_str(), conn->getName().c_str());
-
-        size_t n = connections_.erase(conn->getName());
-        (void)n;
-        assert(n == 1);
-
-        EventLoop *ioLoop = conn->getLoop();
-        ioLoop->queueInLoop(
-            std::bind(&TcpConnection::connectDestroyed, conn));
+        std::vector<int> cpus;
+        for (auto &slot : loopContexts_)
+        {
+            LoopContext *context = slot.get();
+            context->acceptor.reset(new Acceptor(context->loop, listenAddr_, true));
+            context->acceptor->setAcceptBatch(acceptBatch_);
+            context->acceptor->setNewConnectionCallback(
+                std::bind(&TcpServer::newLoopConnection, this, context, std::placeholders::_1, std::placeholders::_2));
+            // 依次监听：socket 在 reuseport 组里的序号就是 CBPF 程序返回的下标
+            std::promise<void> listening;
+            Acceptor *acceptor = context->acceptor.get();
+            context->loop->runInLoop([acceptor, &listening]()
+                                     {
+                                         acceptor->listen();
+                                         listening.set_value(); });
+            listening.get_future().wait();
+            cpus.push_back(context->loop->stats().cpu);
+        }
+        if (steerByCpu_)
+        {
+            loopContexts_.front()->acceptor->socket().setReusePortCpuSteering(cpus);
+        }
+        LOG_INFO("TcpServer [%s] listening on %s with %zu reuseport acceptors%s", name_.c_str(), ipPort_.c_str(),
+                 loopContexts_.size(), steerByCpu_ ? ", steered by cpu" : "");
     }
-
-}
\ No newline at end of file
+}
@@ -8,13 +8,17 @@
  *
  */
 #pragma once
-#include <map>
 #include <string>
+#include <vector>
 #include <memory>
 #include <atomic>
 #include "Callbacks.hpp"
 #include "InetAddress.hpp"
 #include "Noncopyable.hpp"
+#include "EventLoopStats.hpp"
+#include "ThreadPlacement.hpp"
+#include "EventLoopThreadPool.hpp"
+#include "ConnectionRegistry.hpp"
 
 namespace net
 {
@@ -59,9 +63,25 @@ namespace net
          * 线程数大于0则创建对应数量的工作线程。
          *
          * @param numThreads 线程数量
+         * @param placement IO 线程的绑核策略：CPU 列表、compact 或按 NUMA 节点 spread，默认不绑核
          * @note 必须在start()之前调用
          */
-        void setThreadNum(int numThreads);
+        void setThreadNum(int numThreads, const ThreadPlacement &placement = ThreadPlacement());
+        /**
+         * @brief 设置新连接分配到 IO loop 的策略
+         *
+         * 默认轮询；也可按连接数、收发速率、两次随机选择或对端 IP 哈希分配，
+         * 负载来自各 loop 无锁更新的计数，适合码率差异大的连接混跑。
+         *
+         * @param strategy 内置策略，kHash 使用对端 IP 的哈希，同一客户端总落在同一 loop
+         */
+        void setLoadBalance(EventLoopThreadPool::LoadBalance strategy);
+        /**
+         * @brief 设置自定义的 loop 挑选函数，优先于 setLoadBalance
+         *
+         * @note 在 baseLoop 线程中调用 chooser，hashCode 为对端 IP 的哈希
+         */
+        void setLoopChooser(EventLoopThreadPool::LoopChooser chooser);
 
         void setConnectionCallback(ConnectionCallback cb) { connectionCallback_ = std::move(cb); }
         void setMessageCallback(MessageCallback cb) { messageCallback_ = std::move(cb); }
@@ -72,22 +92,102 @@ namespace net
             highWaterMarkCallback_ = std::move(cb);
             highWaterMark_ = highWaterMark;
         }
+        /**
+         * @brief 新连接改用边沿触发（EPOLLET）
+         *
+         * 每次可读/可写事件把 socket 读写到 EAGAIN，减少大流量连接的 epoll_wait 轮数。
+         *
+         * @param on 是否启用
+         * @param ioBudget 单次事件最多读/写的字节数，用完后让出给同一 loop 上的其他连接，0 表示使用默认值
+         * @note 必须在start()之前调用
+         */
+        void setEdgeTriggered(bool on, size_t ioBudget = 0)
+        {
+            edgeTriggered_ = on;
+            ioBudget_ = ioBudget;
+        }
+        /**
+         * @brief 每个 IO loop 各自监听（SO_REUSEPORT），由内核分配 accept
+         *
+         * 连接在接受它的 loop 上创建、回调和销毁，不再经过 baseLoop 转交。
+         * 需要构造时 reuseport 为 true 且线程数大于 0，否则仍使用 baseLoop 上的单个 Acceptor。
+         *
+         * @param on 是否启用
+         * @param steerByCpu 附加 CBPF 程序，把连接交给绑定在收包 CPU 上的 loop，配合 setThreadNum 的绑核策略使用
+         * @note 必须在start()之前调用
+         */
+        void setAcceptorPerLoop(bool on, bool steerByCpu = false)
+        {
+            acceptorPerLoop_ = on;
+            steerByCpu_ = steerByCpu;
+        }
+        /**
+         * @brief 设置每次监听 socket 可读时最多接受的连接数
+         *
+         * 连接风暴时一次取完 backlog 会让同一 loop 上的其他连接等待，剩余的留到下一轮。
+         *
+         * @param batch 默认 Acceptor::kDefaultAcceptBatch
+         * @note 必须在start()之前调用
+         */
+        void setAcceptBatch(int batch);
+        /**
+         * @brief 设置空闲连接缓冲区的回收周期
+         *
+         * 每个 IO loop 按该周期巡检自己的连接：上一周期内没有读到数据的连接释放接收缓冲区，
+         * 发送缓冲区已空的连接释放段表。关键帧突发之后，大量空闲观众连接不再各自占着峰值容量。
+         *
+         * @param seconds 巡检周期，默认 kDefaultIdleBufferSeconds，0 表示不回收
+         * @note 必须在start()之前调用
+         */
+        void setIdleBufferRelease(double seconds) { idleBufferSeconds_ = seconds; }
+        static constexpr double kDefaultIdleBufferSeconds = 10.0;
         /**
          * @brief 启动服务器
          *
          */
         void start();
+        /**
+         * @brief 汇总所有 IO loop 的运行统计
+         *
+         * @note 必须在start()之后调用，可在任意线程调用
+         */
+        EventLoopStats loopStats() const;
+        /**
+         * @brief 汇总所有 Acceptor 的接受计数，包括 fd 耗尽时被丢弃的连接
+         *
+         * @note 必须在start()之后调用，可在任意线程调用
+         */
+        AcceptStats acceptStats() const;
 
     private:
-        void newConnection(int sockfd, const InetAddress &peerAddr);
-        void removeConnection(const TcpConnectionPtr &conn);
-        void removeConnectionInLoop(const TcpConnectionPtr &conn);
+        // 每个 IO loop 的连接表和 SO_REUSEPORT 模式下的监听器，只在该 loop 线程中访问
+        struct LoopContext
+        {
+            LoopContext(uint16_t loopIndex, EventLoop *ioLoop);
+            ~LoopContext();
+            uint16_t index;
+            EventLoop *loop;
+            std::unique_ptr<Acceptor> acceptor;
+            ConnectionRegistry connections;
+            TimerId idleBufferTimer;
+        };
 
-        using ConnectionMap = std::map<std::string, TcpConnectionPtr>;
+        // 在 loop 线程中建立/拆除该 loop 的上下文，由线程池在 loop 运行前后调用
+        void addLoopContext(EventLoop *ioLoop);
+        void destroyLoopContext(LoopContext *context);
+        void newConnection(int sockfd, const InetAddress &peerAddr);
+        void newLoopConnection(LoopContext *context, int sockfd, const InetAddress &peerAddr);
+        TcpConnectionPtr createConnection(EventLoop *ioLoop, int sockfd, const InetAddress &peerAddr);
+        void registerConnection(LoopContext *context, const TcpConnectionPtr &conn);
+        void removeConnection(LoopContext *context, const TcpConnectionPtr &conn);
+        LoopContext *contextOf(EventLoop *ioLoop) const;
+        void startLoopAcceptors();
 
         EventLoop *loop_; // the base loop
         const std::string ipPort_;
         const std::string name_;
+        const InetAddress listenAddr_;
+        const bool reusePort_;
 
         std::unique_ptr<Acceptor> acceptor_; // avoid revealing Acceptor
         std::unique_ptr<EventLoopThreadPool> threadPool_;
@@ -97,9 +197,15 @@ namespace net
         WriteCompleteCallback writeCompleteCallback_;
         HighWaterMarkCallback highWaterMarkCallback_;
         size_t highWaterMark_;
+        bool edgeTriggered_;
+        size_t ioBudget_;
+        bool acceptorPerLoop_;
+        bool steerByCpu_;
+        int acceptBatch_;
+        double idleBufferSeconds_;
+        std::vector<std::unique_ptr<LoopContext>> loopContexts_; // 与 threadPool_->getAllLoops() 一一对应
+        std::shared_ptr<const std::string> namePrefix_;           // name-ip:port，连接名按需拼接
 
         std::atomic<bool> started_;
-        int nextConnId_;
-        ConnectionMap connections_;
     };
 } // namespace net
@@ -0,0 +1,217 @@
+#include "ThreadPlacement.hpp"
+#include "Logger.hpp"
+#include <dirent.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace net
+{
+    namespace
+    {
+        // 解析 "0-3,8,10-11" 形式的 CPU 列表
+        std::vector<int> parseCpuList(const std::string &text)
+        {
+            std::vector<int> cpus;
+            std::stringstream ss(text);
+            std::string range;
+            while (std::getline(ss, range, ','))
+            {
+                if (range.empty() || range[0] == '\n')
+                {
+                    continue;
+                }
+                int first = std::atoi(range.c_str());
+                int last = first;
+                std::string::size_type dash = range.find('-');
+                if (dash != std::string::npos)
+                {
+                    last = std::atoi(range.c_str() + dash + 1);
+                }
+                for (int cpu = first; cpu <= last; ++cpu)
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+            return cpus;
+        }
+    }
+
+    const CpuTopology &CpuTopology::instance()
+    {
+        static const CpuTopology topology("/sys/devices/system/node");
+        return topology;
+    }
+
+    CpuTopology::CpuTopology(const std::string &nodeDir) : numCpus_(0)
+    {
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                CPU_SET(cpu, &allowed);
+            }
+        }
+
+        std::vector<std::pair<int, std::vector<int>>> nodes;
+        if (DIR *dir = ::opendir(nodeDir.c_str()))
+        {
+            while (dirent *entry = ::readdir(dir))
+            {
+                int node = 0;
+                if (std::sscanf(entry->d_name, "node%d", &node) != 1)
+                {
+                    continue;
+                }
+                std::ifstream file(nodeDir + "/" + entry->d_name + "/cpulist");
+                std::string line;
+                std::getline(file, line);
+                std::vector<int> cpus;
+                for (int cpu : parseCpuList(line))
+                {
+                    if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+                    {
+                        cpus.push_back(cpu);
+                    }
+                }
+                if (!cpus.empty())
+                {
+                    nodes.emplace_back(node, std::move(cpus));
+                }
+            }
+            ::closedir(dir);
+        }
+        std::sort(nodes.begin(), nodes.end());
+        for (auto &node : nodes)
+        {
+            nodeIds_.push_back(node.first);
+            nodes_.push_back(std::move(node.second));
+        }
+
+        if (nodes_.empty())
+        {
+            std::vector<int> cpus;
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &allowed))
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+            nodeIds_.push_back(0);
+            nodes_.push_back(std::move(cpus));
+        }
+        for (const auto &cpus : nodes_)
+        {
+            numCpus_ += static_cast<int>(cpus.size());
+        }
+    }
+
+    int CpuTopology::nodeOf(int cpu) const
+    {
+        for (size_t node = 0; node < nodes_.size(); ++node)
+        {
+            if (std::find(nodes_[node].begin(), nodes_[node].end(), cpu) != nodes_[node].end())
+            {
+                return nodeIds_[node];
+            }
+        }
+        return -1;
+    }
+
+    ThreadPlacement ThreadPlacement::cpuList(std::vector<int> cpus)
+    {
+        ThreadPlacement placement(Policy::kCpuList);
+        placement.cpus_ = std::move(cpus);
+        return placement;
+    }
+
+    int ThreadPlacement::cpuFor(int index) const
+    {
+        const CpuTopology &topology = CpuTopology::instance();
+        const auto &nodes = topology.nodes();
+        switch (policy_)
+        {
+        case Policy::kCpuList:
+            return cpus_.empty() ? -1 : cpus_[static_cast<size_t>(index) % cpus_.size()];
+        case Policy::kCompact:
+        {
+            int slot = index % topology.numCpus();
+            for (const auto &cpus : nodes)
+            {
+                if (slot < static_cast<int>(cpus.size()))
+                {
+                    return cpus[slot];
+                }
+                slot -= static_cast<int>(cpus.size());
+            }
+            return -1;
+        }
+        case Policy::kSpread:
+        {
+            const auto &cpus = nodes[static_cast<size_t>(index) % nodes.size()];
+            return cpus[(static_cast<size_t>(index) / nodes.size()) % cpus.size()];
+        }
+        case Policy::kNone:
+            break;
+        }
+        return -1;
+    }
+
+    std::string ThreadPlacement::toString() const
+    {
+        switch (policy_)
+        {
+        case Policy::kCpuList:
+        {
+            std::string text = "cpus:";
+            for (size_t i = 0; i < cpus_.size(); ++i)
+            {
+                text += (i == 0 ? "" : ",") + std::to_string(cpus_[i]);
+            }
+            return text;
+        }
+        case Policy::kCompact:
+            return "compact";
+        case Policy::kSpread:
+            return "spread";
+        case Policy::kNone:
+            break;
+        }
+        return "none";
+    }
+
+    bool ThreadPlacement::bindCurrentThread(int cpu)
+    {
+        if (cpu < 0 || cpu >= CPU_SETSIZE)
+        {
+            return false;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        int err = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+        if (err != 0)
+        {
+            LOG_WARN("bind thread to cpu %d failed: %s", cpu, strerror(err));
+            return false;
+        }
+        // 之后本线程的新页优先从所在节点分配；内核不支持时保持默认的首次访问策略
+        if (::syscall(SYS_set_mempolicy, MPOL_LOCAL, nullptr, 0) != 0)
+        {
+            LOG_DEBUG("set_mempolicy(MPOL_LOCAL) failed: %s", strerror(errno));
+        }
+        return true;
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace net
+{
+    // 机器的 NUMA 拓扑：每个节点上本进程允许使用的 CPU。
+    // 读取 /sys/devices/system/node，没有 NUMA 信息时视为单节点 0；没有允许 CPU 的节点不计入
+    class CpuTopology
+    {
+    public:
+        static const CpuTopology &instance();
+        // 从指定目录读取节点信息，目录结构同 /sys/devices/system/node
+        explicit CpuTopology(const std::string &nodeDir);
+
+        const std::vector<std::vector<int>> &nodes() const { return nodes_; }
+        // nodes() 中各节点的实际节点号（sysfs 中的 nodeN），cpuset 或稀疏编号下与下标不同
+        const std::vector<int> &nodeIds() const { return nodeIds_; }
+        int numCpus() const { return numCpus_; }
+        int nodeOf(int cpu) const; // 返回实际节点号，未知 CPU 返回 -1
+
+    private:
+        std::vector<std::vector<int>> nodes_;
+        std::vector<int> nodeIds_;
+        int numCpus_;
+    };
+
+    // IO 线程的放置策略，线程在创建 EventLoop 之前绑核，并把内存策略设为本地节点分配，
+    // 之后 loop 线程里分配的缓冲区都落在该节点上
+    class ThreadPlacement
+    {
+    public:
+        enum class Policy
+        {
+            kNone,    // 不绑核，由调度器决定
+            kCpuList, // 按给定 CPU 列表依次绑定
+            kCompact, // 先填满一个节点再用下一个
+            kSpread,  // 轮流分布到各节点
+        };
+
+        ThreadPlacement() : policy_(Policy::kNone) {}
+        static ThreadPlacement cpuList(std::vector<int> cpus);
+        static ThreadPlacement compact() { return ThreadPlacement(Policy::kCompact); }
+        static ThreadPlacement spread() { return ThreadPlacement(Policy::kSpread); }
+
+        Policy policy() const { return policy_; }
+        // 第 index 个 IO 线程应绑定的 CPU，不绑核时返回 -1
+        int cpuFor(int index) const;
+        std::string toString() const;
+
+        // 把调用线程绑定到 cpu 并优先从本地节点分配内存，失败返回 false
+        static bool bindCurrentThread(int cpu);
+
+    private:
+        explicit ThreadPlacement(Policy policy) : policy_(policy) {}
+
+        Policy policy_;
+        std::vector<int> cpus_;
+    };
+}
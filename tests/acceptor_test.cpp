@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "net/Acceptor.hpp"
+#include "net/EventLoop.hpp"
+#include "net/InetAddress.hpp"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace net;
+
+namespace
+{
+    int connectTo(uint16_t port)
+    {
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        return sockfd;
+    }
+}
+
+// 测试每次可读事件最多接受 batch 个连接，其余留到下一轮
+TEST(AcceptorTest, BatchedAccept)
+{
+    EventLoop loop;
+    Acceptor acceptor(&loop, InetAddress(9883), false);
+    acceptor.setAcceptBatch(2);
+    std::vector<int> accepted;
+    acceptor.setNewConnectionCallback([&](int sockfd, const InetAddress &)
+                                      {
+        EXPECT_NE(fcntl(sockfd, F_GETFL) & O_NONBLOCK, 0);
+        accepted.push_back(sockfd); });
+    acceptor.listen();
+
+    std::vector<int> clients;
+    for (int i = 0; i < 5; ++i)
+    {
+        clients.push_back(connectTo(9883)); // 握手由内核完成，连接留在 backlog 中
+    }
+    loop.runEvery(0.01, [&]()
+                  {
+                      if (accepted.size() == clients.size())
+                      {
+                          loop.quit();
+                      } });
+    loop.runAfter(2.0, [&]()
+                  { loop.quit(); });
+    loop.loop();
+
+    AcceptStats stats = acceptor.stats();
+    EXPECT_EQ(accepted.size(), clients.size());
+    EXPECT_EQ(stats.accepted, 5);
+    EXPECT_EQ(stats.maxBatch, 2);
+    EXPECT_GE(stats.wakeups, 3);
+    for (int fd : accepted)
+    {
+        close(fd);
+    }
+    for (int fd : clients)
+    {
+        close(fd);
+    }
+}
+
+// 测试 fd 耗尽时用备用 fd 接下连接并关闭，loop 不抛异常也不空转
+TEST(AcceptorTest, SheddingWhenOutOfFds)
+{
+    EventLoop loop;
+    Acceptor acceptor(&loop, InetAddress(9884), false);
+    int callbacks = 0;
+    acceptor.setNewConnectionCallback([&](int sockfd, const InetAddress &)
+                                      {
+        ++callbacks;
+        close(sockfd); });
+    acceptor.listen();
+
+    std::vector<int> clients;
+    for (int i = 0; i < 3; ++i)
+    {
+        clients.push_back(connectTo(9884));
+    }
+
+    // 把上限压到最小空闲 fd，之后任何新 fd 都会 EMFILE
+    rlimit saved;
+    getrlimit(RLIMIT_NOFILE, &saved);
+    int probe = open("/dev/null", O_RDONLY);
+    close(probe);
+    rlimit limited = saved;
+    limited.rlim_cur = static_cast<rlim_t>(probe);
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &limited), 0);
+
+    loop.runEvery(0.01, [&]()
+                  {
+                      if (acceptor.stats().shed == static_cast<int64_t>(clients.size()))
+                      {
+                          loop.quit();
+                      } });
+    loop.runAfter(2.0, [&]()
+                  { loop.quit(); });
+    loop.loop();
+    setrlimit(RLIMIT_NOFILE, &saved);
+
+    AcceptStats stats = acceptor.stats();
+    EXPECT_EQ(callbacks, 0);
+    EXPECT_EQ(stats.accepted, 0);
+    EXPECT_EQ(stats.shed, 3);
+    for (int fd : clients)
+    {
+        char c;
+        EXPECT_LE(recv(fd, &c, 1, 0), 0); // 被服务端关闭
+        close(fd);
+    }
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include "base/BlockPool.hpp"
+#include <memory>
+#include <set>
+#include <vector>
+
+using namespace base;
+
+// 测试块复用、按 chunk 增长以及大小不符时退回 operator new
+TEST(BlockPoolTest, ReuseAndGrow)
+{
+    BlockPool pool(4);
+    void *first = pool.allocate(100);
+    EXPECT_EQ(pool.blockSize() % alignof(std::max_align_t), 0u);
+    EXPECT_GE(pool.blockSize(), 100u);
+    pool.deallocate(first, 100);
+    EXPECT_EQ(pool.allocate(100), first); // 刚释放的块最先复用
+
+    std::set<void *> blocks{first};
+    for (int i = 0; i < 7; ++i)
+    {
+        blocks.insert(pool.allocate(100));
+    }
+    EXPECT_EQ(blocks.size(), 8u);
+    EXPECT_EQ(pool.blocksInUse(), 8u);
+    EXPECT_EQ(pool.chunkCount(), 2u);
+
+    void *large = pool.allocate(4096);
+    EXPECT_EQ(pool.blocksInUse(), 8u);
+    pool.deallocate(large, 4096);
+
+    for (void *block : blocks)
+    {
+        pool.deallocate(block, 100);
+    }
+    EXPECT_EQ(pool.blocksInUse(), 0u);
+}
+
+// 测试 allocate_shared 把控制块和对象放进池中，最后一个引用释放后归还
+TEST(BlockPoolTest, AllocateShared)
+{
+    BlockPool pool;
+    std::vector<std::shared_ptr<std::vector<int>>> objects;
+    for (int i = 0; i < 100; ++i)
+    {
+        objects.push_back(std::allocate_shared<std::vector<int>>(PoolAllocator<std::vector<int>>(&pool), 3, i));
+    }
+    EXPECT_EQ(pool.blocksInUse(), 100u);
+    EXPECT_EQ((*objects[42])[2], 42);
+    std::weak_ptr<std::vector<int>> weak = objects.front();
+    objects.clear();
+    EXPECT_EQ(pool.blocksInUse(), 1u); // weak_ptr 还引用着控制块
+    weak.reset();
+    EXPECT_EQ(pool.blocksInUse(), 0u);
+}
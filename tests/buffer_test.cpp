@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "net/Buffer.hpp"
+#include "net/EventLoop.hpp"
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace net;
+
+// 测试剩余空间放不下的数据经调用方的 scratch 追加，且存储按初始容量首次分配
+TEST(BufferTest, ReadFdWithScratch)
+{
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    const std::string message(3000, 'x');
+    ASSERT_EQ(write(fds[1], message.data(), message.size()), static_cast<ssize_t>(message.size()));
+
+    Buffer buffer;
+    buffer.setInitialSize(4096);
+    char scratch[1024];
+    int savedErrno = 0;
+    ASSERT_EQ(buffer.readFd(fds[0], &savedErrno, scratch, sizeof(scratch)), 1024);
+    EXPECT_GE(buffer.capacity(), 4096u);
+    ASSERT_EQ(buffer.readFd(fds[0], &savedErrno, scratch, sizeof(scratch)), static_cast<ssize_t>(message.size() - 1024));
+    EXPECT_EQ(buffer.retrieveAllAsString(), message);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// 测试空闲收缩：有未读数据时只保留刚好的容量，读空后整块释放
+TEST(BufferTest, Shrink)
+{
+    Buffer buffer;
+    buffer.append(std::string(100000, 'a'));
+    buffer.retrieve(99990);
+    buffer.shrink();
+    EXPECT_LT(buffer.capacity(), 100u);
+    EXPECT_EQ(buffer.retrieveAllAsString(), std::string(10, 'a'));
+    buffer.shrink();
+    EXPECT_EQ(buffer.capacity(), 0u);
+    buffer.append("again", 5);
+    EXPECT_EQ(buffer.retrieveAllAsString(), "again");
+}
+
+// 测试接收缓冲区提示值跟随消息大小，并限制在读溢出区大小以内
+TEST(BufferTest, ReceiveBufferHint)
+{
+    EventLoop loop;
+    for (int i = 0; i < 100; ++i)
+    {
+        loop.recordReceived(3000);
+    }
+    EXPECT_EQ(loop.receiveBufferHint(), 4096u);
+    for (int i = 0; i < 100; ++i)
+    {
+        loop.recordReceived(10 * 1024 * 1024);
+    }
+    EXPECT_EQ(loop.receiveBufferHint(), EventLoop::kReadScratchSize);
+    for (int i = 0; i < 100; ++i)
+    {
+        loop.recordReceived(10);
+    }
+    EXPECT_EQ(loop.receiveBufferHint(), EventLoop::kMinReceiveBufferHint);
+}
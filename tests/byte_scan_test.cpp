@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "base/ByteScan.hpp"
+#include "net/Buffer.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+
+using namespace base;
+
+namespace
+{
+    // 参考实现
+    const char *referenceFind(const char *begin, const char *end, const char *pattern, size_t len)
+    {
+        return std::search(begin, end, pattern, pattern + len);
+    }
+}
+
+// 随机数据上各实现与参考实现逐一比对：字符集偏向分隔符，长度和起点覆盖向量边界和尾部
+TEST(ByteScanTest, RandomizedMatchesScalar)
+{
+    static const char kAlphabet[] = "\r\n$ :a\r\n";
+    static const char kSets[][4] = {"$", "\r\n", ":; ", "$\r\n"};
+    std::mt19937 rng(20261017);
+    std::uniform_int_distribution<size_t> pick(0, sizeof(kAlphabet) - 2);
+    std::uniform_int_distribution<int> sparse(0, 9);
+    const scan::Isa isas[] = {scan::Isa::kScalar, scan::Isa::kSse2, scan::Isa::kAvx2};
+
+    for (int round = 0; round < 20000; ++round)
+    {
+        const size_t len = rng() % 200;
+        std::string data(len, 'x');
+        for (char &c : data)
+        {
+            // 一部分轮次分隔符稀疏，让向量循环跑满几轮
+            if (round % 2 == 0 || sparse(rng) == 0)
+            {
+                c = kAlphabet[pick(rng)];
+            }
+        }
+        const size_t offset = len == 0 ? 0 : rng() % (len + 1);
+        const char *begin = data.data() + offset;
+        const char *end = data.data() + len;
+        const char *set = kSets[round % 4];
+        const size_t setSize = std::char_traits<char>::length(set);
+
+        const char *crlf = referenceFind(begin, end, "\r\n", 2);
+        const char *header = referenceFind(begin, end, "\r\n\r\n", 4);
+        const char *any = std::find_first_of(begin, end, set, set + setSize);
+        for (scan::Isa isa : isas)
+        {
+            const scan::Ops &ops = scan::ops(isa);
+            ASSERT_EQ(ops.findCRLF(begin, end), crlf) << "isa " << static_cast<int>(isa) << " len " << len;
+            ASSERT_EQ(ops.findCRLFCRLF(begin, end), header) << "isa " << static_cast<int>(isa) << " len " << len;
+            ASSERT_EQ(ops.findAnyOf(begin, end, set, setSize), any) << "isa " << static_cast<int>(isa) << " len " << len;
+        }
+        ASSERT_EQ(scan::findByte(begin, end, '$'), std::find(begin, end, '$'));
+    }
+}
+
+// 测试 Buffer 上的查找接口：找不到返回 nullptr，可从指定位置继续
+TEST(ByteScanTest, BufferFind)
+{
+    net::Buffer buffer;
+    EXPECT_EQ(buffer.findCRLF(), nullptr);
+    buffer.append(std::string("$\x01\x00\x04rtpx"
+                              "OPTIONS rtsp://host/a RTSP/1.0\r\nCSeq: 1\r\n\r\ntail",
+                              55));
+    EXPECT_EQ(buffer.findByte('$'), buffer.peek());
+    EXPECT_EQ(buffer.findByte(buffer.peek() + 1, '$'), nullptr);
+    const char *line = buffer.findCRLF();
+    ASSERT_NE(line, nullptr);
+    EXPECT_EQ(std::string(buffer.peek() + 8, line), "OPTIONS rtsp://host/a RTSP/1.0");
+    const char *header = buffer.findCRLFCRLF();
+    ASSERT_NE(header, nullptr);
+    EXPECT_EQ(std::string(header + 4, buffer.peek() + buffer.readableBytes()), "tail");
+    EXPECT_EQ(buffer.findCRLF(header + 4), nullptr);
+    EXPECT_EQ(buffer.findAnyOf(line, ":", 1), line + 6);
+    EXPECT_EQ(buffer.findAnyOf(header + 4, "#", 1), nullptr);
+}
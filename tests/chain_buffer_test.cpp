@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "net/ChainBuffer.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace net;
+
+// 测试跨 slab 追加、部分取出，以及取空的 slab 归还内存池
+TEST(ChainBufferTest, AppendAndRetrieve)
+{
+    base::BlockPool pool;
+    ChainBuffer buffer(&pool);
+    std::string frame(ChainBuffer::kSlabSize * 2 + 100, 'a');
+    buffer.append("head", 4);
+    buffer.append(frame.data(), frame.size());
+    EXPECT_EQ(buffer.readableBytes(), frame.size() + 4);
+    EXPECT_EQ(buffer.slabCount(), 3u);
+    EXPECT_EQ(pool.blocksInUse(), 3u);
+
+    buffer.retrieve(ChainBuffer::kSlabSize + 10);
+    EXPECT_EQ(buffer.slabCount(), 2u);
+    EXPECT_EQ(pool.blocksInUse(), 2u);
+    buffer.retrieveAll();
+    EXPECT_EQ(buffer.readableBytes(), 0u);
+    EXPECT_EQ(pool.blocksInUse(), 0u);
+}
+
+// 测试 writev 按顺序写出多个 slab，并遵守 maxBytes
+TEST(ChainBufferTest, WriteFd)
+{
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    base::BlockPool pool;
+    std::string expected;
+    {
+        ChainBuffer buffer(&pool);
+        for (int i = 0; i < 5000; ++i)
+        {
+            std::string piece = std::to_string(i) + ",";
+            expected += piece;
+            buffer.append(piece.data(), piece.size());
+        }
+        buffer.retrieve(2); // "0," 已发出
+        expected.erase(0, 2);
+
+        int savedErrno = 0;
+        ASSERT_EQ(buffer.writeFd(fds[0], &savedErrno, 100), 100);
+        ssize_t n = buffer.writeFd(fds[0], &savedErrno);
+        ASSERT_EQ(static_cast<size_t>(n) + 100, expected.size());
+        EXPECT_EQ(buffer.readableBytes(), 0u);
+        EXPECT_EQ(pool.blocksInUse(), 0u);
+    }
+
+    std::string received(expected.size(), '\0');
+    size_t got = 0;
+    while (got < received.size())
+    {
+        ssize_t n = read(fds[1], &received[got], received.size() - got);
+        ASSERT_GT(n, 0);
+        got += static_cast<size_t>(n);
+    }
+    EXPECT_EQ(received, expected);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// 测试文件区间与内存数据按序发出，文件用 sendfile、管道用 splice；文件不够长时返回 EIO
+TEST(ChainBufferTest, FileSegments)
+{
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    FILE *file = tmpfile();
+    ASSERT_NE(file, nullptr);
+    const std::string content = "0123456789abcdef";
+    ASSERT_EQ(fwrite(content.data(), 1, content.size(), file), content.size());
+    fflush(file);
+    int pipeFds[2];
+    ASSERT_EQ(pipe(pipeFds), 0);
+    ASSERT_EQ(write(pipeFds[1], "pipe", 4), 4);
+
+    base::BlockPool pool;
+    ChainBuffer buffer(&pool);
+    buffer.append("head,", 5);
+    buffer.appendFile(fileno(file), 10, 6);
+    buffer.appendFile(pipeFds[0], 0, 4);
+    buffer.append(",tail", 5);
+    const std::string expected = "head,abcdefpipe,tail";
+    EXPECT_EQ(buffer.readableBytes(), expected.size());
+
+    int savedErrno = 0;
+    while (buffer.readableBytes() > 0)
+    {
+        ASSERT_GT(buffer.writeFd(fds[0], &savedErrno), 0);
+    }
+    std::string received(expected.size(), '\0');
+    size_t got = 0;
+    while (got < received.size())
+    {
+        ssize_t n = read(fds[1], &received[got], received.size() - got);
+        ASSERT_GT(n, 0);
+        got += static_cast<size_t>(n);
+    }
+    EXPECT_EQ(received, expected);
+    EXPECT_EQ(pool.blocksInUse(), 0u);
+
+    buffer.appendFile(fileno(file), 10, 100);
+    ASSERT_EQ(buffer.writeFd(fds[0], &savedErrno), 6);
+    EXPECT_EQ(buffer.writeFd(fds[0], &savedErrno), -1);
+    EXPECT_EQ(savedErrno, EIO);
+
+    fclose(file);
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+    close(fds[0]);
+    close(fds[1]);
+}
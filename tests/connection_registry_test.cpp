@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "net/ConnectionRegistry.hpp"
+#include "net/EventLoop.hpp"
+#include "net/InetAddress.hpp"
+#include "net/TcpConnection.hpp"
+#include "net/TcpServer.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace net;
+
+// 测试插入、查找、删除、槽位复用以及过期 ID 查不到新值
+TEST(ConnectionRegistryTest, SlotTable)
+{
+    SlotTable<std::shared_ptr<int>> table(3);
+    ConnectionId a = table.insert(std::make_shared<int>(1));
+    ConnectionId b = table.insert(std::make_shared<int>(2));
+    EXPECT_EQ(table.size(), 2u);
+    EXPECT_EQ(SlotTable<std::shared_ptr<int>>::loopOf(a), 3);
+    EXPECT_NE(a, b);
+    ASSERT_NE(table.find(b), nullptr);
+    EXPECT_EQ(**table.find(b), 2);
+
+    std::shared_ptr<int> removed = table.erase(a);
+    ASSERT_TRUE(removed);
+    EXPECT_EQ(*removed, 1);
+    EXPECT_EQ(table.find(a), nullptr);
+    EXPECT_FALSE(table.erase(a));
+
+    // 复用刚释放的槽位，但代数不同
+    ConnectionId c = table.insert(std::make_shared<int>(3));
+    EXPECT_EQ(SlotTable<std::shared_ptr<int>>::slotOf(c), SlotTable<std::shared_ptr<int>>::slotOf(a));
+    EXPECT_NE(c, a);
+    EXPECT_EQ(table.find(a), nullptr);
+    EXPECT_EQ(**table.find(c), 3);
+    EXPECT_EQ(table.capacity(), 2u);
+
+    // 其他 loop 的 ID 不会命中
+    EXPECT_EQ(table.find(SlotTable<std::shared_ptr<int>>::makeId(4, 0, 1)), nullptr);
+
+    int sum = 0;
+    table.forEach([&sum](ConnectionId, const std::shared_ptr<int> &value)
+                  { sum += *value; });
+    EXPECT_EQ(sum, 5);
+}
+
+// 测试服务端连接的 ID 编码所在 loop，名字按需由 ID 拼出
+TEST(ConnectionRegistryTest, ServerConnectionIds)
+{
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(9885), "IdServer");
+    server.setThreadNum(2);
+
+    const int kClients = 6;
+    std::mutex mutex;
+    std::set<ConnectionId> ids;
+    std::set<std::string> names;
+    std::atomic<int> down{0};
+    server.setConnectionCallback([&](const TcpConnectionPtr &conn)
+                                 {
+        if (conn->connected())
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.insert(conn->id());
+            names.insert(conn->getName());
+            conn->shutdown();
+        }
+        else
+        {
+            down++;
+        } });
+    server.start();
+
+    std::thread clientThread([&]()
+                             {
+        for (int i = 0; i < kClients; ++i)
+        {
+            int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(9885);
+            inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+            if (connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+            {
+                char c;
+                recv(sockfd, &c, 1, 0); // 等服务端关闭
+            }
+            close(sockfd);
+        } });
+
+    loop.runEvery(0.02, [&]()
+                  {
+                      if (down.load() == kClients)
+                      {
+                          loop.quit();
+                      } });
+    loop.runAfter(5.0, [&]()
+                  { loop.quit(); });
+    loop.loop();
+    clientThread.join();
+
+    EXPECT_EQ(down.load(), kClients);
+    std::set<uint16_t> loops;
+    for (ConnectionId id : ids)
+    {
+        loops.insert(ConnectionRegistry::loopOf(id));
+    }
+    EXPECT_EQ(loops, (std::set<uint16_t>{0, 1}));
+    ASSERT_FALSE(names.empty());
+    EXPECT_EQ(names.begin()->rfind("IdServer-0.0.0.0:9885#", 0), 0u);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "net/EventLoopStats.hpp"
+#include "net/EventLoopThreadPool.hpp"
+#include "net/EventLoop.hpp"
+#include <atomic>
+#include <thread>
+
+using namespace net;
+
+// 测试对数-线性直方图的分桶边界与分位数
+TEST(EventLoopStatsTest, HistogramBuckets)
+{
+    const uint64_t values[] = {0, 1, 3, 4, 7, 8, 9, 15, 16, 1000, 123456, 1ull << 40, ~0ull};
+    for (uint64_t value : values)
+    {
+        int bucket = LatencyHistogram::bucketOf(value);
+        ASSERT_LT(bucket, LatencyHistogram::kBuckets);
+        EXPECT_LE(value, LatencyHistogram::bucketUpperBound(bucket));
+        if (bucket > 0)
+        {
+            EXPECT_GT(value, LatencyHistogram::bucketUpperBound(bucket - 1));
+        }
+    }
+
+    LatencyHistogram histogram;
+    for (uint64_t i = 1; i <= 1000; ++i)
+    {
+        ++histogram.buckets[LatencyHistogram::bucketOf(i * 1000)];
+    }
+    EXPECT_EQ(histogram.count(), 1000u);
+    uint64_t p50 = histogram.percentile(0.5);
+    EXPECT_GE(p50, 500000u);
+    EXPECT_LE(p50, 500000u * 5 / 4); // 相对误差不超过 25%
+    EXPECT_GE(histogram.percentile(1.0), 1000000u);
+}
+
+// 测试各 loop 的统计可在其他线程读取并在线程池中累加
+TEST(EventLoopStatsTest, PoolAggregation)
+{
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop, "StatsPool");
+    pool.setThreadNum(2);
+    pool.start();
+
+    std::atomic<int> done(0);
+    const int kTasks = 200;
+    for (EventLoop *loop : pool.getAllLoops())
+    {
+        loop->runAfter(0.001, [&done]()
+                       { done++; });
+        for (int i = 0; i < kTasks; ++i)
+        {
+            loop->queueInLoop([&done]()
+                              { done++; });
+        }
+    }
+    while (done.load() < 2 * (kTasks + 1))
+    {
+        std::this_thread::yield();
+    }
+    // 最后一个任务执行完到本轮统计写入之间还有一小段时间
+    EventLoopStats stats;
+    for (int i = 0; i < 1000 && stats.functors < 2 * kTasks; ++i)
+    {
+        stats = pool.stats();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ(stats.loops, 2);
+    EXPECT_GE(stats.functors, 2 * kTasks); // 跨线程添加定时器也算一个任务
+    EXPECT_GT(stats.iterations, 0);
+    EXPECT_GT(stats.wakeups, 0);
+    EXPECT_GT(stats.timerNanos, 0);
+    EXPECT_EQ(stats.iterationNanos.count(), static_cast<uint64_t>(stats.iterations));
+}
@@ -5,6 +5,8 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 using namespace net;
 
@@ -74,4 +76,64 @@ TEST(EventLoopTest, Channel)
     close(pipefd[0]);
     close(pipefd[1]);
     EXPECT_TRUE(readTriggered);
-}
\ No newline at end of file
+}
+// 测试 timerfd 驱动的重复定时器与取消
+TEST(EventLoopTest, RepeatAndCancelTimer)
+{
+    EventLoop loop;
+    std::atomic<int> repeatCount(0);
+    std::atomic<int> cancelledCount(0);
+
+    TimerId cancelled = loop.runAfter(0.05, [&cancelledCount]()
+                                      { cancelledCount++; });
+    TimerId repeat = loop.runEvery(0.0005, [&repeatCount]() { // 亚毫秒周期
+        repeatCount++;
+    });
+    loop.cancel(cancelled);
+    loop.runAfter(0.1, [&]()
+                  {
+        loop.cancel(repeat);
+        loop.quit(); });
+    loop.loop();
+
+    EXPECT_EQ(cancelledCount, 0);
+    EXPECT_GT(repeatCount, 10);
+}
+// 测试同一轮内相互抵消的关注事件变更不会提交给 poller，最终状态仍然生效
+TEST(EventLoopTest, CoalescedChannelUpdates)
+{
+    EventLoop loop;
+    int fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    Channel channel(&loop, fd);
+    int writeCount = 0;
+    channel.setWriteCallback([&]()
+                             {
+        ++writeCount;
+        channel.disableWriting();
+        loop.quit(); });
+    channel.enableReading();
+
+    int64_t avoided = 0;
+    loop.runAfter(0.01, [&]()
+                  {
+        int64_t before = loop.avoidedPollerUpdates();
+        for (int i = 0; i < 4; ++i)
+        {
+            channel.enableWriting();
+            channel.disableWriting();
+        }
+        avoided = loop.avoidedPollerUpdates() - before; });
+    loop.runAfter(0.05, [&]()
+                  {
+        EXPECT_EQ(writeCount, 0); // 写事件从未提交，eventfd 虽可写也不会触发
+        channel.enableWriting(); });
+    loop.runAfter(1.0, [&]()
+                  { loop.quit(); });
+    loop.loop();
+
+    EXPECT_EQ(avoided, 8);
+    EXPECT_EQ(writeCount, 1);
+    channel.disableAll();
+    channel.remove();
+    close(fd);
+}
@@ -2,6 +2,13 @@
 #include "net/EventLoopThreadPool.hpp"
 #include "net/EventLoop.hpp"
 #include <unordered_set>
+#include <sched.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <future>
 #include <thread>
 #include <chrono>
 
@@ -72,4 +79,122 @@ TEST(EventLoopThreadPoolTest, ThreadInitCallback)
     // 等待回调执行
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
     EXPECT_EQ(callbackCount, 2); // 2个线程，回调执行2次
-}
\ No newline at end of file
+}
+
+// 测试各放置策略选出的 CPU，以及 IO 线程绑核后统计中报告的 CPU / 节点
+TEST(EventLoopThreadPoolTest, ThreadPlacement)
+{
+    const CpuTopology &topology = CpuTopology::instance();
+    ASSERT_GT(topology.numCpus(), 0);
+    const auto &nodes = topology.nodes();
+    EXPECT_EQ(ThreadPlacement().cpuFor(0), -1);
+    EXPECT_EQ(ThreadPlacement::compact().cpuFor(0), nodes[0][0]);
+    EXPECT_EQ(ThreadPlacement::compact().cpuFor(topology.numCpus()), nodes[0][0]);
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(topology.nodeOf(ThreadPlacement::spread().cpuFor(i)), topology.nodeIds()[i % nodes.size()]);
+    }
+    EXPECT_EQ(ThreadPlacement::cpuList({nodes[0][0]}).cpuFor(3), nodes[0][0]);
+
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop, "PoolPlacement");
+    pool.setThreadNum(2);
+    pool.setThreadPlacement(ThreadPlacement::compact());
+    pool.start();
+    std::vector<EventLoop *> loops = pool.getAllLoops();
+    std::vector<EventLoopStats> perLoop = pool.statsPerLoop();
+    ASSERT_EQ(perLoop.size(), 2u);
+    for (size_t i = 0; i < loops.size(); ++i)
+    {
+        const int expected = ThreadPlacement::compact().cpuFor(static_cast<int>(i));
+        EXPECT_EQ(perLoop[i].cpu, expected);
+        EXPECT_EQ(perLoop[i].numaNode, topology.nodeOf(expected));
+        std::promise<int> running;
+        loops[i]->runInLoop([&running]()
+                            { running.set_value(sched_getcpu()); });
+        EXPECT_EQ(running.get_future().get(), expected);
+    }
+}
+
+// 测试 nodeOf 报告 sysfs 中的实际节点号：没有允许 CPU 的节点被跳过，节点号不连续
+TEST(EventLoopThreadPoolTest, TopologySparseNodeIds)
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    int cpu = 0;
+    while (cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &allowed))
+    {
+        ++cpu;
+    }
+    ASSERT_LT(cpu, CPU_SETSIZE);
+
+    char dirTemplate[] = "/tmp/topologyXXXXXX";
+    ASSERT_NE(mkdtemp(dirTemplate), nullptr);
+    const std::string root = dirTemplate;
+    auto writeNode = [&root](const std::string &node, const std::string &cpulist)
+    {
+        mkdir((root + "/" + node).c_str(), 0755);
+        std::ofstream(root + "/" + node + "/cpulist") << cpulist << "\n";
+    };
+    writeNode("node0", std::to_string(CPU_SETSIZE + 1)); // 没有允许的 CPU
+    writeNode("node3", std::to_string(cpu));
+
+    CpuTopology topology(root);
+    ASSERT_EQ(topology.nodes().size(), 1u);
+    EXPECT_EQ(topology.nodeIds(), std::vector<int>{3});
+    EXPECT_EQ(topology.nodeOf(cpu), 3);
+    EXPECT_EQ(topology.nodeOf(-1), -1);
+
+    for (const char *node : {"node0", "node3"})
+    {
+        unlink((root + "/" + node + "/cpulist").c_str());
+        rmdir((root + "/" + node).c_str());
+    }
+    rmdir(root.c_str());
+}
+
+// 测试按负载挑选 loop 的内置策略和自定义策略
+TEST(EventLoopThreadPoolTest, LoadBalance)
+{
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop, "PoolBalance");
+    pool.setThreadNum(3);
+    pool.start();
+    std::vector<EventLoop *> loops = pool.getAllLoops();
+
+    pool.setLoadBalance(EventLoopThreadPool::LoadBalance::kLeastConnections);
+    loops[0]->load().connectionOpened();
+    loops[0]->load().connectionOpened();
+    loops[1]->load().connectionOpened();
+    EXPECT_EQ(pool.getNextLoop(), loops[2]);
+    loops[2]->load().connectionOpened();
+    EXPECT_NE(pool.getNextLoop(), loops[0]);
+
+    // loop 0 上产生流量，等速率在下一轮 tick 中更新
+    loops[0]->runInLoop([&loops]()
+                        { loops[0]->load().addBytes(10 * 1000 * 1000); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    std::promise<void> ticked;
+    loops[0]->runInLoop([&ticked]()
+                        { ticked.set_value(); });
+    ticked.get_future().wait();
+    EXPECT_GT(loops[0]->load().bytesPerSecond(), 0.0);
+    EXPECT_GT(pool.stats().bytesPerSecond, 0.0);
+    EXPECT_EQ(pool.stats().connections, 4);
+
+    pool.setLoadBalance(EventLoopThreadPool::LoadBalance::kPowerOfTwoChoices);
+    for (int i = 0; i < 20; ++i)
+    {
+        EXPECT_NE(pool.getNextLoop(), loops[0]); // 任意两个里至少有一个比 loop 0 轻
+    }
+    pool.setLoadBalance(EventLoopThreadPool::LoadBalance::kLeastBytesPerSecond);
+    EXPECT_NE(pool.getNextLoop(), loops[0]);
+
+    pool.setLoadBalance(EventLoopThreadPool::LoadBalance::kHash);
+    EXPECT_EQ(pool.getNextLoop(101), pool.getLoopForHash(101));
+
+    pool.setLoopChooser([](const std::vector<EventLoop *> &candidates, size_t)
+                        { return candidates.back(); });
+    EXPECT_EQ(pool.getNextLoop(), loops[2]);
+}
@@ -50,4 +50,12 @@ TEST(InetAddressTest, SockAddrConversion)
     InetAddress addr;
     addr.setSockAddr(reinterpret_cast<sockaddr *>(&rawAddr), sizeof(rawAddr));
     EXPECT_EQ(addr.toIpPort(), "10.0.0.1:5678");
-}
\ No newline at end of file
+}
+// 测试 ipHash 只取决于 IP：同一 IP 不同端口相同，不同 IP 不同
+TEST(InetAddressTest, IpHash)
+{
+    EXPECT_EQ(InetAddress("10.0.0.1", 1000).ipHash(), InetAddress("10.0.0.1", 2000).ipHash());
+    EXPECT_NE(InetAddress("10.0.0.1", 1000).ipHash(), InetAddress("10.0.0.2", 1000).ipHash());
+    EXPECT_EQ(InetAddress("::1", 1000, true).ipHash(), InetAddress("::1", 2000, true).ipHash());
+    EXPECT_NE(InetAddress("::1", 1000, true).ipHash(), InetAddress("::2", 1000, true).ipHash());
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "base/InlineFunction.hpp"
+#include "net/EventLoop.hpp"
+#include "net/EventLoopThread.hpp"
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+
+// 替换全局 operator new，按线程统计堆分配次数
+namespace
+{
+    thread_local size_t gAllocations = 0;
+}
+
+void *operator new(size_t size)
+{
+    ++gAllocations;
+    if (void *p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+// 测试小捕获内联存储、大捕获退化为一次堆分配以及移动语义
+TEST(InlineFunctionTest, InlineAndHeapStorage)
+{
+    int value = 0;
+    size_t before = gAllocations;
+    base::InlineFunction<void()> small([&value]()
+                                       { value += 1; });
+    EXPECT_TRUE(small.isInline());
+    small();
+    EXPECT_EQ(gAllocations, before);
+
+    std::array<char, 128> big{};
+    big[0] = 41;
+    before = gAllocations;
+    base::InlineFunction<int(int)> large([big](int x)
+                                         { return big[0] + x; });
+    EXPECT_FALSE(large.isInline());
+    EXPECT_EQ(gAllocations, before + 1);
+    EXPECT_EQ(large(1), 42);
+
+    base::InlineFunction<int(int)> moved(std::move(large));
+    EXPECT_FALSE(static_cast<bool>(large));
+    EXPECT_EQ(moved(2), 43);
+    EXPECT_EQ(gAllocations, before + 1);
+
+    // 只可移动的捕获
+    auto owned = std::make_unique<int>(7);
+    base::InlineFunction<int()> unique([p = std::move(owned)]()
+                                       { return *p; });
+    EXPECT_EQ(unique(), 7);
+
+    std::function<void()> empty;
+    base::InlineFunction<void()> fromEmpty(empty);
+    EXPECT_FALSE(static_cast<bool>(fromEmpty));
+    EXPECT_THROW(fromEmpty(), std::bad_function_call);
+}
+
+// 测试 loop 线程内 runInLoop 以及稳定状态下跨线程 queueInLoop 不分配内存
+TEST(InlineFunctionTest, EventLoopPostWithoutAllocation)
+{
+    net::EventLoopThread loopThread;
+    net::EventLoop *loop = loopThread.startLoop();
+    std::atomic<int> done(0);
+    const int kBatch = 100;
+
+    auto postBatch = [&]()
+    {
+        int target = done.load() + kBatch;
+        for (int i = 0; i < kBatch; ++i)
+        {
+            loop->queueInLoop([&done]()
+                              { done.fetch_add(1); });
+        }
+        while (done.load() < target)
+        {
+            std::this_thread::yield();
+        }
+    };
+
+    postBatch(); // 预热：首次投递到该 loop 时建立本线程的节点缓存
+    size_t before = gAllocations;
+    postBatch();
+    postBatch();
+    EXPECT_EQ(gAllocations, before);
+
+    std::atomic<bool> ran(false);
+    size_t inLoopAllocations = 0;
+    int hits = 0;
+    loop->runInLoop([&]()
+                    {
+                        size_t start = gAllocations;
+                        for (int i = 0; i < kBatch; ++i)
+                        {
+                            loop->runInLoop([&hits]()
+                                            { ++hits; });
+                        }
+                        inLoopAllocations = gAllocations - start;
+                        ran = true; });
+    while (!ran.load())
+    {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(hits, kBatch);
+    EXPECT_EQ(inLoopAllocations, 0u);
+    loopThread.stopLoop();
+}
@@ -0,0 +1,495 @@
+#include <gtest/gtest.h>
+#include "net/TcpServer.hpp"
+#include "net/Acceptor.hpp"
+#include "net/Channel.hpp"
+#include "net/EventLoop.hpp"
+#include "net/InetAddress.hpp"
+#include "net/TcpConnection.hpp"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace net;
+
+namespace
+{
+    bool ioUringAvailable()
+    {
+        EventLoop loop(PollerBackend::kIoUring);
+        return std::string(loop.pollerName()) == "io_uring";
+    }
+
+    // 客户端发送 total 字节并收回回显，返回收到的字节数，内容不符时置 mismatch
+    size_t echoClient(uint16_t port, size_t total, std::atomic<bool> &mismatch)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+
+        std::thread writer([sockfd, total]()
+                           {
+            std::vector<char> chunk(100 * 1000);
+            size_t sent = 0;
+            while (sent < total)
+            {
+                for (size_t i = 0; i < chunk.size(); ++i)
+                {
+                    chunk[i] = static_cast<char>((sent + i) % 251);
+                }
+                ssize_t n = send(sockfd, chunk.data(), std::min(chunk.size(), total - sent), 0);
+                if (n <= 0)
+                {
+                    break;
+                }
+                sent += static_cast<size_t>(n);
+            } });
+
+        size_t received = 0;
+        std::vector<char> buf(64 * 1024);
+        while (received < total)
+        {
+            ssize_t n = recv(sockfd, buf.data(), buf.size(), 0);
+            if (n <= 0)
+            {
+                break;
+            }
+            for (ssize_t i = 0; i < n; ++i)
+            {
+                if (buf[i] != static_cast<char>((received + i) % 251))
+                {
+                    mismatch = true;
+                }
+            }
+            received += static_cast<size_t>(n);
+        }
+        writer.join();
+        close(sockfd);
+        return received;
+    }
+
+    int connectTo(uint16_t port)
+    {
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        return sockfd;
+    }
+
+    // 通过完成式写把 payload 从 socketpair 的一端发出，poller 直接提交 sendmsg
+    struct CompletedWriter
+    {
+        explicit CompletedWriter(EventLoop *loop, size_t size)
+            : payload(std::make_shared<std::string>(size, '\0'))
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                (*payload)[i] = static_cast<char>(i % 251);
+            }
+            socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds);
+            channel.reset(new Channel(loop, fds[0]));
+            channel->setCompletedWriteSource([this](struct iovec *vec, int, int *)
+                                             {
+                                                 offered = payload->size() - offset;
+                                                 if (offered == 0)
+                                                 {
+                                                     return 0;
+                                                 }
+                                                 vec[0].iov_base = &(*payload)[offset];
+                                                 vec[0].iov_len = offered;
+                                                 return 1; },
+                                             payload);
+            channel->setWriteCallback([this]()
+                                      {
+                                          if (!channel->hasCompletedWrite())
+                                          {
+                                              return;
+                                          }
+                                          const int result = channel->completedWriteResult();
+                                          ASSERT_GT(result, 0);
+                                          ++completions;
+                                          if (static_cast<size_t>(result) < offered)
+                                          {
+                                              ++partial;
+                                          }
+                                          offset += static_cast<size_t>(result);
+                                          if (onCompletion)
+                                          {
+                                              onCompletion();
+                                          } });
+        }
+        ~CompletedWriter()
+        {
+            if (channel->isWriting())
+            {
+                channel->disableAll();
+                channel->remove();
+            }
+            close(fds[0]);
+            close(fds[1]);
+        }
+
+        std::shared_ptr<std::string> payload;
+        int fds[2];
+        std::unique_ptr<Channel> channel;
+        size_t offset = 0;
+        size_t offered = 0;
+        int completions = 0;
+        int partial = 0;
+        std::function<void()> onCompletion;
+    };
+
+    // 在 io_uring loop 上跑一次回显，检查数据完整并且对端关闭能被感知
+    void runEcho(uint16_t port, bool edgeTriggered)
+    {
+        EventLoop loop(PollerBackend::kIoUring);
+        ASSERT_STREQ(loop.pollerName(), "io_uring");
+        InetAddress listenAddr(port);
+        TcpServer server(&loop, listenAddr, "IoUringEchoServer");
+        server.setEdgeTriggered(edgeTriggered, 64 * 1024);
+        std::atomic<int> closed{0};
+        server.setConnectionCallback([&](const TcpConnectionPtr &conn)
+                                     {
+            if (!conn->connected())
+            {
+                closed++;
+            } });
+        server.setMessageCallback([](const TcpConnectionPtr &conn, Buffer *buf, base::Timestamp)
+                                  { conn->send(buf); });
+        server.start();
+
+        const size_t kTotal = 8 * 1024 * 1024;
+        std::atomic<bool> mismatch{false};
+        std::atomic<size_t> received{0};
+        std::thread clientThread([&]()
+                                 { received = echoClient(port, kTotal, mismatch); });
+
+        loop.runEvery(0.05, [&]()
+                      {
+                          if (closed > 0 || mismatch)
+                          {
+                              loop.quit();
+                          } });
+        loop.runAfter(10.0, [&]()
+                      { loop.quit(); });
+        loop.loop();
+        clientThread.join();
+
+        EXPECT_FALSE(mismatch);
+        EXPECT_EQ(received.load(), kTotal);
+        EXPECT_EQ(closed.load(), 1);
+    }
+}
+
+// 测试显式选择后端，不支持 io_uring 时回退到 epoll
+TEST(IoUringPollerTest, BackendSelection)
+{
+    EventLoop epollLoop(PollerBackend::kEpoll);
+    EXPECT_STREQ(epollLoop.pollerName(), "epoll");
+
+    EventLoop uringLoop(PollerBackend::kIoUring);
+    const std::string name = uringLoop.pollerName();
+    EXPECT_TRUE(name == "io_uring" || name == "epoll");
+}
+
+// 测试水平触发下多发 recv 收数据的回显
+TEST(IoUringPollerTest, LevelTriggeredEcho)
+{
+    if (!ioUringAvailable())
+    {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+    runEcho(9890, false);
+}
+
+// 测试边沿触发下多发 poll 驱动写、多发 recv 驱动读的回显
+TEST(IoUringPollerTest, EdgeTriggeredEcho)
+{
+    if (!ioUringAvailable())
+    {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+    runEcho(9891, true);
+}
+
+// 测试 io_uring loop 上的定时器与跨线程任务
+TEST(IoUringPollerTest, TimersAndCrossThreadTasks)
+{
+    if (!ioUringAvailable())
+    {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+    EventLoop loop(PollerBackend::kIoUring);
+    std::atomic<int> tasks{0};
+    int ticks = 0;
+    loop.runEvery(0.01, [&]()
+                  { ++ticks; });
+    std::thread poster([&]()
+                       {
+        for (int i = 0; i < 100; ++i)
+        {
+            loop.queueInLoop([&]() { tasks++; });
+        } });
+    loop.runAfter(0.2, [&]()
+                  { loop.quit(); });
+    loop.loop();
+    poster.join();
+
+    EXPECT_EQ(tasks.load(), 100);
+    EXPECT_GE(ticks, 5);
+}
+
+// 测试多发 accept 一次交出的连接按 acceptBatch 分批交付，剩余的排到下一轮
+TEST(IoUringPollerTest, MultishotAcceptHonoursBatch)
+{
+    if (!ioUringAvailable())
+    {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+    EventLoop loop(PollerBackend::kIoUring);
+    Acceptor acceptor(&loop, InetAddress(9892), false);
+    acceptor.setAcceptBatch(2);
+    std::vector<int> accepted;
+    acceptor.setNewConnectionCallback([&](int sockfd, const InetAddress &peerAddr)
+                                      {
+        EXPECT_NE(fcntl(sockfd, F_GETFL) & O_NONBLOCK, 0);
+        EXPECT_EQ(peerAddr.toIpPort().find("127.0.0.1:"), 0u); // 多发 accept 不带地址，由 getpeername 补上
+        accepted.push_back(sockfd); });
+    acceptor.listen();
+
+    std::vector<int> clients;
+    for (int i = 0; i < 5; ++i)
+    {
+        clients.push_back(connectTo(9892)); // 第一次 poll 提交 accept 时连接已在 backlog 中
+    }
+    loop.runEvery(0.01, [&]()
+                  {
+                      if (accepted.size() == clients.size())
+                      {
+                          loop.quit();
+                      } });
+    loop.runAfter(2.0, [&]()
+                  { loop.quit(); });
+    loop.loop();
+
+    AcceptStats stats = acceptor.stats();
+    EXPECT_EQ(accepted.size(), clients.size());
+    EXPECT_EQ(stats.accepted, 5);
+    EXPECT_EQ(stats.maxBatch, 2);
+    EXPECT_GE(stats.wakeups, 3);
+    for (int fd : accepted)
+    {
+        close(fd);
+    }
+    for (int fd : clients)
+    {
+        close(fd);
+    }
+}
+
+// 测试 Acceptor 析构时关闭已被内核接受、尚未交付的连接，排到下一轮的交付不再执行
+TEST(IoUringPollerTest, DestroyAcceptorWithPendingAccepts)
+{
+    if (!ioUringAvailable())
+    {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+    EventLoop loop(PollerBackend::kIoUring);
+    std::unique_ptr<Acceptor> acceptor(new Acceptor(&loop, InetAddress(9893), false));
+    acceptor->setAcceptBatch(1);
+    std::vector<int> accepted;
+    acceptor->setNewConnectionCallback([&](int sockfd, const InetAddress &)
+                                       {
+        accepted.push_back(sockfd);
+        loop.quit(); });
+    acceptor->listen();
+
+    std::vector<int> clients;
+    for (int i = 0; i < 5; ++i)
+    {
+        clients.push_back(connectTo(9893));
+    }
+    loop.runAfter(2.0, [&]()
+                  { loop.quit(); });
+    loop.loop();
+    acceptor.reset();
+    // 排队的交付任务在 Acceptor 析构后执行，应当直接跳过
+    loop.runAfter(0.05, [&]()
+                  { loop.quit(); });
+    loop.loop();
+
+    ASSERT_GE(accepted.size(), 1u);
+    EXPECT_LT(accepted.size(), clients.size());
+    int closedByServer = 0;
+    for (int fd : clients)
+    {
+        char c;
+        const ssize_t n = recv(fd, &c, 1, MSG_DONTWAIT);
+        if (n == 0 || (n < 0 && errno == ECONNRESET))
+        {
+            ++closedByServer;
+        }
+    }
+    EXPECT_EQ(static_cast<size_t>(closedByServer), clients.size() - accepted.size());
+    for (int fd : accepted)
+    {
+        close(fd);
+    }
+    for (int fd : clients)
+    {
+        close(fd);
+    }
+}
+
+// 测试 sendmsg 只写出一部分时按结果前移，剩余数据在后续提交中发完且内容不变
+TEST(IoUringPollerTest, SendmsgPartialCompletion)
+{
+    if (!ioUringAvailable())
+    {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+    EventLoop loop(PollerBackend::kIoUring);
+    ASSERT_TRUE(loop.completedWriteEnabled());
+    const size_t kTotal = 4 * 1024 * 1024;
+    CompletedWriter writer(&loop, kTotal);
+    writer.onCompletion = [&]()
+    {
+        if (writer.offset == kTotal)
+        {
+            writer.channel->disableAll();
+            writer.channel->remove();
+            loop.quit();
+        }
+    };
+
+    std::atomic<bool> mismatch{false};
+    std::atomic<size_t> received{0};
+    std::thread reader([&]()
+                       {
+        std::vector<char> buf(64 * 1024);
+        while (received < kTotal)
+        {
+            ssize_t n = recv(writer.fds[1], buf.data(), buf.size(), 0);
+            if (n < 0 && errno == EAGAIN)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+            if (n <= 0)
+            {
+                break;
+            }
+            for (ssize_t i = 0; i < n; ++i)
+            {
+                if (buf[i] != static_cast<char>((received + i) % 251))
+                {
+                    mismatch = true;
+                }
+            }
+            received += static_cast<size_t>(n);
+        } });
+
+    writer.channel->enableWriting();
+    loop.runAfter(5.0, [&]()
+                  { loop.quit(); });
+    loop.loop();
+    reader.join();
+
+    EXPECT_EQ(writer.offset, kTotal);
+    EXPECT_EQ(received.load(), kTotal);
+    EXPECT_FALSE(mismatch);
+    EXPECT_GT(writer.completions, 1);
+    EXPECT_GE(writer.partial, 1);
+}
+
+// 测试注销仍有发送在途的 channel：不阻塞 loop，数据所有者保留到取消后的完成事件到达
+TEST(IoUringPollerTest, RemoveChannelWithSendInFlight)
+{
+    if (!ioUringAvailable())
+    {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+    EventLoop loop(PollerBackend::kIoUring);
+    CompletedWriter writer(&loop, 4 * 1024 * 1024); // 对端不读，第一次部分写出后下一次发送挂起
+    std::weak_ptr<std::string> payload = writer.payload;
+    bool retainedAfterRemove = false;
+    writer.onCompletion = [&]()
+    {
+        if (writer.completions == 1)
+        {
+            loop.runAfter(0.05, [&]()
+                          {
+                              writer.channel->disableAll();
+                              writer.channel->remove();
+                              writer.payload.reset();
+                              retainedAfterRemove = !payload.expired(); });
+        }
+    };
+    writer.channel->enableWriting();
+    loop.runEvery(0.01, [&]()
+                  {
+                      if (writer.completions > 0 && !writer.channel->isWriting() && payload.expired())
+                      {
+                          loop.quit();
+                      } });
+    loop.runAfter(2.0, [&]()
+                  { loop.quit(); });
+    loop.loop();
+
+    EXPECT_EQ(writer.completions, 1);
+    EXPECT_TRUE(retainedAfterRemove);
+    EXPECT_TRUE(payload.expired());
+}
+
+// 测试 loop 析构时等待已注销 channel 的在途发送结束后再释放其数据
+TEST(IoUringPollerTest, DestroyLoopWithRetainedSend)
+{
+    if (!ioUringAvailable())
+    {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+    std::weak_ptr<std::string> payload;
+    bool retainedAfterRemove = false;
+    {
+        EventLoop loop(PollerBackend::kIoUring);
+        CompletedWriter writer(&loop, 4 * 1024 * 1024);
+        payload = writer.payload;
+        writer.onCompletion = [&]()
+        {
+            if (writer.completions == 1)
+            {
+                loop.runAfter(0.05, [&]()
+                              {
+                                  writer.channel->disableAll();
+                                  writer.channel->remove();
+                                  writer.payload.reset();
+                                  retainedAfterRemove = !payload.expired();
+                                  loop.quit(); // 取消请求尚未提交，loop 析构时处理
+                              });
+            }
+        };
+        writer.channel->enableWriting();
+        loop.runAfter(2.0, [&]()
+                      { loop.quit(); });
+        loop.loop();
+        EXPECT_TRUE(retainedAfterRemove);
+    }
+    EXPECT_TRUE(payload.expired());
+}
@@ -153,6 +153,31 @@ TEST(LoggerTest, FormatString)
     std::filesystem::remove(log_file);
 }
 
+// 测试宏参数引用调用方名为 logger_ 的变量时取到的是调用方的值
+TEST(LoggerTest, MacroArgumentNamedLogger)
+{
+    base::LoggerManager::instance().reset();
+
+    const std::string log_file = "test_macro_shadow.log";
+
+    auto logger = std::make_unique<base::SyncLogger>();
+    logger->add_sink(std::make_shared<base::FileSink>(log_file));
+    base::LoggerManager::instance().set_logger(std::move(logger));
+
+    const int logger_ = 7;
+    LOG_INFO("Caller logger_: %d", logger_);
+
+    base::LoggerManager::instance().get_logger()->flush();
+
+    std::ifstream file(log_file);
+    EXPECT_TRUE(file.is_open());
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    EXPECT_NE(content.find("Caller logger_: 7"), std::string::npos);
+
+    std::filesystem::remove(log_file);
+}
+
 // 测试多线程并发日志
 TEST(LoggerTest, MultiThreadConcurrency)
 {
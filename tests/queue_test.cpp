@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "base/Queue.hpp"
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Item : base::MpscNode
+    {
+        Item(int p, int s) : producer(p), seq(s) {}
+        int producer;
+        int seq;
+    };
+}
+
+// 测试单线程下的 FIFO 顺序
+TEST(MpscQueueTest, SingleThreadOrder)
+{
+    base::MpscQueue<Item> queue;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.pop(), nullptr);
+
+    Item a(0, 1), b(0, 2), c(0, 3);
+    queue.push(&a);
+    queue.push(&b);
+    EXPECT_FALSE(queue.empty());
+    EXPECT_EQ(queue.pop(), &a);
+    queue.push(&c);
+    EXPECT_EQ(queue.pop(), &b);
+    EXPECT_EQ(queue.pop(), &c);
+    EXPECT_EQ(queue.pop(), nullptr);
+    EXPECT_TRUE(queue.empty());
+}
+
+// 测试多生产者并发入队：不丢失元素，且每个生产者内部保持顺序
+TEST(MpscQueueTest, MultiProducer)
+{
+    const int kProducers = 4;
+    const int kItems = 20000;
+    base::MpscQueue<Item> queue;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p)
+    {
+        producers.emplace_back([&queue, p]()
+                               {
+            for (int i = 0; i < kItems; ++i)
+            {
+                queue.push(new Item(p, i));
+            } });
+    }
+
+    std::vector<int> next(kProducers, 0);
+    int received = 0;
+    while (received < kProducers * kItems)
+    {
+        Item *item = queue.pop();
+        if (item == nullptr)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT_EQ(item->seq, next[item->producer]);
+        next[item->producer] = item->seq + 1;
+        delete item;
+        ++received;
+    }
+    for (auto &t : producers)
+    {
+        t.join();
+    }
+    EXPECT_EQ(queue.pop(), nullptr);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "net/RingBuffer.hpp"
+#include <errno.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace net;
+
+// 测试可读数据跨过环尾时地址仍然连续，容量不变，也不搬移数据
+TEST(RingBufferTest, WrapsContiguously)
+{
+    RingBuffer ring(4096);
+    EXPECT_EQ(ring.capacity(), 0u);
+    ring.append(std::string(3000, 'a'));
+    const size_t capacity = ring.capacity();
+    ASSERT_GE(capacity, 4096u);
+    ring.retrieve(2900);
+    const std::string tail = std::string(100, 'a') + std::string(capacity - 102, 'b') + "\r\n";
+    ring.append(tail.substr(100));
+    EXPECT_EQ(ring.capacity(), capacity);
+    EXPECT_EQ(ring.writableBytes(), 0u);
+    EXPECT_EQ(ring.findCRLF(), ring.peek() + tail.size() - 2);
+    EXPECT_EQ(std::string(ring.peek(), ring.readableBytes()), tail);
+
+    // 读位置越过环尾后回到前一半，后续写入接着已有数据
+    ring.retrieve(tail.size() - 10);
+    ring.append("xyz", 3);
+    EXPECT_EQ(ring.retrieveAllAsString(), tail.substr(tail.size() - 10) + "xyz");
+}
+
+// 测试 readFd 超出剩余空间时扩容并保留未读数据，读空后 shrink 解除映射
+TEST(RingBufferTest, ReadFdGrowsAndShrink)
+{
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    const std::string message(6000, 'm');
+    ASSERT_EQ(write(fds[1], message.data(), message.size()), static_cast<ssize_t>(message.size()));
+
+    RingBuffer ring(4096);
+    ring.append("head", 4);
+    char scratch[8192];
+    int savedErrno = 0;
+    ASSERT_EQ(ring.readFd(fds[0], &savedErrno, scratch, sizeof(scratch)), static_cast<ssize_t>(message.size()));
+    EXPECT_GE(ring.capacity(), message.size() + 4);
+    ring.shrink();
+    EXPECT_GT(ring.capacity(), 0u);
+    EXPECT_EQ(ring.retrieveAllAsString(), "head" + message);
+    ring.shrink();
+    EXPECT_EQ(ring.capacity(), 0u);
+    ring.append("again", 5);
+    EXPECT_EQ(ring.retrieveAllAsString(), "again");
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// 测试映射失败（memfd_create 拿不到 fd）时 readFd 返回 -1 并带回 errno，append 返回 false 且已有数据不变
+TEST(RingBufferTest, MapFailureReported)
+{
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    ASSERT_EQ(write(fds[1], "data", 4), 4);
+
+    RingBuffer empty(4096);
+    RingBuffer ring(4096);
+    ASSERT_TRUE(ring.append("head", 4));
+    const size_t capacity = ring.capacity();
+
+    struct rlimit saved;
+    ASSERT_EQ(getrlimit(RLIMIT_NOFILE, &saved), 0);
+    struct rlimit limited = saved;
+    limited.rlim_cur = 0;
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &limited), 0);
+
+    char scratch[1024];
+    int savedErrno = 0;
+    const ssize_t n = empty.readFd(fds[0], &savedErrno, scratch, sizeof(scratch));
+    const int readErrno = savedErrno;
+    const bool appended = ring.append(std::string(2 * capacity, 'x'));
+    const int appendErrno = errno;
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &saved), 0);
+
+    EXPECT_EQ(n, -1);
+    EXPECT_EQ(readErrno, EMFILE);
+    EXPECT_EQ(empty.capacity(), 0u);
+    EXPECT_FALSE(appended);
+    EXPECT_EQ(appendErrno, EMFILE);
+    EXPECT_EQ(ring.capacity(), capacity);
+    EXPECT_EQ(ring.retrieveAllAsString(), "head");
+
+    // 限制解除后同一个缓冲区照常工作，socket 里的数据没有被取走
+    EXPECT_EQ(empty.readFd(fds[0], &savedErrno, scratch, sizeof(scratch)), 4);
+    EXPECT_EQ(empty.retrieveAllAsString(), "data");
+    close(fds[0]);
+    close(fds[1]);
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include "net/ChainBuffer.hpp"
+#include "net/SharedSlice.hpp"
+#include <arpa/inet.h>
+#include <chrono>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace net;
+
+// 测试复制只增加引用计数，子区间共享同一块内存
+TEST(SharedSliceTest, RefCountAndSlice)
+{
+    SharedSlice slice(std::string("hello world"));
+    EXPECT_EQ(slice.useCount(), 1);
+    {
+        SharedSlice copy = slice;
+        SharedSlice sub = slice.slice(6, 100);
+        EXPECT_EQ(slice.useCount(), 3);
+        EXPECT_EQ(copy.data(), slice.data());
+        EXPECT_EQ(std::string(sub.data(), sub.size()), "world");
+    }
+    EXPECT_EQ(slice.useCount(), 1);
+    EXPECT_TRUE(SharedSlice().empty());
+}
+
+// 测试发送缓冲区按引用排队，写完后释放引用，与普通数据保持顺序
+TEST(SharedSliceTest, ChainBufferHoldsReference)
+{
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    base::BlockPool pool;
+    SharedSlice packet(std::string(1400, 'p'));
+    const std::string expected = "head" + std::string(1400, 'p') + "tail";
+    {
+        ChainBuffer buffer(&pool);
+        buffer.append("head", 4);
+        buffer.append(packet);
+        buffer.append("tail", 4);
+        EXPECT_EQ(packet.useCount(), 2);
+        EXPECT_EQ(buffer.slabCount(), 3u);
+        EXPECT_EQ(pool.blocksInUse(), 2u);
+
+        int savedErrno = 0;
+        size_t offered = 0;
+        ASSERT_EQ(buffer.writeFd(fds[0], &savedErrno, static_cast<size_t>(-1), &offered), static_cast<ssize_t>(expected.size()));
+        EXPECT_EQ(offered, expected.size());
+        EXPECT_EQ(packet.useCount(), 1);
+        EXPECT_EQ(pool.blocksInUse(), 0u);
+    }
+
+    std::string received(expected.size(), '\0');
+    size_t got = 0;
+    while (got < received.size())
+    {
+        ssize_t n = read(fds[1], &received[got], received.size() - got);
+        ASSERT_GT(n, 0);
+        got += static_cast<size_t>(n);
+    }
+    EXPECT_EQ(received, expected);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+namespace
+{
+    // 回环上建立一对已连接的 TCP socket
+    void tcpPair(int *listenFd, int *sender, int *receiver)
+    {
+        *listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ASSERT_EQ(bind(*listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+        ASSERT_EQ(listen(*listenFd, 1), 0);
+        socklen_t addrLen = sizeof(addr);
+        getsockname(*listenFd, reinterpret_cast<sockaddr *>(&addr), &addrLen);
+        *sender = socket(AF_INET, SOCK_STREAM, 0);
+        ASSERT_EQ(connect(*sender, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+        *receiver = accept(*listenFd, nullptr, nullptr);
+        ASSERT_GE(*receiver, 0);
+    }
+}
+
+// 测试 MSG_ZEROCOPY：写出后引用保留到完成通知到达（回环上内核会退回拷贝，但通知照常）
+TEST(SharedSliceTest, ZeroCopyPinsUntilCompletion)
+{
+    int listenFd = -1;
+    int sender = -1;
+    int receiver = -1;
+    tcpPair(&listenFd, &sender, &receiver);
+    int on = 1;
+    if (setsockopt(sender, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) != 0)
+    {
+        GTEST_SKIP() << "SO_ZEROCOPY unsupported";
+    }
+
+    base::BlockPool pool;
+    SharedSlice frame(std::string(32 * 1024, 'k'));
+    ChainBuffer buffer(&pool);
+    buffer.setZeroCopyThreshold(16 * 1024);
+    buffer.append(frame);
+    int savedErrno = 0;
+    ASSERT_EQ(buffer.writeFd(sender, &savedErrno), static_cast<ssize_t>(frame.size()));
+    EXPECT_EQ(buffer.readableBytes(), 0u);
+    EXPECT_EQ(buffer.pinnedCount(), 1u);
+    EXPECT_EQ(frame.useCount(), 2);
+
+    std::string received(frame.size(), '\0');
+    size_t got = 0;
+    while (got < received.size())
+    {
+        ssize_t n = read(receiver, &received[got], received.size() - got);
+        ASSERT_GT(n, 0);
+        got += static_cast<size_t>(n);
+    }
+    EXPECT_EQ(received, std::string(frame.data(), frame.size()));
+
+    size_t sent = 0;
+    size_t copied = 0;
+    int errors = 0;
+    int lastErrno = 0;
+    for (int i = 0; i < 100 && buffer.pinnedCount() > 0; ++i)
+    {
+        buffer.reapZeroCopy(sender, &sent, &copied, &errors, &lastErrno);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(buffer.pinnedCount(), 0u);
+    EXPECT_EQ(frame.useCount(), 1);
+    EXPECT_EQ(sent, frame.size());
+    EXPECT_LE(copied, sent);
+    EXPECT_EQ(errors, 0);
+    close(receiver);
+    close(sender);
+    close(listenFd);
+}
+
+// 测试帧排在头部之后：普通段先用 writev 写出，帧到达队首后仍用 MSG_ZEROCOPY 发送
+TEST(SharedSliceTest, ZeroCopyFrameBehindHeader)
+{
+    int listenFd = -1;
+    int sender = -1;
+    int receiver = -1;
+    tcpPair(&listenFd, &sender, &receiver);
+    int on = 1;
+    if (setsockopt(sender, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) != 0)
+    {
+        GTEST_SKIP() << "SO_ZEROCOPY unsupported";
+    }
+
+    base::BlockPool pool;
+    SharedSlice frame(std::string(32 * 1024, 'f'));
+    ChainBuffer buffer(&pool);
+    buffer.setZeroCopyThreshold(16 * 1024);
+    buffer.append("$\0\x80\x00", 4); // 交织头
+    buffer.append(frame);
+    buffer.append("tail", 4);
+
+    struct iovec vec[8];
+    EXPECT_EQ(buffer.peekIovecs(vec, 8), 1); // 异步发送同样停在帧之前
+
+    int savedErrno = 0;
+    size_t offered = 0;
+    ASSERT_EQ(buffer.writeFd(sender, &savedErrno, static_cast<size_t>(-1), &offered), 4);
+    EXPECT_EQ(offered, 4u);
+    EXPECT_EQ(buffer.pinnedCount(), 0u);
+    ASSERT_EQ(buffer.writeFd(sender, &savedErrno), static_cast<ssize_t>(frame.size()));
+    EXPECT_EQ(buffer.pinnedCount(), 1u);
+    EXPECT_EQ(frame.useCount(), 2);
+    ASSERT_EQ(buffer.writeFd(sender, &savedErrno), 4);
+    EXPECT_EQ(buffer.readableBytes(), 0u);
+
+    const size_t total = 4 + frame.size() + 4;
+    std::string received(total, '\0');
+    size_t got = 0;
+    while (got < received.size())
+    {
+        ssize_t n = read(receiver, &received[got], received.size() - got);
+        ASSERT_GT(n, 0);
+        got += static_cast<size_t>(n);
+    }
+    EXPECT_EQ(received, std::string("$\0\x80\x00", 4) + std::string(frame.data(), frame.size()) + "tail");
+
+    size_t sent = 0;
+    size_t copied = 0;
+    int errors = 0;
+    int lastErrno = 0;
+    for (int i = 0; i < 100 && buffer.pinnedCount() > 0; ++i)
+    {
+        buffer.reapZeroCopy(sender, &sent, &copied, &errors, &lastErrno);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(buffer.pinnedCount(), 0u);
+    EXPECT_EQ(sent, frame.size());
+    EXPECT_EQ(errors, 0);
+    close(receiver);
+    close(sender);
+    close(listenFd);
+}
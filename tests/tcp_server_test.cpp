@@ -3,9 +3,14 @@
 #include "net/EventLoop.hpp"
 #include "net/InetAddress.hpp"
 #include "net/TcpConnection.hpp" // 添加这一行
+#include "net/SharedSlice.hpp"
+#include "net/RingBuffer.hpp"
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <vector>
+#include <mutex>
+#include <string>
 
 using namespace net;
 
@@ -85,4 +90,380 @@ TEST(TcpServerTest, MultiThreadMode)
     clientThread.join();
 
     EXPECT_EQ(msgCount, 1); // 验证消息被正确处理
-}
\ No newline at end of file
+}
+// 测试边沿触发模式：小预算下大块数据仍能完整回显
+TEST(TcpServerTest, EdgeTriggeredEcho)
+{
+    EventLoop loop;
+    InetAddress listenAddr(9880);
+    TcpServer server(&loop, listenAddr, "EdgeTriggeredServer");
+    server.setEdgeTriggered(true, 64 * 1024);
+    server.setMessageCallback([](const TcpConnectionPtr &conn, Buffer *buf, base::Timestamp)
+                              { conn->send(buf); });
+    server.start();
+
+    const size_t kTotal = 8 * 1024 * 1024;
+    std::atomic<size_t> received{0};
+    std::atomic<bool> mismatch{false};
+    std::thread clientThread([&]()
+                             {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(9880);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        connect(sockfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+
+        std::thread writer([sockfd, kTotal]() {
+            std::vector<char> chunk(256 * 1024);
+            size_t sent = 0;
+            while (sent < kTotal)
+            {
+                for (size_t i = 0; i < chunk.size(); ++i)
+                {
+                    chunk[i] = static_cast<char>((sent + i) % 251);
+                }
+                ssize_t n = send(sockfd, chunk.data(), std::min(chunk.size(), kTotal - sent), 0);
+                if (n <= 0)
+                {
+                    break;
+                }
+                sent += static_cast<size_t>(n);
+            }
+        });
+
+        std::vector<char> buf(256 * 1024);
+        while (received < kTotal)
+        {
+            ssize_t n = recv(sockfd, buf.data(), buf.size(), 0);
+            if (n <= 0)
+            {
+                break;
+            }
+            for (ssize_t i = 0; i < n; ++i)
+            {
+                if (buf[i] != static_cast<char>((received + i) % 251))
+                {
+                    mismatch = true;
+                }
+            }
+            received += static_cast<size_t>(n);
+        }
+        writer.join();
+        close(sockfd); });
+
+    loop.runEvery(0.05, [&]()
+                  {
+                      if (received >= kTotal || mismatch)
+                      {
+                          loop.quit();
+                      } });
+    loop.runAfter(10.0, [&]()
+                  { loop.quit(); });
+    loop.loop();
+    clientThread.join();
+
+    EXPECT_FALSE(mismatch);
+    EXPECT_EQ(received.load(), kTotal);
+}
+
+// 测试每个 IO loop 各自监听：连接在接受它的 loop 上建立、回显和销毁，不经过 baseLoop
+TEST(TcpServerTest, AcceptorPerLoop)
+{
+    for (int steer = 0; steer < 2; ++steer)
+    {
+        const uint16_t port = static_cast<uint16_t>(9881 + steer);
+        EventLoop loop;
+        InetAddress listenAddr(port);
+        TcpServer server(&loop, listenAddr, "ReusePortServer", true);
+        server.setThreadNum(3, steer ? ThreadPlacement::compact() : ThreadPlacement());
+        server.setAcceptorPerLoop(true, steer == 1);
+
+        const int kClients = 6;
+        std::atomic<int> up{0};
+        std::atomic<int> down{0};
+        std::atomic<bool> wrongThread{false};
+        server.setConnectionCallback([&](const TcpConnectionPtr &conn)
+                                     {
+            if (!conn->getLoop()->isInLoopThread() || conn->getLoop() == &loop)
+            {
+                wrongThread = true;
+            }
+            (conn->connected() ? up : down)++; });
+        server.setMessageCallback([](const TcpConnectionPtr &conn, Buffer *buf, base::Timestamp)
+                                  { conn->send(buf); });
+        server.start();
+
+        std::atomic<int> echoed{0};
+        std::thread clientThread([&]()
+                                 {
+            for (int i = 0; i < kClients; ++i)
+            {
+                int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+                sockaddr_in addr;
+                memset(&addr, 0, sizeof(addr));
+                addr.sin_family = AF_INET;
+                addr.sin_port = htons(port);
+                inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+                connect(sockfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+                char buf[4] = {'p', 'i', 'n', 'g'};
+                send(sockfd, buf, sizeof(buf), 0);
+                if (recv(sockfd, buf, sizeof(buf), MSG_WAITALL) == sizeof(buf))
+                {
+                    echoed++;
+                }
+                close(sockfd);
+            } });
+
+        loop.runEvery(0.02, [&]()
+                      {
+                          if (down.load() == kClients)
+                          {
+                              loop.quit();
+                          } });
+        loop.runAfter(5.0, [&]()
+                      { loop.quit(); });
+        loop.loop();
+        clientThread.join();
+
+        EXPECT_EQ(echoed.load(), kClients);
+        EXPECT_EQ(up.load(), kClients);
+        EXPECT_EQ(down.load(), kClients);
+        EXPECT_FALSE(wrongThread);
+    }
+}
+
+// 测试跨线程移交所有权的发送：string、Buffer、SharedSlice 按调用顺序到达，Buffer 交出后为空
+TEST(TcpServerTest, CrossThreadMoveSend)
+{
+    EventLoop loop;
+    InetAddress listenAddr(9883);
+    TcpServer server(&loop, listenAddr, "MoveSendServer");
+    std::mutex mutex;
+    TcpConnectionPtr accepted;
+    server.setConnectionCallback([&](const TcpConnectionPtr &conn)
+                                 {
+        if (conn->connected())
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            accepted = conn;
+        }
+        else
+        {
+            loop.quit();
+        } });
+    server.start();
+
+    std::string received;
+    bool bufferEmptied = false;
+    std::thread clientThread([&]()
+                             {
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(9883);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        connect(sockfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        TcpConnectionPtr conn;
+        while (!conn)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            std::lock_guard<std::mutex> lock(mutex);
+            conn = accepted;
+        }
+        conn->send(std::string(3000, 's'));
+        Buffer buffer;
+        buffer.append(std::string(70000, 'b'));
+        conn->send(std::move(buffer));
+        bufferEmptied = buffer.readableBytes() == 0;
+        conn->send(SharedSlice(std::string(100, 'x')));
+        conn->shutdown();
+        conn.reset();
+
+        char buf[4096];
+        ssize_t n;
+        while ((n = recv(sockfd, buf, sizeof(buf), 0)) > 0)
+        {
+            received.append(buf, static_cast<size_t>(n));
+        }
+        close(sockfd); });
+
+    loop.runAfter(5.0, [&]()
+                  { loop.quit(); });
+    loop.loop();
+    clientThread.join();
+    accepted.reset();
+
+    EXPECT_TRUE(bufferEmptied);
+    EXPECT_EQ(received, std::string(3000, 's') + std::string(70000, 'b') + std::string(100, 'x'));
+}
+
+// 测试连接切换到 RingBuffer 输入后，数据交给 ring 回调，按帧取出后回显
+TEST(TcpServerTest, RingInput)
+{
+    EventLoop loop;
+    InetAddress listenAddr(9884);
+    TcpServer server(&loop, listenAddr, "RingServer");
+    std::atomic<bool> plainCalled{false};
+    server.setMessageCallback([&](const TcpConnectionPtr &, Buffer *, base::Timestamp)
+                              { plainCalled = true; });
+    server.setConnectionCallback([&](const TcpConnectionPtr &conn)
+                                 {
+        if (conn->connected())
+        {
+            conn->setRingInput([](const TcpConnectionPtr &c, RingBuffer *ring, base::Timestamp)
+                               {
+                // 只取完整的 8 字节帧，剩下的留在环里
+                const size_t frames = ring->readableBytes() / 8 * 8;
+                c->send(ring->peek(), frames);
+                ring->retrieve(frames); }, 4096);
+        }
+        else
+        {
+            loop.quit();
+        } });
+    server.start();
+
+    std::string sent;
+    for (int i = 0; i < 2000; ++i)
+    {
+        sent += "frame" + std::to_string(100 + i % 900);
+    }
+    std::string received;
+    std::thread clientThread([&]()
+                             {
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(9884);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        connect(sockfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        // 分成不对齐帧边界的小块发送
+        for (size_t offset = 0; offset < sent.size(); offset += 1001)
+        {
+            send(sockfd, sent.data() + offset, std::min<size_t>(1001, sent.size() - offset), 0);
+        }
+        char buf[4096];
+        while (received.size() < sent.size())
+        {
+            ssize_t n = recv(sockfd, buf, sizeof(buf), 0);
+            if (n <= 0)
+            {
+                break;
+            }
+            received.append(buf, static_cast<size_t>(n));
+        }
+        close(sockfd); });
+
+    loop.runAfter(5.0, [&]()
+                  { loop.quit(); });
+    loop.loop();
+    clientThread.join();
+
+    EXPECT_FALSE(plainCalled);
+    EXPECT_EQ(received, sent);
+}
+
+// 测试批量写：同一轮的多次 send 合并到本轮结束时发出，带 MSG_MORE 留下的尾部由 flush() 推出，
+// 关闭写端前先写完未发出的数据
+TEST(TcpServerTest, WriteBatching)
+{
+    EventLoop loop;
+    InetAddress listenAddr(9886);
+    TcpServer server(&loop, listenAddr, "BatchServer");
+    std::string expected;
+    for (int i = 0; i < 50; ++i)
+    {
+        expected += "packet" + std::to_string(1000 + i);
+    }
+    server.setConnectionCallback([&](const TcpConnectionPtr &conn)
+                                 {
+        if (conn->connected())
+        {
+            conn->setWriteBatching(true, true);
+            for (int i = 0; i < 50; ++i)
+            {
+                conn->send("packet" + std::to_string(1000 + i));
+            }
+            loop.runAfter(0.05, [conn]()
+                          {
+                conn->send(std::string("reply"));
+                conn->flush();
+                conn->send(std::string("bye"));
+                conn->shutdown(); });
+        }
+        else
+        {
+            loop.quit();
+        } });
+    server.start();
+
+    std::string received;
+    std::thread clientThread([&]()
+                             {
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(9886);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        connect(sockfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        char buf[4096];
+        ssize_t n;
+        while ((n = recv(sockfd, buf, sizeof(buf), 0)) > 0)
+        {
+            received.append(buf, static_cast<size_t>(n));
+        }
+        close(sockfd); });
+
+    loop.runAfter(5.0, [&]()
+                  { loop.quit(); });
+    loop.loop();
+    clientThread.join();
+
+    EXPECT_EQ(received, expected + "replybye");
+}
+
+// IO loop 先于服务器退出：析构不能等待已停止的 loop，连接仍在该线程退出前销毁
+TEST(TcpServerTest, DestroyAfterIoLoopQuit)
+{
+    EventLoop loop;
+    std::atomic<int> connected{0};
+    std::atomic<int> disconnected{0};
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    {
+        TcpServer server(&loop, InetAddress(9887), "QuitServer");
+        server.setThreadNum(2);
+        server.setConnectionCallback([&](const TcpConnectionPtr &conn)
+                                     {
+            if (conn->connected())
+            {
+                connected++;
+                conn->getLoop()->quit(); // 连接还开着，所属 IO loop 就退出了
+            }
+            else
+            {
+                disconnected++;
+            } });
+        server.start();
+
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(9887);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        connect(sockfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+
+        loop.runAfter(0.3, [&]()
+                      { loop.quit(); });
+        loop.loop();
+    }
+    close(sockfd);
+
+    EXPECT_EQ(connected, 1);
+    EXPECT_EQ(disconnected, 1);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "base/TimingWheel.hpp"
+#include "net/EventLoop.hpp"
+#include <atomic>
+#include <vector>
+
+// 使用虚拟时间驱动时间轮，避免测试依赖真实时钟
+namespace
+{
+    base::Timestamp at(const base::Timestamp &origin, int64_t ms)
+    {
+        return base::Timestamp(origin.microSecondsSinceEpoch() + ms * 1000);
+    }
+}
+
+// 测试到期顺序与跨层级联
+TEST(TimingWheelTest, ExpireAcrossLevels)
+{
+    base::Timestamp origin(1000000);
+    base::TimingWheel wheel(0.001, origin);
+    std::vector<int> fired;
+
+    const int delays[] = {1, 255, 256, 300, 70000, 20000000};
+    for (int delay : delays)
+    {
+        wheel.addTimer([&fired, delay]()
+                       { fired.push_back(delay); }, at(origin, delay), 0);
+    }
+    EXPECT_EQ(wheel.size(), 6u);
+
+    for (size_t i = 0; i < sizeof(delays) / sizeof(delays[0]); ++i)
+    {
+        // 下界不能晚于真实到期时间
+        EXPECT_LE(wheel.nextExpiration().microSecondsSinceEpoch(), at(origin, delays[i]).microSecondsSinceEpoch());
+        wheel.handleExpiredTimers(at(origin, delays[i] - 1));
+        EXPECT_EQ(fired.size(), i);
+        wheel.handleExpiredTimers(at(origin, delays[i]));
+        ASSERT_EQ(fired.size(), i + 1);
+        EXPECT_EQ(fired.back(), delays[i]);
+    }
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_FALSE(wheel.nextExpiration().valid());
+}
+
+// 测试取消、重设与重复定时器
+TEST(TimingWheelTest, CancelResetAndRepeat)
+{
+    base::Timestamp origin(1000000);
+    base::TimingWheel wheel(0.001, origin);
+    int once = 0;
+    int repeat = 0;
+    int idle = 0;
+
+    base::TimerId cancelled = wheel.addTimer([&once]()
+                                             { once++; }, at(origin, 10), 0);
+    base::TimerId idleTimer = wheel.addTimer([&idle]()
+                                             { idle++; }, at(origin, 50), 0);
+    base::TimerId repeatTimer = wheel.addTimer([&repeat]()
+                                               { repeat++; }, at(origin, 5), 0.005);
+    wheel.cancel(cancelled);
+
+    for (int ms = 1; ms <= 100; ++ms)
+    {
+        if (ms % 20 == 0)
+        {
+            EXPECT_TRUE(wheel.reset(idleTimer, at(origin, ms + 50))); // 模拟保活刷新
+        }
+        wheel.handleExpiredTimers(at(origin, ms));
+    }
+    EXPECT_EQ(once, 0);
+    EXPECT_EQ(idle, 0);
+    EXPECT_EQ(repeat, 20);
+
+    wheel.cancel(repeatTimer);
+    wheel.handleExpiredTimers(at(origin, 150));
+    EXPECT_EQ(idle, 1);
+    EXPECT_FALSE(wheel.reset(idleTimer, at(origin, 200)));
+    EXPECT_TRUE(wheel.empty());
+}
+
+// 测试 EventLoop 使用时间轮作为定时器后端
+TEST(TimingWheelTest, EventLoopBackend)
+{
+    net::EventLoop loop;
+    loop.useTimingWheel(0.001);
+    std::atomic<int> count(0);
+    base::TimerId idle = loop.runAfter(0.02, [&count]()
+                                       { count += 100; });
+    loop.runEvery(0.005, [&count]()
+                  { count++; });
+    loop.runAfter(0.01, [&]()
+                  { loop.resetTimer(idle, 1.0); });
+    loop.runAfter(0.05, [&loop]()
+                  { loop.quit(); });
+    loop.loop();
+    EXPECT_GE(count.load(), 5);
+    EXPECT_LT(count.load(), 100);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "base/Queue.hpp"
+#include "base/WorkStealingPool.hpp"
+#include "net/EventLoop.hpp"
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    long fib(base::WorkStealingPool &pool, int n)
+    {
+        if (n < 16)
+        {
+            return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+        }
+        std::atomic<bool> done(false);
+        long left = 0;
+        pool.submit([&pool, &done, &left, n]()
+                    {
+                        left = fib(pool, n - 1);
+                        done.store(true, std::memory_order_release); });
+        long right = fib(pool, n - 2);
+        while (!done.load(std::memory_order_acquire))
+        {
+            if (!pool.tryRunOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+        return left + right;
+    }
+}
+
+// 测试所有者 LIFO、窃取者 FIFO 以及扩容
+TEST(ChaseLevDequeTest, OwnerAndThief)
+{
+    base::ChaseLevDeque<int> deque(2);
+    int value = 0;
+    EXPECT_FALSE(deque.pop(value));
+    EXPECT_FALSE(deque.steal(value));
+    for (int i = 0; i < 10; ++i)
+    {
+        deque.push(i);
+    }
+    EXPECT_EQ(deque.size(), 10u);
+    ASSERT_TRUE(deque.steal(value));
+    EXPECT_EQ(value, 0);
+    ASSERT_TRUE(deque.pop(value));
+    EXPECT_EQ(value, 9);
+    EXPECT_EQ(deque.size(), 8u);
+}
+
+// 测试所有者与多个窃取者并发时每个元素恰好被取出一次
+TEST(ChaseLevDequeTest, ConcurrentSteal)
+{
+    const int kItems = 200000;
+    const int kThieves = 3;
+    base::ChaseLevDeque<int> deque(16);
+    std::vector<std::atomic<int>> seen(kItems);
+    std::atomic<int> taken(0);
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < kThieves; ++t)
+    {
+        thieves.emplace_back([&]()
+                             {
+            int value;
+            while (taken.load() < kItems)
+            {
+                if (deque.steal(value))
+                {
+                    seen[value]++;
+                    taken++;
+                }
+            } });
+    }
+    int value;
+    for (int i = 0; i < kItems; ++i)
+    {
+        deque.push(i);
+        if (i % 3 == 0 && deque.pop(value))
+        {
+            seen[value]++;
+            taken++;
+        }
+    }
+    while (taken.load() < kItems)
+    {
+        if (deque.pop(value))
+        {
+            seen[value]++;
+            taken++;
+        }
+    }
+    for (auto &thief : thieves)
+    {
+        thief.join();
+    }
+    for (int i = 0; i < kItems; ++i)
+    {
+        ASSERT_EQ(seen[i].load(), 1) << i;
+    }
+}
+
+// 测试外部提交与工作线程内 fork/join
+TEST(WorkStealingPoolTest, SubmitAndForkJoin)
+{
+    base::WorkStealingPool pool(3);
+    EXPECT_EQ(pool.numThreads(), 3);
+    EXPECT_EQ(pool.currentWorker(), -1);
+
+    std::atomic<int> count(0);
+    for (int i = 0; i < 1000; ++i)
+    {
+        pool.submit([&count]()
+                    { count++; });
+    }
+    while (count.load() < 1000)
+    {
+        std::this_thread::yield();
+    }
+
+    std::promise<long> result;
+    pool.submit([&pool, &result]()
+                { result.set_value(fib(pool, 24)); });
+    EXPECT_EQ(result.get_future().get(), 46368);
+}
+
+// 测试 runOffLoop 在计算线程执行任务、在 loop 线程执行回调
+TEST(WorkStealingPoolTest, RunOffLoop)
+{
+    base::WorkStealingPool pool(2);
+    net::EventLoop loop;
+    loop.setComputePool(&pool);
+    std::thread::id taskThread;
+    bool continuationInLoop = false;
+    loop.runAfter(0.0, [&]()
+                  { loop.runOffLoop([&]()
+                                    { taskThread = std::this_thread::get_id(); },
+                                    [&]()
+                                    {
+                                        continuationInLoop = loop.isInLoopThread();
+                                        loop.quit(); }); });
+    loop.loop();
+    EXPECT_NE(taskThread, std::this_thread::get_id());
+    EXPECT_TRUE(continuationInLoop);
+}